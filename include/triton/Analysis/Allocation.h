@@ -12,17 +12,29 @@
 #include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
 #include <atomic>
 #include <limits>
+#include <optional>
 
 namespace mlir {
 
 namespace triton {
 class AllocationAnalysis;
 
+/// Returns the padded shape of the scratch buffer of a convert_layout and the
+/// vector widths of its stores and loads. The config recorded on the op by
+/// recordScratchConfigForCvtLayout is returned if there is one, so that the
+/// allocation and the lowerings agree.
 SmallVector<unsigned>
 getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
                              unsigned &outVec);
 SmallVector<unsigned> getRepShapeForCvtLayout(triton::gpu::ConvertLayoutOp op);
 
+/// Searches for the padding and vector widths of a convert_layout that goes
+/// through a scratch buffer, and records them on the op. The bank conflict
+/// degree of the chosen accesses, i.e. the largest number of wavefronts a
+/// single wavefront of its stores or loads is serialized into, is recorded as
+/// the allocation.bank_conflicts attribute if the accesses are modeled.
+void recordScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op);
+
 } // namespace triton
 
 /// Modified from llvm-15.0: llvm/ADT/AddressRanges.h
@@ -54,6 +66,26 @@ private:
 
 template <class T> Interval(T, T) -> Interval<T>;
 
+/// Algorithms that compute the offsets of the shared memory buffers.
+enum class AllocationPolicy {
+  /// Offset bumping followed by first-fit graph coloring (default).
+  Bumping,
+  /// Best-fit placement of each buffer in the gaps left by the buffers live
+  /// at the same time, trying several placement orders. The smallest of these
+  /// and the bumping allocation is kept, trading compile time for a size
+  /// closer to the live size lower bound.
+  BestFit,
+};
+
+/// Returns the policy named `name` ("bumping" or "best-fit").
+std::optional<AllocationPolicy> parseAllocationPolicy(StringRef name);
+
+/// Returns the policy selected by the "triton_gpu.shared-allocator" module
+/// attribute, Bumping if there is none. The allocate-shared-memory pass sets
+/// the attribute so that analyses recomputing the allocation later (e.g.
+/// membar) see the same offsets.
+AllocationPolicy getAllocationPolicy(ModuleOp moduleOp);
+
 class Allocation {
 public:
   /// A unique identifier for shared memory buffers
@@ -67,7 +99,9 @@ public:
   Allocation() = default;
   /// Creates a new Allocation analysis that computes the shared memory
   /// information for all associated shared memory values.
-  explicit Allocation(Operation *operation) : operation(operation) {}
+  explicit Allocation(Operation *operation,
+                      AllocationPolicy policy = AllocationPolicy::Bumping)
+      : operation(operation), policy(policy) {}
 
   /// Runs allocation analysis on the given top-level operation.
   void run(FuncAllocMapT &funcAllocMap);
@@ -135,6 +169,11 @@ public:
   /// Returns the size of total shared memory allocated
   size_t getSharedMemorySize() const { return sharedMemorySize; }
 
+  /// Returns the largest total size of the buffers live at the same time, a
+  /// lower bound of the shared memory size. The difference between the two is
+  /// lost to fragmentation and alignment.
+  size_t getLiveSizeLowerBound() const { return liveSizeLowerBound; }
+
 private:
   /// A class that represents a shared memory buffer
   struct BufferT {
@@ -195,12 +234,14 @@ private:
 
 private:
   Operation *operation = nullptr;
+  AllocationPolicy policy = AllocationPolicy::Bumping;
   OpScratchMapT opScratch;
   OpScratchMapT opVirtual;
   ValueBufferMapT valueBuffer;
   AliasBufferMapT aliasBuffer;
   BufferSetT bufferSet;
   size_t sharedMemorySize = 0;
+  size_t liveSizeLowerBound = 0;
 
   friend class triton::AllocationAnalysis;
 };
@@ -216,13 +257,16 @@ public:
   using FuncOffsetMapT = DenseMap<FunctionOpInterface, Value>;
 
   explicit ModuleAllocation(ModuleOp moduleOp)
+      : ModuleAllocation(moduleOp, getAllocationPolicy(moduleOp)) {}
+
+  ModuleAllocation(ModuleOp moduleOp, AllocationPolicy policy)
       : CallGraph<Allocation>(moduleOp) {
     walk<WalkOrder::PreOrder, WalkOrder::PostOrder>(
         // Pre-order edge walk callback
         [](CallOpInterface callOp, FunctionOpInterface funcOp) {},
         // Post-order node walk callback
         [&](FunctionOpInterface funcOp) {
-          auto [iter, inserted] = funcMap.try_emplace(funcOp, funcOp);
+          auto [iter, inserted] = funcMap.try_emplace(funcOp, funcOp, policy);
           if (inserted)
             iter->second.run(funcMap);
         });
@@ -4,6 +4,7 @@
 #include "mlir/Analysis/DataFlow/SparseAnalysis.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include "mlir/Pass/AnalysisManager.h"
 #include "mlir/Support/LLVM.h"
 #include "triton/Analysis/Utility.h"
 #include "triton/Dialect/Triton/IR/Dialect.h"
@@ -205,6 +206,14 @@ public:
   unsigned getPtrAlignment(Value ptr);
   unsigned getMaskAlignment(Value mask);
 
+  // Returns the analysis of the module managed by `am`, which is only computed
+  // if no previous pass computed it and preserved it since, or the pass
+  // itself invalidated it.
+  //
+  // Passes that do not create, erase or replace values should mark this
+  // analysis as preserved.
+  static ModuleAxisInfoAnalysis &get(AnalysisManager am);
+
 private:
   void initialize(FunctionOpInterface funcOp);
   void update(CallOpInterface callOp, FunctionOpInterface funcOp);
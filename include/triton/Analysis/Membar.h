@@ -4,15 +4,108 @@
 #include "Allocation.h"
 #include "llvm/ADT/SmallPtrSet.h"
 
+#include <map>
 #include <set>
 
 namespace mlir {
 
 class OpBuilder;
 
+/// A set of intervals that answers whether any of its intervals intersects a
+/// given interval in logarithmic time.
+/// Besides the intervals themselves, the set keeps the union of its non-empty
+/// intervals as disjoint ranges, merging intervals that overlap but not those
+/// that merely touch, and its empty intervals as points. That is all
+/// Interval::intersects depends on, so queries give the same answers as
+/// checking every interval of the set.
+template <typename T> class IntervalSet {
+public:
+  using const_iterator = typename std::set<Interval<T>>::const_iterator;
+
+  /// Inserts an interval, returns false if it was already in the set.
+  bool insert(const Interval<T> &interval) {
+    if (!intervals.insert(interval).second)
+      return false;
+    T start = interval.start();
+    T end = interval.end();
+    if (start == end) {
+      points.insert(start);
+      return true;
+    }
+    // Merge the ranges overlapping [start, end)
+    auto it = ranges.upper_bound(start);
+    if (it != ranges.begin() && std::prev(it)->second > start)
+      --it;
+    while (it != ranges.end() && it->first < end) {
+      start = std::min(start, it->first);
+      end = std::max(end, it->second);
+      it = ranges.erase(it);
+    }
+    ranges.emplace(start, end);
+    return true;
+  }
+
+  template <typename InputIt> void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  /// Returns true if any interval of the set intersects the given interval.
+  bool intersects(const Interval<T> &interval) const {
+    T start = interval.start();
+    T end = interval.end();
+    if (start == end) {
+      // An empty interval only intersects the intervals strictly around it
+      auto it = ranges.lower_bound(start);
+      return it != ranges.begin() && std::prev(it)->second > start;
+    }
+    auto it = ranges.upper_bound(start);
+    if (it != ranges.begin() && std::prev(it)->second > start)
+      return true;
+    if (it != ranges.end() && it->first < end)
+      return true;
+    auto point = points.upper_bound(start);
+    return point != points.end() && *point < end;
+  }
+
+  /// Returns true if any interval of the set intersects any interval of the
+  /// other set.
+  bool intersects(const IntervalSet &other) const {
+    if (size() > other.size())
+      return other.intersects(*this);
+    for (auto &interval : intervals)
+      if (other.intersects(interval))
+        return true;
+    return false;
+  }
+
+  void clear() {
+    intervals.clear();
+    ranges.clear();
+    points.clear();
+  }
+
+  size_t size() const { return intervals.size(); }
+  bool empty() const { return intervals.empty(); }
+  const_iterator begin() const { return intervals.begin(); }
+  const_iterator end() const { return intervals.end(); }
+
+  bool operator==(const IntervalSet &other) const {
+    return intervals == other.intervals;
+  }
+  bool operator!=(const IntervalSet &other) const { return !(*this == other); }
+
+private:
+  std::set<Interval<T>> intervals;
+  /// Start -> end of the disjoint ranges covered by non-empty intervals
+  std::map<T, T> ranges;
+  /// Positions of the empty intervals
+  std::set<T> points;
+};
+
 struct BlockInfo {
   using BufferIdSetT = Allocation::BufferIdSetT;
-  using IntervalSetT = std::set<Interval<size_t>>;
+  using IntervalSetT = IntervalSet<size_t>;
 
   IntervalSetT syncReadIntervals;
   IntervalSetT syncWriteIntervals;
@@ -54,11 +147,7 @@ struct BlockInfo {
 private:
   bool isIntersected(const IntervalSetT &lhsIntervalSet,
                      const IntervalSetT &rhsIntervalSet) const {
-    for (auto &lhs : lhsIntervalSet)
-      for (auto &rhs : rhsIntervalSet)
-        if (lhs.intersects(rhs))
-          return true;
-    return false;
+    return lhsIntervalSet.intersects(rhsIntervalSet);
   }
 };
 
@@ -0,0 +1,166 @@
+#ifndef TRITON_ANALYSIS_RANGEINFO_H
+#define TRITON_ANALYSIS_RANGEINFO_H
+
+#include "mlir/Analysis/DataFlow/SparseAnalysis.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "mlir/Support/LLVM.h"
+#include "triton/Analysis/AxisInfo.h"
+#include "triton/Analysis/Utility.h"
+
+#include <optional>
+
+namespace mlir::triton {
+
+//===----------------------------------------------------------------------===//
+// RangeInfo
+//===----------------------------------------------------------------------===//
+
+/// This lattice value represents known bounds on the elements of an integer
+/// value.
+///
+/// Besides the constant bounds [min, max], the elements may be bounded by a
+/// scalar integer value of the same function plus a constant offset, e.g. the
+/// induction variable of `scf.for %iv = %lb to %ub step %c16` is at most
+/// `%ub - 1`, or `%ub - 16` if %lb and %ub are known to be divisible by 16.
+/// All the bounds are on the mathematical (signed) integers, values that may
+/// wrap around are given the range of their type and no symbolic bounds.
+class RangeInfo {
+public:
+  /// The bound `base + offset` where `base` is a scalar integer value.
+  struct SymbolicBound {
+    Value base;
+    int64_t offset;
+
+    bool operator==(const SymbolicBound &other) const {
+      return base == other.base && offset == other.offset;
+    }
+
+    bool operator!=(const SymbolicBound &other) const {
+      return !(*this == other);
+    }
+  };
+
+public:
+  RangeInfo() = default;
+
+  RangeInfo(unsigned bitWidth, int64_t min, int64_t max,
+            std::optional<SymbolicBound> lower = std::nullopt,
+            std::optional<SymbolicBound> upper = std::nullopt)
+      : bitWidth(bitWidth), min(min), max(max), lower(lower), upper(upper) {
+    assert(bitWidth > 0 && bitWidth <= 64);
+    assert(min <= max);
+  }
+
+  // A range info with a bit width of zero is uninitialized, which is also the
+  // state of values that are not integers.
+  bool isUninitialized() const { return bitWidth == 0; }
+
+  unsigned getBitWidth() const { return bitWidth; }
+  int64_t getMin() const { return min; }
+  int64_t getMax() const { return max; }
+
+  // The symbolic lower and upper bounds of the elements if known.
+  std::optional<SymbolicBound> getLower() const { return lower; }
+  std::optional<SymbolicBound> getUpper() const { return upper; }
+
+  std::optional<int64_t> getConstantValue() const {
+    if (isUninitialized() || min != max)
+      return std::nullopt;
+    return min;
+  }
+
+  // Bounds of the (signed) integers of the given bit width. Booleans are in
+  // [0, 1].
+  static int64_t getTypeMin(unsigned bitWidth);
+  static int64_t getTypeMax(unsigned bitWidth);
+
+  // The range of all the integers of the given bit width.
+  static RangeInfo getMaxRange(unsigned bitWidth) {
+    return RangeInfo(bitWidth, getTypeMin(bitWidth), getTypeMax(bitWidth));
+  }
+
+  // The bit width of the elements of `type`, or zero if they are not integers.
+  static unsigned getBitWidth(Type type);
+
+  bool operator==(const RangeInfo &other) const {
+    return bitWidth == other.bitWidth && min == other.min &&
+           max == other.max && lower == other.lower && upper == other.upper;
+  }
+
+  static RangeInfo getPessimisticValueState(Value value);
+
+  // The union of both arguments, where `lhs` is the current state.
+  //
+  // Loop carried values would grow their ranges one iteration at a time, so
+  // any bound that `rhs` loosens is widened to the bound of the type, and
+  // symbolic bounds that differ are dropped.
+  static RangeInfo join(const RangeInfo &lhs, const RangeInfo &rhs);
+
+  void print(raw_ostream &os) const {
+    if (isUninitialized()) {
+      os << "<uninitialized>";
+      return;
+    }
+    auto print = [&](StringRef name, std::optional<SymbolicBound> bound) {
+      os << name << " = ";
+      if (!bound) {
+        os << "<none>";
+        return;
+      }
+      bound->base.printAsOperand(os, OpPrintingFlags());
+      if (bound->offset != 0)
+        os << (bound->offset > 0 ? " + " : " - ") << std::abs(bound->offset);
+    };
+    os << "range = [" << min << ", " << max << "]";
+    print(", lower", lower);
+    print(", upper", upper);
+  }
+
+private:
+  unsigned bitWidth = 0;
+  int64_t min = 0;
+  int64_t max = 0;
+  std::optional<SymbolicBound> lower;
+  std::optional<SymbolicBound> upper;
+};
+
+// Module level range analysis.
+//
+// Symbolic bounds only relate values of the same function, so unlike the axis
+// info the ranges are not merged across call sites: the arguments of all the
+// functions are unknown. Triton kernels are inlined before the passes that use
+// this analysis run.
+using RangeInfoMapT = DenseMap<Value, RangeInfo>;
+class ModuleRangeInfoAnalysis : public CallGraph<RangeInfoMapT> {
+public:
+  // The axis info analysis provides the divisibility of loop bounds.
+  ModuleRangeInfoAnalysis(ModuleOp moduleOp,
+                          ModuleAxisInfoAnalysis &axisInfoAnalysis);
+
+  RangeInfo *getRangeInfo(Value value) {
+    auto funcOp =
+        value.getParentRegion()->getParentOfType<FunctionOpInterface>();
+    auto *rangeInfoMap = getFuncData(funcOp);
+    if (!rangeInfoMap) {
+      return nullptr;
+    }
+    auto it = rangeInfoMap->find(value);
+    if (it == rangeInfoMap->end() || it->second.isUninitialized()) {
+      return nullptr;
+    }
+    return &(it->second);
+  }
+
+  // Returns the value of all the elements of the boolean `value` if they are
+  // known to be the same.
+  std::optional<bool> getConstantCondition(Value value);
+
+private:
+  void initialize(FunctionOpInterface funcOp,
+                  ModuleAxisInfoAnalysis &axisInfoAnalysis);
+};
+
+} // namespace mlir::triton
+
+#endif
@@ -52,6 +52,11 @@ public:
 
   bool isWarpSynchronous();
 
+  // Return true if each thread can combine the partial reductions of the warps
+  // for its result elements in registers, which saves the second barrier of
+  // the reduction across warps.
+  bool isInterWarpReduceInRegisters();
+
   unsigned getInterWarpSize();
 
   unsigned getIntraWarpSize();
@@ -101,6 +106,21 @@ public:
   }
   // Return true if the lowering of the scan op is supported.
   bool isSupported();
+  // Return true if a scan along `axis` of a tensor with the given shape and
+  // encoding can be lowered. Blocked encodings are lowered from their fields,
+  // other encodings from their linear layout, which must keep the axis
+  // separate from the other dims and order the lanes before the warps along
+  // the axis.
+  static bool isSupportedLayout(ArrayRef<int64_t> shape, Attribute encoding,
+                                unsigned axis);
+  // Return true if the encoding is lowered from its linear layout.
+  bool isLinearLayoutLowering();
+  // Return log2 of the number of contiguous elements along axis dim that are
+  // scanned within a warp by the linear layout lowering.
+  unsigned getAxisTileSizeLog2();
+  // Return the number of tiles of contiguous elements along axis dim that the
+  // linear layout lowering combines through shared memory.
+  unsigned getAxisNumTiles();
   // Return the number of elements per thread along axis dim.
   unsigned getAxisNumElementsPerThread();
   // Return the number of elements per thread along non-axis dims.
@@ -151,6 +171,51 @@ private:
   SmallVector<Type> srcElementTypes;
 };
 
+class SortOpHelper {
+public:
+  explicit SortOpHelper(triton::SortOp op) : sortOp(op) {}
+  // Return true if the lowering of the sort op is supported.
+  bool isSupported();
+  // Return true if a sort along `axis` of a tensor with the given shape and
+  // encoding can be lowered. Each bit of the position along the axis must be
+  // owned by a single register, lane or warp bit of the linear layout.
+  static bool isSupportedLayout(ArrayRef<int64_t> shape, Attribute encoding,
+                                unsigned axis);
+  // Return true if some compare-exchanges are between elements owned by
+  // different warps, which exchange them through shared memory.
+  bool hasWarpExchanges();
+  // Return true if only the first k elements along axis dim are returned,
+  // which are gathered into the layout of the result through shared memory.
+  bool isTopK();
+  // Return the number of elements of the scratch space needed for each
+  // operand, which holds the whole tensor.
+  unsigned getScratchSizeInElems();
+  // Return the size of the scratch space needed for sort lowering.
+  unsigned getScratchSizeInBytes();
+
+private:
+  triton::SortOp sortOp;
+};
+
+class HistogramOpHelper {
+public:
+  explicit HistogramOpHelper(triton::HistogramOp op) : histogramOp(op) {}
+  // Return the number of bins, padded to at least one bin per lane.
+  unsigned getNumBins();
+  // Return true if the elements are counted with atomics on shared memory
+  // counters rather than with warp ballots, whose cost grows with the number
+  // of bins.
+  bool isSharedMemoryLowering();
+  // Return the number of privatized copies of the counters in shared memory:
+  // one per warp if they fit, otherwise a single one for the CTA.
+  unsigned getNumCopies();
+  // Return the size of the scratch space needed for histogram lowering.
+  unsigned getScratchSizeInBytes();
+
+private:
+  triton::HistogramOp histogramOp;
+};
+
 // Decomposes a reshape into simpler pieces.
 //
 // As an example, suppose we have a reshape from [4,4,4] to [2,2,8,2].
@@ -188,8 +253,41 @@ bool supportMMA(Value value, int version);
 
 bool isSingleValue(Value value);
 
+// Returns true if the conversion from srcTy to dstTy only moves data between
+// the registers of each thread.
+bool cvtReordersRegisters(RankedTensorType srcTy, RankedTensorType dstTy);
+
 bool cvtNeedsSharedMemory(RankedTensorType srcTy, RankedTensorType dstTy);
 
+// Describes how a layout conversion whose data stays within a warp is lowered
+// to warp shuffles.
+//
+// The conversion takes one round per destination register r.  In round r, lane
+// l reads destination register `r ^ laneToDstRegister(l)` from lane
+// `roundToSrcLane(r) ^ laneToSrcLane(l)`, and each lane j supplies its source
+// register `roundToSrcRegister(r) ^ laneToSrcRegister(j)`.  Rounds in which
+// every lane reads from itself need no shuffle.
+//
+// All of these functions are linear (over GF(2)), so we only store their values
+// at the powers of two, e.g. roundToSrcLane[i] is the source lane of round
+// 1 << i.
+struct WarpShuffleSchedule {
+  int numRegisters;
+  int numLanes;
+  SmallVector<int32_t> roundToSrcLane;
+  SmallVector<int32_t> roundToSrcRegister;
+  SmallVector<int32_t> laneToSrcLane;
+  SmallVector<int32_t> laneToSrcRegister;
+  SmallVector<int32_t> laneToDstRegister;
+};
+
+// Returns a shuffle schedule for the conversion from srcTy to dstTy if the
+// conversion does not move data between warps and is simple enough to do with
+// one shuffle per destination register.  Otherwise returns std::nullopt, and
+// the conversion goes through shared memory.
+std::optional<WarpShuffleSchedule>
+getWarpShuffleSchedule(RankedTensorType srcTy, RankedTensorType dstTy);
+
 bool isMfmaToDotShortcut(RankedTensorType &srcTy, RankedTensorType &dstTy);
 
 bool isMmaToDotShortcut(RankedTensorType srcTy, RankedTensorType dstTy);
@@ -10,6 +10,8 @@ std::unique_ptr<Pass> createCombineOpsPass();
 
 std::unique_ptr<Pass> createReorderBroadcastPass();
 std::unique_ptr<Pass> createRewriteTensorPointerPass();
+std::unique_ptr<Pass> createFoldMasksPass();
+std::unique_ptr<Pass> createLowerCrossProgramScanPass();
 
 } // namespace triton
 
@@ -5,8 +5,11 @@
 #define TRITON_DIALECT_TRITONGPU_IR_LINEARLAYOUTCONVERSIONS_H
 
 #include <optional>
+#include <unordered_map>
 
 #include "triton/Tools/LinearLayout.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/Support/RWMutex.h"
 
 namespace mlir::triton::gpu {
 
@@ -40,10 +43,67 @@ namespace mlir::triton::gpu {
 // Returns std::nullopt if the given layout can't be converted to an LL.
 // TODO(jlebar): Remove the std::optional once all layouts are supported.
 //
+// The results are cached in the context of `layout`, see LinearLayoutCache.
 std::optional<LinearLayout>
 toLinearLayout(ArrayRef<int64_t> shape, Attribute layout,
                std::optional<int32_t> elemBitWidth = std::nullopt);
 
+// Returns the layout that maps each hardware location of `srcLayout` to one of
+// `dstLayout` holding the same tensor element, i.e.
+//
+//   toLinearLayout(shape, srcLayout).invertAndCompose(
+//       toLinearLayout(shape, dstLayout)),
+//
+// or std::nullopt if either layout can't be converted to an LL.  The results
+// are cached like the ones of toLinearLayout.
+std::optional<LinearLayout>
+toLinearLayoutConversion(ArrayRef<int64_t> shape, Attribute srcLayout,
+                         Attribute dstLayout,
+                         std::optional<int32_t> elemBitWidth = std::nullopt);
+
+// Interns the results of toLinearLayout and toLinearLayoutConversion.  The
+// same (shape, layout) pairs are converted many times during the compilation
+// of a kernel, e.g. when checking whether a convert_layout needs shared memory
+// and then again when lowering it.
+//
+// The TritonGPU dialect owns one cache per context, which lives as long as the
+// attributes it's keyed on.  Entries are never removed, so the returned
+// references remain valid.  The cache is thread-safe.
+class LinearLayoutCache {
+public:
+  // dstLayout is only set for the results of toLinearLayoutConversion.
+  struct Key {
+    SmallVector<int64_t> shape;
+    Attribute layout;
+    Attribute dstLayout;
+    std::optional<int32_t> elemBitWidth;
+
+    bool operator==(const Key &other) const {
+      return shape == other.shape && layout == other.layout &&
+             dstLayout == other.dstLayout &&
+             elemBitWidth == other.elemBitWidth;
+    }
+  };
+
+  // Returns the cached result for `key`, computing it with `compute` on a
+  // miss.
+  const std::optional<LinearLayout> &
+  getOrCompute(const Key &key,
+               function_ref<std::optional<LinearLayout>()> compute);
+
+private:
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      return llvm::hash_combine(
+          llvm::hash_combine_range(key.shape.begin(), key.shape.end()),
+          key.layout, key.dstLayout, key.elemBitWidth.value_or(-1));
+    }
+  };
+
+  std::unordered_map<Key, std::optional<LinearLayout>, KeyHash> cache;
+  llvm::sys::SmartRWMutex<true> mutex;
+};
+
 } // namespace mlir::triton::gpu
 
 #endif // TRITON_DIALECT_TRITONGPU_IR_LINEARLAYOUTCONVERSIONS_H
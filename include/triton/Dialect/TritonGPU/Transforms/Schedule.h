@@ -11,12 +11,25 @@
 namespace mlir {
 namespace triton {
 
+class ModuleAxisInfoAnalysis;
+
 /// This fill out the pipelining options including schedule and annotations
 /// for wait ops. This also does pre-processing by converting some of the
 /// loads into async loads so that the IR is ready to be pipelined.
+/// `axisInfoAnalysis` must cover the values of the loop.
 bool preProcessLoopAndGetSchedule(scf::ForOp &forOp, int numStages,
+                                  ModuleAxisInfoAnalysis &axisInfoAnalysis,
                                   mlir::triton::PipeliningOption &options);
 
+/// Same as preProcessLoopAndGetSchedule for loops without dot ops. Loads
+/// consumed by elementwise ops and reductions are issued as many iterations
+/// ahead as their latency requires, up to `numStages - 1`. Loops that write
+/// global memory, or contain ops with unknown memory effects such as calls,
+/// are not pipelined, as the writes may alias the loads.
+bool preProcessStreamingLoopAndGetSchedule(
+    scf::ForOp &forOp, int numStages, ModuleAxisInfoAnalysis &axisInfoAnalysis,
+    mlir::triton::PipeliningOption &options);
+
 /// Fills out pipelining options for an outer loop pipelining case. This
 /// schedules async copies to overlap with the epilogue of a loop.
 bool getOuterLoopSchedule(scf::ForOp &forOp, int numStages,
@@ -325,6 +325,22 @@ private:
   llvm::MapVector<StringAttr, int32_t /*size*/> outDims;
   bool surjective;
 
+  // The same function as a matrix over GF(2), packed in column-major order.
+  // This is what apply() and compose() work on.
+  //
+  // columns[i] is the image of the i'th input bit, counting the bits of the
+  // in-dims in order.  The image is the concatenation of the bits of the
+  // out-dims, in order.  For example, with in-dims (in1 of size 4, in2 of size
+  // 2) and out-dims (out1 of size 2, out2 of size 4), columns[2] is L(in1=0,
+  // in2=1), with out1 in bit 0 and out2 in bits 1 and 2.
+  //
+  // Derived from `bases` when the invariants are checked.
+  SmallVector<uint64_t> columns;
+  // The first column of each in-dim, followed by the number of columns.
+  SmallVector<int32_t> inDimColumnOffsets;
+  // The lowest bit of each out-dim in a column.
+  SmallVector<int32_t> outDimBitOffsets;
+
 public:
   using BasesT = decltype(bases);
 
@@ -415,6 +431,11 @@ public:
 
   const BasesT &getBases() const { return bases; }
 
+  // The layout as a matrix over GF(2) in column-major order: the i'th column
+  // is L applied to the i'th bit of the flattened input, as a flattened output.
+  // This is the same as flattenIns().flattenOuts().getBases(), packed.
+  ArrayRef<uint64_t> getColumns() const { return columns; }
+
   // Get the pos'th basis vector for the inDim -> outDim mapping.
   // getBasis(inDim, pos) = L(0, ..., inDim = 2^pos, ..., 0).
   ArrayRef<int32_t> getBasis(StringAttr inDim, int32_t pos) const {
@@ -687,6 +708,13 @@ private:
 
   [[nodiscard]] std::optional<std::string>
   checkInvariants(bool requireSurjective);
+
+  // Fills `columns` and the offsets from `bases` and `outDims`.
+  void packColumns();
+
+  // Gets the position of the inDim in getInDimNames(), or -1 if it is not
+  // present.
+  int32_t getInDimIndex(StringAttr inDim) const;
 };
 
 inline llvm::raw_ostream &operator<<(llvm::raw_ostream &os,
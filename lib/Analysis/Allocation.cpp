@@ -1,6 +1,7 @@
 #include "triton/Analysis/Allocation.h"
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <numeric>
 
@@ -12,7 +13,14 @@
 #include "triton/Analysis/Alias.h"
 #include "triton/Dialect/Triton/IR/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
+#include "triton/Tools/LinearLayout.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "allocate-shared-memory"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
 
 using ::mlir::triton::gpu::AMDMfmaEncodingAttr;
 using ::mlir::triton::gpu::BlockedEncodingAttr;
@@ -89,12 +97,132 @@ SmallVector<unsigned> getRepShapeForCvtLayout(triton::gpu::ConvertLayoutOp op) {
   return repShape;
 }
 
-SmallVector<unsigned>
-getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
-                             unsigned &outVec) {
+// Shared memory is modeled as kNumBanks banks of kBankWidth bytes. A warp-wide
+// access is split into wavefronts of at most kNumBanks * kBankWidth bytes, and
+// a wavefront whose lanes access different words of the same bank is
+// serialized into as many wavefronts as there are such words.
+constexpr unsigned kNumBanks = 32;
+constexpr unsigned kBankWidth = 4;
+
+namespace {
+struct BankAccessCost {
+  // Wavefronts needed by all the accesses of a warp
+  unsigned wavefronts = 0;
+  // The largest number of wavefronts a single wavefront is serialized into
+  unsigned conflictDegree = 1;
+};
+
+struct CvtScratchConfig {
+  SmallVector<unsigned> paddedRepShape;
+  unsigned inVec = 1;
+  unsigned outVec = 1;
+  std::optional<unsigned> conflictDegree;
+};
+} // namespace
+
+static int getLanesPerWavefront(int numLanes, unsigned accessBytes) {
+  return std::min<int>(numLanes, kNumBanks * kBankWidth /
+                                     std::max(accessBytes, kBankWidth));
+}
+
+// Wavefronts needed by the accesses of a warp if there are no bank conflicts.
+static unsigned getMinWavefronts(const LinearLayout &layout, unsigned vec,
+                                 unsigned elemBytes) {
+  MLIRContext *ctx = (*layout.getInDimNames().begin()).getContext();
+  int numRegisters = layout.getInDimSize(StringAttr::get(ctx, "register"));
+  int numLanes = layout.getInDimSize(StringAttr::get(ctx, "lane"));
+  return ceil<unsigned>(numRegisters, vec) *
+         ceil<unsigned>(numLanes,
+                        getLanesPerWavefront(numLanes, vec * elemBytes));
+}
+
+// Cost of the accesses of the first warp when the shared memory lowering of
+// convert_layout stores (or loads) `layout` in vectors of `vec` elements.
+// Elements are placed at their coordinates modulo `repShape`, linearized along
+// `order` in a buffer of shape `paddedRepShape`.
+static BankAccessCost getBankAccessCost(const LinearLayout &layout,
+                                        ArrayRef<unsigned> repShape,
+                                        ArrayRef<unsigned> paddedRepShape,
+                                        ArrayRef<unsigned> order, unsigned vec,
+                                        unsigned elemBytes) {
+  MLIRContext *ctx = (*layout.getInDimNames().begin()).getContext();
+  StringAttr kRegister = StringAttr::get(ctx, "register");
+  StringAttr kLane = StringAttr::get(ctx, "lane");
+  int numRegisters = layout.getInDimSize(kRegister);
+  int numLanes = layout.getInDimSize(kLane);
+
+  unsigned rank = paddedRepShape.size();
+  SmallVector<unsigned> strides(rank);
+  unsigned stride = 1;
+  for (unsigned d : order) {
+    strides[d] = stride;
+    stride *= paddedRepShape[d];
+  }
+  // The coordinates of an element are the xor of those of its register and of
+  // its lane.
+  auto getCoords = [&](StringAttr inDim, int size, int step) {
+    SmallVector<SmallVector<int32_t>> coords;
+    for (int i = 0; i < size; i += step) {
+      SmallVector<int32_t> coord(rank, 0);
+      for (int bit = 0; (1 << bit) < size; bit++) {
+        if (!(i & (1 << bit)))
+          continue;
+        for (unsigned d = 0; d < rank; d++)
+          coord[d] ^= layout.getBasis(inDim, bit)[d];
+      }
+      coords.push_back(std::move(coord));
+    }
+    return coords;
+  };
+  auto regCoords = getCoords(kRegister, numRegisters, vec);
+  auto laneCoords = getCoords(kLane, numLanes, 1);
+
+  unsigned accessBytes = vec * elemBytes;
+  int lanesPerWavefront = getLanesPerWavefront(numLanes, accessBytes);
+  BankAccessCost cost;
+  SmallVector<unsigned> addrs(numLanes);
+  SmallVector<SmallVector<unsigned, 4>> bankWords(kNumBanks);
+  for (const auto &regCoord : regCoords) {
+    for (int lane = 0; lane < numLanes; lane++) {
+      unsigned offset = 0;
+      for (unsigned d = 0; d < rank; d++)
+        offset += ((regCoord[d] ^ laneCoords[lane][d]) % repShape[d]) *
+                  strides[d];
+      addrs[lane] = offset * elemBytes;
+    }
+    for (int first = 0; first < numLanes; first += lanesPerWavefront) {
+      for (auto &words : bankWords)
+        words.clear();
+      unsigned wavefronts = 1;
+      for (unsigned addr : ArrayRef(addrs).slice(first, lanesPerWavefront)) {
+        for (unsigned word = addr / kBankWidth;
+             word <= (addr + accessBytes - 1) / kBankWidth; word++) {
+          auto &words = bankWords[word % kNumBanks];
+          if (llvm::is_contained(words, word))
+            continue;
+          words.push_back(word);
+          wavefronts = std::max<unsigned>(wavefronts, words.size());
+        }
+      }
+      cost.wavefronts += wavefronts;
+      cost.conflictDegree = std::max(cost.conflictDegree, wavefronts);
+    }
+  }
+  return cost;
+}
+
+// Attributes recording the scratch config chosen for a convert_layout
+constexpr char kCvtPaddedShapeAttr[] = "allocation.cvt_padded_shape";
+constexpr char kCvtVecAttr[] = "allocation.cvt_vec";
+constexpr char kCvtBankConflictsAttr[] = "allocation.bank_conflicts";
+
+static CvtScratchConfig
+searchCvtScratchConfig(triton::gpu::ConvertLayoutOp op) {
+  CvtScratchConfig config;
   auto repShape = getRepShapeForCvtLayout(op);
+  config.paddedRepShape = repShape;
   if (repShape.empty())
-    return repShape;
+    return config;
   auto rank = repShape.size();
   auto srcTy = op.getSrc().getType();
   auto dstTy = op.getType();
@@ -111,16 +239,18 @@ getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
   // TODO: Fix the legacy issue that ourOrd[0] == 0 always means
   //       that we cannot do vectorization.
   unsigned innerDim = rank - 1;
-  inVec = outOrd[0] != innerDim  ? 1
-          : inOrd[0] != innerDim ? 1
-                                 : srcContigPerThread;
-  outVec = outOrd[0] != innerDim ? 1 : dstContigPerThread;
+  unsigned inVec = outOrd[0] != innerDim  ? 1
+                   : inOrd[0] != innerDim ? 1
+                                          : srcContigPerThread;
+  unsigned outVec = outOrd[0] != innerDim ? 1 : dstContigPerThread;
 
   // For conversions to MmaV1 (Nvidia V100), this inVec is hardcoded in the
   // codegen.
+  bool fixedInVec = false;
   if (auto mma = mlir::dyn_cast<NvidiaMmaEncodingAttr>(srcLayout)) {
     if (mma.getVersionMajor() == 1) {
       inVec = srcContigPerThread;
+      fixedInVec = true;
     } else if (mlir::isa<BlockedEncodingAttr>(dstLayout)) {
       // when storing from mma layout and loading in blocked layout vectorizing
       // the load back gives better performance even if there is a
@@ -128,17 +258,117 @@ getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
       outVec = dstContigPerThread;
     }
   }
+  config.inVec = inVec;
+  config.outVec = outVec;
 
   if (rank <= 1)
-    return repShape;
+    return config;
   // pad the last dimension
   unsigned paddedDim = rank - 1;
   if (auto dstBlockedLayout = mlir::dyn_cast<BlockedEncodingAttr>(dstLayout)) {
     paddedDim = dstBlockedLayout.getOrder()[0];
   }
-  unsigned pad = std::max(inVec, outVec);
-  repShape[paddedDim] += pad;
-  return repShape;
+  config.paddedRepShape[paddedDim] += std::max(inVec, outVec);
+
+  // Hopper MMA layouts are stored with stmatrix, which the bank model doesn't
+  // describe.
+  auto srcMma = mlir::dyn_cast<NvidiaMmaEncodingAttr>(srcLayout);
+  if (fixedInVec || (srcMma && srcMma.isHopper()))
+    return config;
+  auto srcLinearLayout =
+      triton::gpu::toLinearLayout(srcTy.getShape(), srcLayout);
+  auto dstLinearLayout =
+      triton::gpu::toLinearLayout(dstTy.getShape(), dstLayout);
+  if (!srcLinearLayout || !dstLinearLayout)
+    return config;
+
+  // Search for the padding and vector widths that need the fewest wavefronts
+  // in total. Padding the rows by more than a full set of banks doesn't
+  // change the bank of any access, so it is never needed. On ties, wider
+  // vectors and then smaller paddings are preferred, and the search stops
+  // once no remaining candidate can do better.
+  unsigned elemBytes =
+      isa<triton::PointerType>(srcTy.getElementType())
+          ? kPtrBitWidth / 8
+          : std::max<int>(8, srcTy.getElementTypeBitWidth()) / 8;
+  auto order = getOrder(dstLayout);
+  std::optional<unsigned> bestWavefronts;
+  for (unsigned candInVec = inVec; candInVec >= 1; candInVec /= 2) {
+    for (unsigned candOutVec = outVec; candOutVec >= 1; candOutVec /= 2) {
+      unsigned minWavefronts =
+          getMinWavefronts(*srcLinearLayout, candInVec, elemBytes) +
+          getMinWavefronts(*dstLinearLayout, candOutVec, elemBytes);
+      if (bestWavefronts && *bestWavefronts <= minWavefronts)
+        continue;
+      unsigned padStep = std::max(candInVec, candOutVec);
+      for (unsigned pad = 0; pad * elemBytes < kNumBanks * kBankWidth;
+           pad += padStep) {
+        SmallVector<unsigned> paddedRepShape(repShape);
+        paddedRepShape[paddedDim] += pad;
+        BankAccessCost store =
+            getBankAccessCost(*srcLinearLayout, repShape, paddedRepShape,
+                              order, candInVec, elemBytes);
+        BankAccessCost load =
+            getBankAccessCost(*dstLinearLayout, repShape, paddedRepShape,
+                              order, candOutVec, elemBytes);
+        unsigned wavefronts = store.wavefronts + load.wavefronts;
+        if (bestWavefronts && *bestWavefronts <= wavefronts)
+          continue;
+        bestWavefronts = wavefronts;
+        config.paddedRepShape = paddedRepShape;
+        config.inVec = candInVec;
+        config.outVec = candOutVec;
+        config.conflictDegree =
+            std::max(store.conflictDegree, load.conflictDegree);
+        if (wavefronts == minWavefronts)
+          break;
+      }
+    }
+  }
+  return config;
+}
+
+static CvtScratchConfig getCvtScratchConfig(triton::gpu::ConvertLayoutOp op) {
+  auto paddedShape = op->getAttrOfType<DenseI32ArrayAttr>(kCvtPaddedShapeAttr);
+  auto vec = op->getAttrOfType<DenseI32ArrayAttr>(kCvtVecAttr);
+  if (!paddedShape || !vec)
+    return searchCvtScratchConfig(op);
+  CvtScratchConfig config;
+  config.paddedRepShape =
+      convertType<unsigned, int32_t>(paddedShape.asArrayRef());
+  config.inVec = vec[0];
+  config.outVec = vec[1];
+  if (auto degree = op->getAttrOfType<IntegerAttr>(kCvtBankConflictsAttr))
+    config.conflictDegree = degree.getInt();
+  return config;
+}
+
+void recordScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op) {
+  if (isa<SharedEncodingAttr>(op.getSrc().getType().getEncoding()) ||
+      isa<SharedEncodingAttr>(op.getType().getEncoding()))
+    return;
+  auto config = searchCvtScratchConfig(op);
+  if (config.paddedRepShape.empty())
+    return;
+  Builder builder(op.getContext());
+  op->setAttr(kCvtPaddedShapeAttr,
+              builder.getDenseI32ArrayAttr(
+                  convertType<int32_t, unsigned>(config.paddedRepShape)));
+  op->setAttr(kCvtVecAttr, builder.getDenseI32ArrayAttr(
+                               {static_cast<int32_t>(config.inVec),
+                                static_cast<int32_t>(config.outVec)}));
+  if (config.conflictDegree)
+    op->setAttr(kCvtBankConflictsAttr,
+                builder.getI32IntegerAttr(*config.conflictDegree));
+}
+
+SmallVector<unsigned>
+getScratchConfigForCvtLayout(triton::gpu::ConvertLayoutOp op, unsigned &inVec,
+                             unsigned &outVec) {
+  auto config = getCvtScratchConfig(op);
+  inVec = config.inVec;
+  outVec = config.outVec;
+  return config.paddedRepShape;
 }
 
 // TODO: extend beyond scalars
@@ -245,12 +475,14 @@ private:
       unsigned bytes = helper.getScratchSizeInBytes();
       maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
                                                           scratchAlignment);
+    } else if (auto sortOp = dyn_cast<triton::SortOp>(op)) {
+      SortOpHelper helper(sortOp);
+      unsigned bytes = helper.getScratchSizeInBytes();
+      maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
+                                                          scratchAlignment);
     } else if (auto histogram = dyn_cast<triton::HistogramOp>(op)) {
-      auto dstTy = histogram.getType();
-      int threadsPerWarp = triton::gpu::TritonGPUDialect::getThreadsPerWarp(
-          op->getParentOfType<ModuleOp>());
-      auto bytes = std::max<int>(dstTy.getNumElements(), threadsPerWarp) *
-                   std::max<int>(8, dstTy.getElementTypeBitWidth()) / 8;
+      HistogramOpHelper helper(histogram);
+      unsigned bytes = helper.getScratchSizeInBytes();
       maybeAddScratchBuffer<BufferT::BufferKind::Scratch>(op, bytes,
                                                           scratchAlignment);
     } else if (auto cvtLayout = dyn_cast<triton::gpu::ConvertLayoutOp>(op)) {
@@ -459,14 +691,27 @@ private:
   }
 
   /// Computes the shared memory offsets for all related values.
-  /// Paper: Algorithms for Compile-Time Memory Optimization
-  /// (https://dl.acm.org/doi/pdf/10.5555/314500.315082)
   void computeOffsets() {
     SmallVector<BufferT *> buffers;
     for (auto bufferIter : bufferRange) {
       buffers.emplace_back(bufferIter.first);
     }
 
+    computeOffsetsBumping(buffers);
+    if (allocation->policy == AllocationPolicy::BestFit)
+      computeOffsetsBestFit(buffers);
+
+    allocation->liveSizeLowerBound = computeLiveSizeLowerBound(buffers);
+    LLVM_DEBUG({
+      DBGS() << "shared memory size: " << allocation->sharedMemorySize
+             << " bytes, live size lower bound: "
+             << allocation->liveSizeLowerBound << " bytes\n";
+    });
+  }
+
+  /// Paper: Algorithms for Compile-Time Memory Optimization
+  /// (https://dl.acm.org/doi/pdf/10.5555/314500.315082)
+  void computeOffsetsBumping(const SmallVector<BufferT *> &buffers) {
     calculateStarts(buffers);
 
     // NOTE: The original paper doesn't consider interference between
@@ -484,6 +729,111 @@ private:
     } while (!interference.empty());
   }
 
+  /// Places the buffers one by one in the smallest gap that fits them (once
+  /// aligned) among the buffers already placed whose liveness ranges overlap
+  /// theirs. Since the result depends on the placement order, a few orders
+  /// are tried, and the smallest allocation is kept, including the current
+  /// one computed by the bumping allocator.
+  void computeOffsetsBestFit(const SmallVector<BufferT *> &buffers) {
+    auto getOffsets = [&]() {
+      return llvm::to_vector(
+          llvm::map_range(buffers, [](BufferT *buffer) -> size_t {
+            return buffer->offset;
+          }));
+    };
+    SmallVector<size_t> bestOffsets = getOffsets();
+    size_t bestSize = allocation->sharedMemorySize;
+
+    auto start = [&](BufferT *buffer) -> int64_t {
+      return bufferRange.lookup(buffer).start();
+    };
+    auto lifetime = [&](BufferT *buffer) -> int64_t {
+      return bufferRange.lookup(buffer).size();
+    };
+    auto size = [](BufferT *buffer) -> int64_t { return buffer->size; };
+    // Sort keys of the placement orders, in increasing order
+    using KeyT = std::pair<int64_t, int64_t>;
+    SmallVector<std::function<KeyT(BufferT *)>> orders = {
+        // Largest size x lifetime first
+        [&](BufferT *b) { return KeyT(-size(b) * lifetime(b), -size(b)); },
+        // Largest first
+        [&](BufferT *b) { return KeyT(-size(b), start(b)); },
+        // Earliest first
+        [&](BufferT *b) { return KeyT(start(b), -size(b)); },
+        // Longest lived first
+        [&](BufferT *b) { return KeyT(-lifetime(b), -size(b)); },
+    };
+    for (auto &key : orders) {
+      SmallVector<BufferT *> order = buffers;
+      llvm::stable_sort(order, [&](BufferT *lhs, BufferT *rhs) {
+        return key(lhs) < key(rhs);
+      });
+      size_t size = placeBestFit(order);
+      if (size < bestSize) {
+        bestSize = size;
+        bestOffsets = getOffsets();
+      }
+    }
+    for (auto [buffer, offset] : llvm::zip(buffers, bestOffsets))
+      buffer->offset = offset;
+    allocation->sharedMemorySize = bestSize;
+  }
+
+  /// Places the buffers in the given order, returns the shared memory size.
+  size_t placeBestFit(ArrayRef<BufferT *> order) {
+    size_t sharedMemorySize = 0;
+    SmallVector<BufferT *> placed;
+    SmallVector<Interval<size_t>> busy;
+    for (auto *buffer : order) {
+      auto range = bufferRange.lookup(buffer);
+      busy.clear();
+      for (auto *other : placed) {
+        if (bufferRange.lookup(other).intersects(range))
+          busy.emplace_back(other->offset, other->offset + other->size);
+      }
+      llvm::sort(busy);
+      // Look for the smallest gap that fits, or fall back to the end of the
+      // busy intervals
+      std::optional<size_t> bestOffset;
+      size_t bestGapSize = std::numeric_limits<size_t>::max();
+      size_t gapStart = 0;
+      for (auto interval : busy) {
+        size_t offset = llvm::alignTo(gapStart, buffer->alignment);
+        size_t gapSize = interval.start() - gapStart;
+        if (interval.start() > gapStart &&
+            offset + buffer->size <= interval.start() &&
+            gapSize < bestGapSize) {
+          bestOffset = offset;
+          bestGapSize = gapSize;
+        }
+        gapStart = std::max(gapStart, interval.end());
+      }
+      if (!bestOffset)
+        bestOffset = llvm::alignTo(gapStart, buffer->alignment);
+      buffer->offset = *bestOffset;
+      placed.push_back(buffer);
+      sharedMemorySize =
+          std::max(sharedMemorySize, buffer->offset + buffer->size);
+    }
+    return sharedMemorySize;
+  }
+
+  /// Returns the largest total size of the buffers live at the same time.
+  size_t computeLiveSizeLowerBound(const SmallVector<BufferT *> &buffers) {
+    size_t lowerBound = 0;
+    // The total live size can only increase where a liveness range starts
+    for (auto *x : buffers) {
+      size_t point = bufferRange.lookup(x).start();
+      size_t liveSize = 0;
+      for (auto *y : buffers) {
+        if (bufferRange.lookup(y).contains(point))
+          liveSize += y->size;
+      }
+      lowerBound = std::max(lowerBound, liveSize);
+    }
+    return lowerBound;
+  }
+
   /// Computes the initial shared memory offsets.
   void calculateStarts(const SmallVector<BufferT *> &buffers) {
     //  v = values in shared memory
@@ -627,4 +977,20 @@ void Allocation::run(FuncAllocMapT &funcAllocMap) {
   triton::AllocationAnalysis(getOperation(), &funcAllocMap, this);
 }
 
+std::optional<AllocationPolicy> parseAllocationPolicy(StringRef name) {
+  return llvm::StringSwitch<std::optional<AllocationPolicy>>(name)
+      .Case("bumping", AllocationPolicy::Bumping)
+      .Case("best-fit", AllocationPolicy::BestFit)
+      .Default(std::nullopt);
+}
+
+AllocationPolicy getAllocationPolicy(ModuleOp moduleOp) {
+  auto name =
+      moduleOp->getAttrOfType<StringAttr>("triton_gpu.shared-allocator");
+  if (!name)
+    return AllocationPolicy::Bumping;
+  return parseAllocationPolicy(name.getValue())
+      .value_or(AllocationPolicy::Bumping);
+}
+
 } // namespace mlir
@@ -1,5 +1,6 @@
 #include "mlir/Analysis/DataFlowFramework.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -11,6 +12,11 @@
 #define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
 #define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
 
+STATISTIC(NumSolverRuns,
+          "Number of functions analyzed by the axis info solver");
+STATISTIC(NumSolverRunsAvoided,
+          "Number of axis info solver runs avoided by reusing an analysis");
+
 namespace mlir::triton {
 namespace {
 
@@ -1265,7 +1271,19 @@ unsigned ModuleAxisInfoAnalysis::getMaskAlignment(Value mask) {
   return alignment;
 }
 
+ModuleAxisInfoAnalysis &ModuleAxisInfoAnalysis::get(AnalysisManager am) {
+  if (auto cached = am.getCachedAnalysis<ModuleAxisInfoAnalysis>()) {
+    ModuleAxisInfoAnalysis &analysis = cached->get();
+    NumSolverRunsAvoided += analysis.getNumFunctions();
+    LDBG("reusing the analysis of " << analysis.getNumFunctions()
+                                    << " functions");
+    return analysis;
+  }
+  return am.getAnalysis<ModuleAxisInfoAnalysis, ModuleOp>();
+}
+
 void ModuleAxisInfoAnalysis::initialize(FunctionOpInterface funcOp) {
+  ++NumSolverRuns;
   std::unique_ptr<DataFlowSolver> solver = createDataFlowSolver();
   AxisInfoAnalysis *analysis = solver->load<AxisInfoAnalysis>();
   if (failed(solver->initializeAndRun(funcOp)))
@@ -0,0 +1,803 @@
+#include "mlir/Analysis/DataFlowFramework.h"
+#include "llvm/Support/CheckedArithmetic.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "triton/Analysis/RangeInfo.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#define DEBUG_TYPE "range-info"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace mlir::triton {
+namespace {
+
+using SymbolicBound = RangeInfo::SymbolicBound;
+using RangeLattice = dataflow::Lattice<RangeInfo>;
+
+// Returns [min, max] if it is representable with the given bit width. A
+// computation whose result may not fit may have wrapped around, so its result
+// can be any integer of the type.
+RangeInfo getRangeOrMax(unsigned bitWidth, std::optional<int64_t> min,
+                        std::optional<int64_t> max,
+                        std::optional<SymbolicBound> lower = std::nullopt,
+                        std::optional<SymbolicBound> upper = std::nullopt) {
+  if (!min || !max || *min < RangeInfo::getTypeMin(bitWidth) ||
+      *max > RangeInfo::getTypeMax(bitWidth))
+    return RangeInfo::getMaxRange(bitWidth);
+  return RangeInfo(bitWidth, *min, *max, lower, upper);
+}
+
+// Symbolic bounds are relative to the current values of their bases, so they
+// do not hold across control flow edges: a loop carried value would be
+// bounded by the bases of the previous iteration. Only the induction variables
+// keep theirs, which are relative to values defined outside of the loops.
+bool hasSymbolicBounds(Value value) {
+  if (auto blockArg = dyn_cast<BlockArgument>(value)) {
+    auto forOp = dyn_cast<scf::ForOp>(blockArg.getOwner()->getParentOp());
+    return forOp && forOp.getInductionVar() == value;
+  }
+  return !isa<RegionBranchOpInterface>(value.getDefiningOp());
+}
+
+// The symbolic bounds of `value`. Scalar integers are bounded by themselves if
+// nothing else is known.
+std::optional<SymbolicBound> getLowerBound(Value value, const RangeInfo &info) {
+  if (info.getLower() && hasSymbolicBounds(value))
+    return info.getLower();
+  if (value.getType().isIntOrIndex())
+    return SymbolicBound{value, 0};
+  return std::nullopt;
+}
+
+std::optional<SymbolicBound> getUpperBound(Value value, const RangeInfo &info) {
+  if (info.getUpper() && hasSymbolicBounds(value))
+    return info.getUpper();
+  if (value.getType().isIntOrIndex())
+    return SymbolicBound{value, 0};
+  return std::nullopt;
+}
+
+std::optional<SymbolicBound> addOffset(std::optional<SymbolicBound> bound,
+                                       std::optional<int64_t> offset) {
+  if (!bound || !offset)
+    return std::nullopt;
+  auto newOffset = llvm::checkedAdd(bound->offset, *offset);
+  if (!newOffset)
+    return std::nullopt;
+  return SymbolicBound{bound->base, *newOffset};
+}
+
+std::optional<int64_t> negate(int64_t value) {
+  return llvm::checkedSub<int64_t>(0, value);
+}
+
+// Returns true if `lhs < rhs` (or `lhs <= rhs` if not `strict`) holds for all
+// the elements.
+bool isLess(Value lhsValue, const RangeInfo &lhs, Value rhsValue,
+            const RangeInfo &rhs, bool strict) {
+  if (strict ? lhs.getMax() < rhs.getMin() : lhs.getMax() <= rhs.getMin())
+    return true;
+  auto upper = getUpperBound(lhsValue, lhs);
+  auto lower = getLowerBound(rhsValue, rhs);
+  if (!upper || !lower || upper->base != lower->base)
+    return false;
+  return strict ? upper->offset < lower->offset
+                : upper->offset <= lower->offset;
+}
+
+class RangeInfoVisitor {
+public:
+  RangeInfoVisitor() = default;
+  virtual ~RangeInfoVisitor() = default;
+
+  virtual RangeInfo getRangeInfo(Operation *op,
+                                 ArrayRef<const RangeLattice *> operands) = 0;
+
+  virtual bool match(Operation *op) = 0;
+};
+
+// Base class for all operations
+template <typename OpTy> class RangeInfoVisitorImpl : public RangeInfoVisitor {
+public:
+  using RangeInfoVisitor::RangeInfoVisitor;
+
+  RangeInfo getRangeInfo(Operation *op,
+                         ArrayRef<const RangeLattice *> operands) final {
+    return getRangeInfo(cast<OpTy>(op), operands);
+  }
+
+  bool match(Operation *op) final { return isa<OpTy>(op); }
+
+  virtual RangeInfo getRangeInfo(OpTy op,
+                                 ArrayRef<const RangeLattice *> operands) = 0;
+};
+
+class RangeInfoVisitorList {
+public:
+  template <typename... Ts, typename = std::enable_if_t<sizeof...(Ts) != 0>>
+  void append() {
+    (visitors.emplace_back(std::make_unique<Ts>()), ...);
+  }
+
+  RangeInfoVisitor *lookup(Operation *op) {
+    for (auto &visitor : visitors)
+      if (visitor->match(op))
+        return visitor.get();
+    return nullptr;
+  }
+
+private:
+  std::vector<std::unique_ptr<RangeInfoVisitor>> visitors;
+};
+
+class RangeInfoAnalysis
+    : public dataflow::SparseForwardDataFlowAnalysis<RangeLattice> {
+private:
+  RangeInfoVisitorList visitors;
+  ModuleAxisInfoAnalysis &axisInfoAnalysis;
+
+  void setToEntryState(RangeLattice *lattice) override {
+    propagateIfChanged(lattice,
+                       lattice->join(RangeInfo::getPessimisticValueState(
+                           lattice->getPoint())));
+  }
+
+  void visitNonControlFlowArguments(Operation *op,
+                                    const RegionSuccessor &successor,
+                                    ArrayRef<RangeLattice *> argLattices,
+                                    unsigned firstIndex) override {
+    if (auto forOp = dyn_cast<scf::ForOp>(op)) {
+      visitForOpInductionVar(forOp, argLattices);
+    } else {
+      setAllToEntryStates(argLattices.take_front(firstIndex));
+      setAllToEntryStates(argLattices.drop_front(
+          firstIndex + successor.getSuccessorInputs().size()));
+    }
+  }
+
+  // Tightens the constant bounds of `info` with the ranges of the bases of its
+  // symbolic bounds.
+  RangeInfo tighten(Operation *op, const RangeInfo &info);
+
+public:
+  RangeInfoAnalysis(DataFlowSolver &solver,
+                    ModuleAxisInfoAnalysis &axisInfoAnalysis);
+  using dataflow::SparseForwardDataFlowAnalysis<
+      RangeLattice>::getLatticeElement;
+
+  void visitOperation(Operation *op, ArrayRef<const RangeLattice *> operands,
+                      ArrayRef<RangeLattice *> results) override;
+  void visitForOpInductionVar(scf::ForOp op,
+                              ArrayRef<RangeLattice *> argLattices);
+};
+
+class ConstantOpRangeInfoVisitor final
+    : public RangeInfoVisitorImpl<arith::ConstantOp> {
+public:
+  using RangeInfoVisitorImpl<arith::ConstantOp>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(arith::ConstantOp op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    unsigned bitWidth = RangeInfo::getBitWidth(op.getType());
+    auto getValue = [&](const APInt &value) -> int64_t {
+      return bitWidth == 1 ? value.getZExtValue() : value.getSExtValue();
+    };
+    if (auto intAttr = dyn_cast<IntegerAttr>(op.getValue())) {
+      int64_t value = getValue(intAttr.getValue());
+      return RangeInfo(bitWidth, value, value);
+    }
+    auto denseAttr = dyn_cast<DenseIntElementsAttr>(op.getValue());
+    if (!denseAttr)
+      return RangeInfo();
+    if (denseAttr.isSplat()) {
+      int64_t value = getValue(denseAttr.getSplatValue<APInt>());
+      return RangeInfo(bitWidth, value, value);
+    }
+    int64_t min = RangeInfo::getTypeMax(bitWidth);
+    int64_t max = RangeInfo::getTypeMin(bitWidth);
+    for (const APInt &elem : denseAttr.getValues<APInt>()) {
+      min = std::min(min, getValue(elem));
+      max = std::max(max, getValue(elem));
+    }
+    return RangeInfo(bitWidth, min, max);
+  }
+};
+
+class MakeRangeOpRangeInfoVisitor final
+    : public RangeInfoVisitorImpl<triton::MakeRangeOp> {
+public:
+  using RangeInfoVisitorImpl<triton::MakeRangeOp>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(triton::MakeRangeOp op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    return RangeInfo(32, op.getStart(), op.getEnd() - 1);
+  }
+};
+
+// Program ids are smaller than the number of programs, which fits in an i32.
+class ProgramIdOpRangeInfoVisitor final
+    : public RangeInfoVisitorImpl<triton::GetProgramIdOp> {
+public:
+  using RangeInfoVisitorImpl<triton::GetProgramIdOp>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(triton::GetProgramIdOp op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    return RangeInfo(32, 0, RangeInfo::getTypeMax(32) - 1);
+  }
+};
+
+class NumProgramsOpRangeInfoVisitor final
+    : public RangeInfoVisitorImpl<triton::GetNumProgramsOp> {
+public:
+  using RangeInfoVisitorImpl<triton::GetNumProgramsOp>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(triton::GetNumProgramsOp op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    return RangeInfo(32, 1, RangeInfo::getTypeMax(32));
+  }
+};
+
+// Operations that move the elements around without changing them
+template <typename OpTy>
+class ShapeOpRangeInfoVisitor final : public RangeInfoVisitorImpl<OpTy> {
+public:
+  using RangeInfoVisitorImpl<OpTy>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(OpTy op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto info = operands[0]->getValue();
+    Value src = op->getOperand(0);
+    if (info.getBitWidth() == 1)
+      return info;
+    return RangeInfo(info.getBitWidth(), info.getMin(), info.getMax(),
+                     getLowerBound(src, info), getUpperBound(src, info));
+  }
+};
+
+template <typename OpTy>
+class IntCastOpRangeInfoVisitor final : public RangeInfoVisitorImpl<OpTy> {
+public:
+  using RangeInfoVisitorImpl<OpTy>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(OpTy op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto info = operands[0]->getValue();
+    Value src = op->getOperand(0);
+    unsigned srcBitWidth = info.getBitWidth();
+    unsigned bitWidth = RangeInfo::getBitWidth(op.getType());
+    // Booleans are in [0, 1], sign extending them gives [-1, 0].
+    if (srcBitWidth == 1) {
+      if (std::is_same_v<OpTy, arith::ExtSIOp>)
+        return RangeInfo(bitWidth, -info.getMax(), -info.getMin());
+      return RangeInfo(bitWidth, info.getMin(), info.getMax());
+    }
+    if (bitWidth == 1) {
+      if (info.getMin() >= 0 && info.getMax() <= 1)
+        return RangeInfo(bitWidth, info.getMin(), info.getMax());
+      return RangeInfo::getMaxRange(bitWidth);
+    }
+    if (std::is_same_v<OpTy, arith::ExtUIOp> && info.getMin() < 0)
+      return RangeInfo(bitWidth, 0, RangeInfo::getTypeMax(srcBitWidth + 1));
+    // The elements are unchanged if they fit in the new type.
+    return getRangeOrMax(bitWidth, info.getMin(), info.getMax(),
+                         getLowerBound(src, info), getUpperBound(src, info));
+  }
+};
+
+template <typename OpTy>
+class AddSubOpRangeInfoVisitor final : public RangeInfoVisitorImpl<OpTy> {
+public:
+  using RangeInfoVisitorImpl<OpTy>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(OpTy op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto lhs = operands[0]->getValue();
+    auto rhs = operands[1]->getValue();
+    unsigned bitWidth = lhs.getBitWidth();
+    if (bitWidth == 1)
+      return RangeInfo::getMaxRange(bitWidth);
+    if constexpr (std::is_same_v<OpTy, arith::AddIOp>) {
+      auto min = llvm::checkedAdd(lhs.getMin(), rhs.getMin());
+      auto max = llvm::checkedAdd(lhs.getMax(), rhs.getMax());
+      // x + [a, b] is in [lower(x) + a, upper(x) + b]. Keep the symbolic
+      // bounds of the operand that is not a constant, or else of the one
+      // whose bounds are not trivial.
+      bool useLhs = rhs.getConstantValue() ||
+                    (!lhs.getConstantValue() &&
+                     (lhs.getUpper() || lhs.getLower() ||
+                      !(rhs.getUpper() || rhs.getLower())));
+      Value x = useLhs ? op.getLhs() : op.getRhs();
+      const RangeInfo &xInfo = useLhs ? lhs : rhs;
+      const RangeInfo &other = useLhs ? rhs : lhs;
+      return getRangeOrMax(bitWidth, min, max,
+                           addOffset(getLowerBound(x, xInfo), other.getMin()),
+                           addOffset(getUpperBound(x, xInfo), other.getMax()));
+    } else {
+      // x - [a, b] is in [lower(x) - b, upper(x) - a].
+      auto min = llvm::checkedSub(lhs.getMin(), rhs.getMax());
+      auto max = llvm::checkedSub(lhs.getMax(), rhs.getMin());
+      return getRangeOrMax(
+          bitWidth, min, max,
+          addOffset(getLowerBound(op.getLhs(), lhs), negate(rhs.getMax())),
+          addOffset(getUpperBound(op.getLhs(), lhs), negate(rhs.getMin())));
+    }
+  }
+};
+
+class MulIOpRangeInfoVisitor final
+    : public RangeInfoVisitorImpl<arith::MulIOp> {
+public:
+  using RangeInfoVisitorImpl<arith::MulIOp>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(arith::MulIOp op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto lhs = operands[0]->getValue();
+    auto rhs = operands[1]->getValue();
+    unsigned bitWidth = lhs.getBitWidth();
+    if (bitWidth == 1)
+      return RangeInfo::getMaxRange(bitWidth);
+    std::optional<int64_t> min, max;
+    for (int64_t a : {lhs.getMin(), lhs.getMax()}) {
+      for (int64_t b : {rhs.getMin(), rhs.getMax()}) {
+        auto product = llvm::checkedMul(a, b);
+        if (!product)
+          return RangeInfo::getMaxRange(bitWidth);
+        min = std::min(min.value_or(*product), *product);
+        max = std::max(max.value_or(*product), *product);
+      }
+    }
+    return getRangeOrMax(bitWidth, min, max);
+  }
+};
+
+template <typename OpTy>
+class DivOpRangeInfoVisitor final : public RangeInfoVisitorImpl<OpTy> {
+public:
+  using RangeInfoVisitorImpl<OpTy>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(OpTy op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto lhs = operands[0]->getValue();
+    auto rhs = operands[1]->getValue();
+    unsigned bitWidth = lhs.getBitWidth();
+    // Only positive divisors are handled, unsigned divisions also need a
+    // non-negative dividend to match the signed one.
+    bool isUnsigned = std::is_same_v<OpTy, arith::DivUIOp>;
+    if (bitWidth == 1 || rhs.getMin() <= 0 ||
+        (isUnsigned && lhs.getMin() < 0))
+      return RangeInfo::getMaxRange(bitWidth);
+    int64_t min = std::min(lhs.getMin() / rhs.getMin(),
+                           lhs.getMin() / rhs.getMax());
+    int64_t max = std::max(lhs.getMax() / rhs.getMin(),
+                           lhs.getMax() / rhs.getMax());
+    return RangeInfo(bitWidth, min, max);
+  }
+};
+
+template <typename OpTy>
+class RemOpRangeInfoVisitor final : public RangeInfoVisitorImpl<OpTy> {
+public:
+  using RangeInfoVisitorImpl<OpTy>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(OpTy op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto lhs = operands[0]->getValue();
+    auto rhs = operands[1]->getValue();
+    unsigned bitWidth = lhs.getBitWidth();
+    bool isUnsigned = std::is_same_v<OpTy, arith::RemUIOp>;
+    if (bitWidth == 1 || rhs.getMin() <= 0 ||
+        (isUnsigned && lhs.getMin() < 0))
+      return RangeInfo::getMaxRange(bitWidth);
+    // The remainder has the sign of the dividend and is smaller than the
+    // divisor in magnitude.
+    int64_t bound = rhs.getMax() - 1;
+    int64_t min = lhs.getMin() >= 0 ? 0 : std::max(lhs.getMin(), -bound);
+    int64_t max = lhs.getMax() <= 0 ? 0 : std::min(lhs.getMax(), bound);
+    return RangeInfo(bitWidth, min, max);
+  }
+};
+
+template <typename OpTy>
+class MaxMinOpRangeInfoVisitor final : public RangeInfoVisitorImpl<OpTy> {
+public:
+  using RangeInfoVisitorImpl<OpTy>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(OpTy op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto lhs = operands[0]->getValue();
+    auto rhs = operands[1]->getValue();
+    unsigned bitWidth = lhs.getBitWidth();
+    // Unsigned and signed orders agree on non-negative integers.
+    bool isUnsigned = std::is_same_v<OpTy, arith::MaxUIOp> ||
+                      std::is_same_v<OpTy, arith::MinUIOp>;
+    if (bitWidth == 1 ||
+        (isUnsigned && (lhs.getMin() < 0 || rhs.getMin() < 0)))
+      return RangeInfo::getMaxRange(bitWidth);
+    if constexpr (std::is_same_v<OpTy, arith::MaxSIOp> ||
+                  std::is_same_v<OpTy, arith::MaxUIOp>) {
+      // max(x, y) is at least the lower bound of either operand.
+      auto lower = getLowerBound(op.getLhs(), lhs);
+      if (!lower)
+        lower = getLowerBound(op.getRhs(), rhs);
+      return RangeInfo(bitWidth, std::max(lhs.getMin(), rhs.getMin()),
+                       std::max(lhs.getMax(), rhs.getMax()), lower,
+                       std::nullopt);
+    } else {
+      auto upper = getUpperBound(op.getLhs(), lhs);
+      if (!upper)
+        upper = getUpperBound(op.getRhs(), rhs);
+      return RangeInfo(bitWidth, std::min(lhs.getMin(), rhs.getMin()),
+                       std::min(lhs.getMax(), rhs.getMax()), std::nullopt,
+                       upper);
+    }
+  }
+};
+
+template <typename OpTy>
+class LogicalOpRangeInfoVisitor final : public RangeInfoVisitorImpl<OpTy> {
+public:
+  using RangeInfoVisitorImpl<OpTy>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(OpTy op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto lhs = operands[0]->getValue();
+    auto rhs = operands[1]->getValue();
+    unsigned bitWidth = lhs.getBitWidth();
+    constexpr bool isAnd = std::is_same_v<OpTy, arith::AndIOp>;
+    if (bitWidth == 1) {
+      // A false operand of an and, or a true operand of an or, decides the
+      // result.
+      int64_t absorbing = isAnd ? 0 : 1;
+      if (lhs.getConstantValue() == absorbing ||
+          rhs.getConstantValue() == absorbing)
+        return RangeInfo(bitWidth, absorbing, absorbing);
+      return RangeInfo(bitWidth, std::min(lhs.getMin(), rhs.getMin()),
+                       std::max(lhs.getMax(), rhs.getMax()));
+    }
+    // The bitwise and of non-negative integers is at most either of them.
+    if (isAnd && (lhs.getMin() >= 0 || rhs.getMin() >= 0)) {
+      int64_t max = std::numeric_limits<int64_t>::max();
+      if (lhs.getMin() >= 0)
+        max = std::min(max, lhs.getMax());
+      if (rhs.getMin() >= 0)
+        max = std::min(max, rhs.getMax());
+      return RangeInfo(bitWidth, 0, max);
+    }
+    return RangeInfo::getMaxRange(bitWidth);
+  }
+};
+
+class SelectOpRangeInfoVisitor final
+    : public RangeInfoVisitorImpl<arith::SelectOp> {
+public:
+  using RangeInfoVisitorImpl<arith::SelectOp>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(arith::SelectOp op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto condition = operands[0]->getValue();
+    auto lhs = operands[1]->getValue();
+    auto rhs = operands[2]->getValue();
+    if (condition.getConstantValue() == 1)
+      return lhs;
+    if (condition.getConstantValue() == 0)
+      return rhs;
+    auto lower = getLowerBound(op.getTrueValue(), lhs);
+    if (lower != getLowerBound(op.getFalseValue(), rhs))
+      lower = std::nullopt;
+    auto upper = getUpperBound(op.getTrueValue(), lhs);
+    if (upper != getUpperBound(op.getFalseValue(), rhs))
+      upper = std::nullopt;
+    return RangeInfo(lhs.getBitWidth(), std::min(lhs.getMin(), rhs.getMin()),
+                     std::max(lhs.getMax(), rhs.getMax()), lower, upper);
+  }
+};
+
+class CmpIOpRangeInfoVisitor final
+    : public RangeInfoVisitorImpl<arith::CmpIOp> {
+public:
+  using RangeInfoVisitorImpl<arith::CmpIOp>::RangeInfoVisitorImpl;
+
+  RangeInfo getRangeInfo(arith::CmpIOp op,
+                         ArrayRef<const RangeLattice *> operands) override {
+    auto lhs = operands[0]->getValue();
+    auto rhs = operands[1]->getValue();
+    auto result = compare(op, lhs, rhs);
+    if (!result)
+      return RangeInfo(1, 0, 1);
+    return RangeInfo(1, *result, *result);
+  }
+
+private:
+  static std::optional<bool> compare(arith::CmpIOp op, const RangeInfo &lhs,
+                                     const RangeInfo &rhs) {
+    if (lhs.getBitWidth() == 1)
+      return std::nullopt;
+    // Unsigned and signed orders agree on non-negative integers.
+    auto predicate = op.getPredicate();
+    bool isUnsigned = predicate == arith::CmpIPredicate::ult ||
+                      predicate == arith::CmpIPredicate::ule ||
+                      predicate == arith::CmpIPredicate::ugt ||
+                      predicate == arith::CmpIPredicate::uge;
+    if (isUnsigned && (lhs.getMin() < 0 || rhs.getMin() < 0))
+      return std::nullopt;
+    auto less = [&](bool strict) {
+      return isLess(op.getLhs(), lhs, op.getRhs(), rhs, strict);
+    };
+    auto greater = [&](bool strict) {
+      return isLess(op.getRhs(), rhs, op.getLhs(), lhs, strict);
+    };
+    switch (predicate) {
+    case arith::CmpIPredicate::eq:
+    case arith::CmpIPredicate::ne: {
+      bool isEq = predicate == arith::CmpIPredicate::eq;
+      if (lhs.getConstantValue() &&
+          lhs.getConstantValue() == rhs.getConstantValue())
+        return isEq;
+      if (less(/*strict=*/true) || greater(/*strict=*/true))
+        return !isEq;
+      break;
+    }
+    case arith::CmpIPredicate::slt:
+    case arith::CmpIPredicate::ult:
+      if (less(/*strict=*/true))
+        return true;
+      if (greater(/*strict=*/false))
+        return false;
+      break;
+    case arith::CmpIPredicate::sle:
+    case arith::CmpIPredicate::ule:
+      if (less(/*strict=*/false))
+        return true;
+      if (greater(/*strict=*/true))
+        return false;
+      break;
+    case arith::CmpIPredicate::sgt:
+    case arith::CmpIPredicate::ugt:
+      if (greater(/*strict=*/true))
+        return true;
+      if (less(/*strict=*/false))
+        return false;
+      break;
+    case arith::CmpIPredicate::sge:
+    case arith::CmpIPredicate::uge:
+      if (greater(/*strict=*/false))
+        return true;
+      if (less(/*strict=*/true))
+        return false;
+      break;
+    }
+    return std::nullopt;
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// RangeInfoAnalysis
+//===----------------------------------------------------------------------===//
+
+RangeInfoAnalysis::RangeInfoAnalysis(DataFlowSolver &solver,
+                                     ModuleAxisInfoAnalysis &axisInfoAnalysis)
+    : dataflow::SparseForwardDataFlowAnalysis<RangeLattice>(solver),
+      axisInfoAnalysis(axisInfoAnalysis) {
+  visitors.append<ConstantOpRangeInfoVisitor>();
+  visitors.append<MakeRangeOpRangeInfoVisitor, ProgramIdOpRangeInfoVisitor,
+                  NumProgramsOpRangeInfoVisitor>();
+  visitors.append<ShapeOpRangeInfoVisitor<triton::SplatOp>,
+                  ShapeOpRangeInfoVisitor<triton::BroadcastOp>,
+                  ShapeOpRangeInfoVisitor<triton::ExpandDimsOp>,
+                  ShapeOpRangeInfoVisitor<triton::ReshapeOp>,
+                  ShapeOpRangeInfoVisitor<triton::TransOp>,
+                  ShapeOpRangeInfoVisitor<triton::gpu::ConvertLayoutOp>>();
+  visitors.append<IntCastOpRangeInfoVisitor<arith::ExtSIOp>,
+                  IntCastOpRangeInfoVisitor<arith::ExtUIOp>,
+                  IntCastOpRangeInfoVisitor<arith::TruncIOp>,
+                  IntCastOpRangeInfoVisitor<arith::IndexCastOp>>();
+  visitors.append<AddSubOpRangeInfoVisitor<arith::AddIOp>,
+                  AddSubOpRangeInfoVisitor<arith::SubIOp>>();
+  visitors.append<MulIOpRangeInfoVisitor>();
+  visitors.append<DivOpRangeInfoVisitor<arith::DivSIOp>,
+                  DivOpRangeInfoVisitor<arith::DivUIOp>>();
+  visitors.append<RemOpRangeInfoVisitor<arith::RemSIOp>,
+                  RemOpRangeInfoVisitor<arith::RemUIOp>>();
+  visitors.append<MaxMinOpRangeInfoVisitor<arith::MaxSIOp>,
+                  MaxMinOpRangeInfoVisitor<arith::MaxUIOp>,
+                  MaxMinOpRangeInfoVisitor<arith::MinSIOp>,
+                  MaxMinOpRangeInfoVisitor<arith::MinUIOp>>();
+  visitors.append<LogicalOpRangeInfoVisitor<arith::AndIOp>,
+                  LogicalOpRangeInfoVisitor<arith::OrIOp>>();
+  visitors.append<SelectOpRangeInfoVisitor>();
+  visitors.append<CmpIOpRangeInfoVisitor>();
+}
+
+void RangeInfoAnalysis::visitOperation(Operation *op,
+                                       ArrayRef<const RangeLattice *> operands,
+                                       ArrayRef<RangeLattice *> results) {
+  RangeInfoVisitor *visitor = visitors.lookup(op);
+  if (!visitor || op->getNumResults() != 1 ||
+      !RangeInfo::getBitWidth(op->getResult(0).getType()))
+    return setAllToEntryStates(results);
+  // Wait until the integer operands are known. The joins widen the ranges
+  // that grow, so visiting with partial information would lose precision.
+  for (auto [operand, lattice] : llvm::zip(op->getOperands(), operands))
+    if (RangeInfo::getBitWidth(operand.getType()) &&
+        lattice->getValue().isUninitialized())
+      return;
+  RangeInfo curr = visitor->getRangeInfo(op, operands);
+  if (curr.isUninitialized())
+    return setAllToEntryStates(results);
+  curr = tighten(op, curr);
+  propagateIfChanged(results[0], results[0]->join(curr));
+}
+
+RangeInfo RangeInfoAnalysis::tighten(Operation *op, const RangeInfo &info) {
+  int64_t min = info.getMin();
+  int64_t max = info.getMax();
+  if (auto lower = info.getLower()) {
+    const RangeInfo &base = getLatticeElementFor(op, lower->base)->getValue();
+    if (!base.isUninitialized())
+      if (auto baseMin = llvm::checkedAdd(base.getMin(), lower->offset))
+        min = std::clamp(*baseMin, min, max);
+  }
+  if (auto upper = info.getUpper()) {
+    const RangeInfo &base = getLatticeElementFor(op, upper->base)->getValue();
+    if (!base.isUninitialized())
+      if (auto baseMax = llvm::checkedAdd(base.getMax(), upper->offset))
+        max = std::clamp(*baseMax, min, max);
+  }
+  return RangeInfo(info.getBitWidth(), min, max, info.getLower(),
+                   info.getUpper());
+}
+
+void RangeInfoAnalysis::visitForOpInductionVar(
+    scf::ForOp op, ArrayRef<RangeLattice *> argLattices) {
+  const RangeInfo &lb = getLatticeElementFor(op, op.getLowerBound())->getValue();
+  const RangeInfo &ub = getLatticeElementFor(op, op.getUpperBound())->getValue();
+  if (lb.isUninitialized() || ub.isUninitialized())
+    return;
+
+  // If the bounds and the step are multiples of d, so is the induction
+  // variable, which is then at most ub - d.
+  auto getDivisibility = [&](Value value) -> int64_t {
+    auto *axisInfo = axisInfoAnalysis.getAxisInfo(value);
+    if (!axisInfo || axisInfo->getRank() == 0)
+      return 1;
+    return axisInfo->getDivisibility(0);
+  };
+  int64_t divisor = std::gcd(getDivisibility(op.getLowerBound()),
+                             std::gcd(getDivisibility(op.getStep()),
+                                      getDivisibility(op.getUpperBound())));
+  divisor = std::max<int64_t>(divisor, 1);
+
+  int64_t min = lb.getMin();
+  int64_t max =
+      std::max(llvm::checkedSub(ub.getMax(), divisor).value_or(min), min);
+  RangeInfo inductionVar(
+      lb.getBitWidth(), min, max, getLowerBound(op.getLowerBound(), lb),
+      addOffset(getUpperBound(op.getUpperBound(), ub), negate(divisor)));
+  propagateIfChanged(argLattices[0], argLattices[0]->join(inductionVar));
+}
+
+} // anonymous namespace
+
+//===----------------------------------------------------------------------===//
+// RangeInfo
+//===----------------------------------------------------------------------===//
+
+/*static*/ int64_t RangeInfo::getTypeMin(unsigned bitWidth) {
+  return bitWidth == 1 ? 0 : APInt::getSignedMinValue(bitWidth).getSExtValue();
+}
+
+/*static*/ int64_t RangeInfo::getTypeMax(unsigned bitWidth) {
+  return bitWidth == 1 ? 1 : APInt::getSignedMaxValue(bitWidth).getSExtValue();
+}
+
+/*static*/ unsigned RangeInfo::getBitWidth(Type type) {
+  Type elemTy = getElementTypeOrSelf(type);
+  if (elemTy.isIndex())
+    return IndexType::kInternalStorageBitWidth;
+  if (auto intTy = dyn_cast<IntegerType>(elemTy))
+    return intTy.getWidth() <= 64 ? intTy.getWidth() : 0;
+  return 0;
+}
+
+/*static*/ RangeInfo RangeInfo::getPessimisticValueState(Value value) {
+  unsigned bitWidth = getBitWidth(value.getType());
+  if (!bitWidth)
+    return RangeInfo();
+  return getMaxRange(bitWidth);
+}
+
+/*static*/ RangeInfo RangeInfo::join(const RangeInfo &lhs,
+                                     const RangeInfo &rhs) {
+  // If one argument is not initialized, return the other.
+  if (lhs.isUninitialized())
+    return rhs;
+  if (rhs.isUninitialized())
+    return lhs;
+  unsigned bitWidth = lhs.getBitWidth();
+  int64_t min = rhs.getMin() < lhs.getMin() ? getTypeMin(bitWidth)
+                                            : lhs.getMin();
+  int64_t max = rhs.getMax() > lhs.getMax() ? getTypeMax(bitWidth)
+                                            : lhs.getMax();
+  auto lower = lhs.getLower();
+  if (!lower || !rhs.getLower() || rhs.getLower()->base != lower->base ||
+      rhs.getLower()->offset < lower->offset)
+    lower = std::nullopt;
+  auto upper = lhs.getUpper();
+  if (!upper || !rhs.getUpper() || rhs.getUpper()->base != upper->base ||
+      rhs.getUpper()->offset > upper->offset)
+    upper = std::nullopt;
+  return RangeInfo(bitWidth, min, max, lower, upper);
+}
+
+//===----------------------------------------------------------------------===//
+// ModuleRangeInfoAnalysis
+//===----------------------------------------------------------------------===//
+
+ModuleRangeInfoAnalysis::ModuleRangeInfoAnalysis(
+    ModuleOp moduleOp, ModuleAxisInfoAnalysis &axisInfoAnalysis)
+    : CallGraph<RangeInfoMapT>(moduleOp) {
+  SmallVector<FunctionOpInterface> funcs;
+  walk<WalkOrder::PreOrder, WalkOrder::PostOrder>(
+      // Pre-order edge walk callback
+      [](CallOpInterface callOp, FunctionOpInterface funcOp) {},
+      // Post-order node walk callback
+      [&](FunctionOpInterface funcOp) {
+        funcs.push_back(funcOp);
+        funcMap.try_emplace(funcOp, RangeInfoMapT{});
+      });
+  for (auto funcOp : funcs)
+    initialize(funcOp, axisInfoAnalysis);
+}
+
+std::optional<bool> ModuleRangeInfoAnalysis::getConstantCondition(Value value) {
+  auto *rangeInfo = getRangeInfo(value);
+  if (!rangeInfo || rangeInfo->getBitWidth() != 1)
+    return std::nullopt;
+  if (auto constantValue = rangeInfo->getConstantValue())
+    return *constantValue != 0;
+  return std::nullopt;
+}
+
+void ModuleRangeInfoAnalysis::initialize(
+    FunctionOpInterface funcOp, ModuleAxisInfoAnalysis &axisInfoAnalysis) {
+  std::unique_ptr<DataFlowSolver> solver = createDataFlowSolver();
+  RangeInfoAnalysis *analysis =
+      solver->load<RangeInfoAnalysis>(axisInfoAnalysis);
+  if (failed(solver->initializeAndRun(funcOp)))
+    return;
+  auto *rangeInfoMap = getFuncData(funcOp);
+  auto updateRangeInfoMap = [&](Value value) {
+    auto rangeInfo = analysis->getLatticeElement(value)->getValue();
+    if (!rangeInfo.isUninitialized())
+      (*rangeInfoMap)[value] = rangeInfo;
+  };
+  funcOp.walk([&](Operation *op) {
+    for (auto value : op->getResults()) {
+      updateRangeInfoMap(value);
+    }
+  });
+  funcOp.walk([&](Block *block) {
+    for (auto value : block->getArguments()) {
+      updateRangeInfoMap(value);
+    }
+  });
+  LLVM_DEBUG({
+    for (auto &[value, rangeInfo] : *rangeInfoMap) {
+      std::string str;
+      llvm::raw_string_ostream os(str);
+      value.printAsOperand(os, OpPrintingFlags());
+      os << " => ";
+      rangeInfo.print(os);
+      LDBG(str);
+    }
+  });
+}
+
+} // namespace mlir::triton
@@ -1,5 +1,6 @@
 #include "triton/Analysis/Utility.h"
 
+#include <array>
 #include <deque>
 
 #include "mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"
@@ -17,6 +18,7 @@
 #include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
 #include "triton/Tools/LinearLayout.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
+#include "llvm/Support/MathExtras.h"
 
 namespace mlir {
 namespace {
@@ -172,6 +174,20 @@ bool ReduceOpHelper::isWarpSynchronous() {
   return getWarpsPerCTAWithUniqueData(srcLayout, srcShape)[axis] == 1;
 }
 
+bool ReduceOpHelper::isInterWarpReduceInRegisters() {
+  if (isWarpSynchronous())
+    return false;
+  // Each thread loads the partial reduction of every warp along the axis for
+  // each of its result elements, which must fit in one register per lane of a
+  // warp.
+  unsigned numResultElems = 1;
+  if (auto resultTy = dyn_cast<RankedTensorType>(op.getResult()[0].getType()))
+    numResultElems = getTotalElemsPerThread(resultTy);
+  auto mod = op->getParentOfType<ModuleOp>();
+  unsigned threadsPerWarp = TritonGPUDialect::getThreadsPerWarp(mod);
+  return getInterWarpSizeWithUniqueData() * numResultElems <= threadsPerWarp;
+}
+
 SmallVector<unsigned> ReduceOpHelper::getScratchConfig() {
   SmallVector<unsigned> smemShape;
   // that case doesn't need inter-warp communication
@@ -292,15 +308,95 @@ unsigned ScanLoweringHelper::getNonAxisNumBlocks() {
   return numBlocks;
 }
 
+// Return the axis bits that the lanes and the warps of the linear layout of
+// `encoding` cover, or std::nullopt if some basis of the layout moves along the
+// axis and another dim at once, if two bases cover the same axis bit or if the
+// axis is split across CTAs.
+static std::optional<std::pair<int32_t, int32_t>>
+getLaneAndWarpAxisBits(ArrayRef<int64_t> shape, Attribute encoding,
+                       unsigned axis) {
+  std::optional<LinearLayout> layout = toLinearLayout(shape, encoding);
+  if (!layout.has_value())
+    return std::nullopt;
+  MLIRContext *ctx = encoding.getContext();
+  StringAttr kLane = StringAttr::get(ctx, "lane");
+  StringAttr kWarp = StringAttr::get(ctx, "warp");
+  StringAttr kBlock = StringAttr::get(ctx, "block");
+  int32_t axisDim =
+      layout->getOutDimIndex(StringAttr::get(ctx, "dim" + Twine(axis)));
+  int32_t seenBits = 0;
+  int32_t laneBits = 0;
+  int32_t warpBits = 0;
+  for (const auto &[inDim, bases] : layout->getBases()) {
+    for (const std::vector<int32_t> &basis : bases) {
+      int32_t axisBit = basis[axisDim];
+      if (axisBit == 0)
+        continue;
+      for (int32_t dim = 0; dim < basis.size(); dim++) {
+        if (dim != axisDim && basis[dim] != 0)
+          return std::nullopt;
+      }
+      if (!llvm::isPowerOf2_32(axisBit) || (seenBits & axisBit) ||
+          inDim == kBlock)
+        return std::nullopt;
+      seenBits |= axisBit;
+      if (inDim == kLane)
+        laneBits |= axisBit;
+      else if (inDim == kWarp)
+        warpBits |= axisBit;
+    }
+  }
+  return std::make_pair(laneBits, warpBits);
+}
+
+// Return the axis bits that the warps of the linear layout of `encoding` cover,
+// or std::nullopt if the layout is not supported by getLaneAndWarpAxisBits or
+// if a lane covers an axis bit above a warp.
+static std::optional<int32_t> getScanWarpAxisBits(ArrayRef<int64_t> shape,
+                                                  Attribute encoding,
+                                                  unsigned axis) {
+  auto axisBits = getLaneAndWarpAxisBits(shape, encoding, axis);
+  if (!axisBits.has_value())
+    return std::nullopt;
+  auto [laneBits, warpBits] = *axisBits;
+  if (warpBits != 0 && laneBits >= (warpBits & -warpBits))
+    return std::nullopt;
+  return warpBits;
+}
+
+bool ScanLoweringHelper::isSupportedLayout(ArrayRef<int64_t> shape,
+                                           Attribute encoding, unsigned axis) {
+  if (isa<BlockedEncodingAttr>(encoding))
+    return true;
+  return getScanWarpAxisBits(shape, encoding, axis).has_value();
+}
+
 bool ScanLoweringHelper::isSupported() {
-  // TODO: Support the following cases:
-  // 1. Scan on non-blocking encodings
-  if (!isa<BlockedEncodingAttr>(getEncoding()))
-    return false;
-  return true;
+  return isSupportedLayout(getShape(), srcEncoding, getAxis());
+}
+
+bool ScanLoweringHelper::isLinearLayoutLowering() {
+  return !isa<BlockedEncodingAttr>(srcEncoding);
+}
+
+unsigned ScanLoweringHelper::getAxisTileSizeLog2() {
+  int32_t warpBits = *getScanWarpAxisBits(getShape(), srcEncoding, getAxis());
+  if (warpBits == 0)
+    return llvm::Log2_32(getShape()[getAxis()]);
+  return llvm::countr_zero<uint32_t>(warpBits);
+}
+
+unsigned ScanLoweringHelper::getAxisNumTiles() {
+  return getShape()[getAxis()] >> getAxisTileSizeLog2();
 }
 
 unsigned ScanLoweringHelper::getScratchSizeInElems() {
+  if (isLinearLayoutLowering()) {
+    // One partial result per tile for each set of independent scans.
+    unsigned numNonAxisElements =
+        product<int64_t>(getShape()) / getShape()[getAxis()];
+    return numNonAxisElements * getAxisNumTiles();
+  }
   auto mod = scanOp->getParentOfType<ModuleOp>();
   unsigned numWarps = TritonGPUDialect::getNumWarps(mod);
   unsigned numNonAxisElementsPerWarp =
@@ -311,8 +407,8 @@ unsigned ScanLoweringHelper::getScratchSizeInElems() {
 }
 
 unsigned ScanLoweringHelper::getScratchSizeInBytes() {
-  unsigned axisNumWarps = getAxisNumWarpsWithUniqueData();
-  if (axisNumWarps == 1)
+  if (isLinearLayoutLowering() ? getAxisNumTiles() == 1
+                               : getAxisNumWarpsWithUniqueData() == 1)
     return 0;
   unsigned elementSizeInBytes = 0;
   for (const auto &ty : srcElementTypes) {
@@ -321,6 +417,77 @@ unsigned ScanLoweringHelper::getScratchSizeInBytes() {
   return elementSizeInBytes * getScratchSizeInElems();
 }
 
+bool SortOpHelper::isSupportedLayout(ArrayRef<int64_t> shape,
+                                     Attribute encoding, unsigned axis) {
+  return getLaneAndWarpAxisBits(shape, encoding, axis).has_value();
+}
+
+bool SortOpHelper::isSupported() {
+  auto srcTy = sortOp.getInputTypes()[0];
+  return isSupportedLayout(srcTy.getShape(), srcTy.getEncoding(),
+                           sortOp.getAxis());
+}
+
+bool SortOpHelper::hasWarpExchanges() {
+  auto srcTy = sortOp.getInputTypes()[0];
+  auto axisBits = getLaneAndWarpAxisBits(srcTy.getShape(), srcTy.getEncoding(),
+                                         sortOp.getAxis());
+  return axisBits.has_value() && axisBits->second != 0;
+}
+
+bool SortOpHelper::isTopK() {
+  auto k = sortOp.getK();
+  return k.has_value() &&
+         *k < sortOp.getInputTypes()[0].getShape()[sortOp.getAxis()];
+}
+
+unsigned SortOpHelper::getScratchSizeInElems() {
+  return product<int64_t>(sortOp.getInputTypes()[0].getShape());
+}
+
+unsigned SortOpHelper::getScratchSizeInBytes() {
+  if (!hasWarpExchanges() && !isTopK())
+    return 0;
+  unsigned elementSizeInBytes = 0;
+  for (const auto &ty : sortOp.getElementTypes()) {
+    elementSizeInBytes += ceil<unsigned>(ty.getIntOrFloatBitWidth(), 8);
+  }
+  return elementSizeInBytes * getScratchSizeInElems();
+}
+
+unsigned HistogramOpHelper::getNumBins() {
+  auto mod = histogramOp->getParentOfType<ModuleOp>();
+  unsigned threadsPerWarp = TritonGPUDialect::getThreadsPerWarp(mod);
+  return std::max<unsigned>(histogramOp.getType().getNumElements(),
+                            threadsPerWarp);
+}
+
+bool HistogramOpHelper::isSharedMemoryLowering() {
+  // The ballot lowering popcounts every bin owned by a lane for each element,
+  // past a few bins per lane a shared memory atomic per element is cheaper.
+  const unsigned kMaxBallotBinsPerLane = 8;
+  auto mod = histogramOp->getParentOfType<ModuleOp>();
+  unsigned threadsPerWarp = TritonGPUDialect::getThreadsPerWarp(mod);
+  return getNumBins() > kMaxBallotBinsPerLane * threadsPerWarp;
+}
+
+unsigned HistogramOpHelper::getNumCopies() {
+  if (!isSharedMemoryLowering())
+    return 1;
+  // Privatizing the counters per warp removes the contention between warps,
+  // as long as the copies stay small enough not to limit the occupancy.
+  const unsigned kMaxPrivatizedBytes = 32 * 1024;
+  auto mod = histogramOp->getParentOfType<ModuleOp>();
+  unsigned numWarps = TritonGPUDialect::getNumWarps(mod);
+  unsigned copyBytes = getNumBins() * sizeof(int32_t);
+  return numWarps * copyBytes <= kMaxPrivatizedBytes ? numWarps : 1;
+}
+
+unsigned HistogramOpHelper::getScratchSizeInBytes() {
+  // The counters are 32 bits wide, whatever the type of the result.
+  return getNumCopies() * getNumBins() * sizeof(int32_t);
+}
+
 SmallVector<std::pair<SmallVector<int64_t>, SmallVector<int64_t>>>
 getReshapeDecomposition(ArrayRef<int64_t> srcShape,
                         ArrayRef<int64_t> dstShape) {
@@ -579,40 +746,234 @@ bool matchMmaV3AndDotOperandLayout(RankedTensorType srcTy,
   return ans;
 }
 
+bool cvtReordersRegisters(RankedTensorType srcTy, RankedTensorType dstTy) {
+  MLIRContext *ctx = srcTy.getContext();
+  // comp describes the layout function for converting from src to dst.
+  std::optional<LinearLayout> comp = toLinearLayoutConversion(
+      srcTy.getShape(), srcTy.getEncoding(), dstTy.getEncoding());
+  if (!comp.has_value())
+    return false;
+  StringAttr kLane = StringAttr::get(ctx, "lane");
+  StringAttr kWarp = StringAttr::get(ctx, "warp");
+  StringAttr kBlock = StringAttr::get(ctx, "block");
+  return comp
+      ->divideRight(
+          LinearLayout::identity1D(comp->getInDimSize(kLane), kLane, kLane) *
+          LinearLayout::identity1D(comp->getInDimSize(kWarp), kWarp, kWarp) *
+          LinearLayout::identity1D(comp->getInDimSize(kBlock), kBlock, kBlock))
+      .has_value();
+}
+
 bool cvtNeedsSharedMemory(RankedTensorType srcTy, RankedTensorType dstTy) {
+  // No communication between threads: the conversion only reorders registers.
+  if (cvtReordersRegisters(srcTy, dstTy))
+    return false;
+  // Communication between the threads of a warp only: the conversion is done
+  // with warp shuffles, unless the pattern is too complicated for them.
+  if (getWarpShuffleSchedule(srcTy, dstTy).has_value())
+    return false;
+
+  // TODO(jlebar): Remove these special cases once they're fully subsumed by the
+  // linear-layout check above.
+  return !isMmaToMmaShortcut(srcTy, dstTy) &&
+         !isMmaToDotShortcut(srcTy, dstTy) &&
+         !isMfmaToDotShortcut(srcTy, dstTy);
+}
+
+namespace {
+
+// A linear map over GF(2), built from pairs (x, f(x)).  The pairs are kept in
+// row echelon form on x, packed into one word as (x << 32) | f(x) so that
+// eliminating on x carries f(x) along.
+class GF2LinearMap {
+public:
+  // Adds x -> y.  Returns false and leaves the map unchanged if x is a
+  // combination of the inputs added so far.
+  bool add(int32_t x, int32_t y) {
+    uint64_t row = reduce((uint64_t(uint32_t(x)) << 32) | uint32_t(y));
+    if ((row >> 32) == 0)
+      return false;
+    rows[llvm::Log2_64(row) - 32] = row;
+    ++rank;
+    return true;
+  }
+
+  // Returns f(x).  x must be a combination of the inputs added so far.
+  int32_t apply(int32_t x) const {
+    uint64_t row = reduce(uint64_t(uint32_t(x)) << 32);
+    assert((row >> 32) == 0 && "x is not in the domain of the map");
+    return static_cast<int32_t>(row);
+  }
+
+  int getRank() const { return rank; }
+
+private:
+  uint64_t reduce(uint64_t row) const {
+    for (int pivot = 31; pivot >= 0; --pivot) {
+      if ((row >> (pivot + 32)) & 1)
+        row ^= rows[pivot];
+    }
+    return row;
+  }
+
+  // rows[i] is the row whose leading bit is bit i of x, or 0.
+  std::array<uint64_t, 32> rows = {};
+  int rank = 0;
+};
+
+// Applies the linear function with the given values at the powers of two.
+int32_t applyBases(ArrayRef<int32_t> bases, int32_t x) {
+  int32_t ret = 0;
+  for (auto [i, basis] : llvm::enumerate(bases)) {
+    if (x & (1 << i))
+      ret ^= basis;
+  }
+  return ret;
+}
+
+} // namespace
+
+std::optional<WarpShuffleSchedule>
+getWarpShuffleSchedule(RankedTensorType srcTy, RankedTensorType dstTy) {
+  // Each lane picks the source register it supplies and the destination
+  // register it receives with a chain of selects, so we bound their fan-in.
+  constexpr int kMaxSelectBits = 2;
+
   MLIRContext *ctx = srcTy.getContext();
   std::optional<LinearLayout> srcLayout =
       toLinearLayout(srcTy.getShape(), srcTy.getEncoding());
   std::optional<LinearLayout> dstLayout =
       toLinearLayout(dstTy.getShape(), dstTy.getEncoding());
-  if (srcLayout.has_value() && dstLayout.has_value()) {
-    // comp describes the layout function for converting from src to dst.
-    LinearLayout comp = srcLayout->invertAndCompose(*dstLayout);
-    StringAttr kLane = StringAttr::get(ctx, "lane");
-    StringAttr kWarp = StringAttr::get(ctx, "warp");
-    StringAttr kBlock = StringAttr::get(ctx, "block");
-    // In principle, there's no need for shared memory if there's no
-    // communication between warps.  However, right now we only have implemented
-    // the shortcut case where there's no communication between *threads*.
-    //
-    // TODO(jlebar): Remove the kLane layout once we add support for
-    // shuffle-based layout conversions in ConvertLayoutToLLVM.
-    if (comp.divideRight(LinearLayout::identity1D(comp.getInDimSize(kLane),
-                                                  kLane, kLane) *
-                         LinearLayout::identity1D(comp.getInDimSize(kWarp),
-                                                  kWarp, kWarp) *
-                         LinearLayout::identity1D(comp.getInDimSize(kBlock),
-                                                  kBlock, kBlock))
-            .has_value()) {
-      return false;
-    }
+  if (!srcLayout.has_value() || !dstLayout.has_value())
+    return std::nullopt;
+
+  StringAttr kRegister = StringAttr::get(ctx, "register");
+  StringAttr kLane = StringAttr::get(ctx, "lane");
+  StringAttr kWarp = StringAttr::get(ctx, "warp");
+  StringAttr kBlock = StringAttr::get(ctx, "block");
+
+  // comp maps each (register, lane, warp, block) of dst to one of src which
+  // holds the same element.  Going from dst to src (rather than the other way
+  // around as in cvtNeedsSharedMemory) fills every copy of a value that dst
+  // broadcasts.
+  LinearLayout comp = *toLinearLayoutConversion(
+      dstTy.getShape(), dstTy.getEncoding(), srcTy.getEncoding());
+  std::optional<LinearLayout> warpLocal = comp.divideRight(
+      LinearLayout::identity1D(comp.getInDimSize(kWarp), kWarp, kWarp) *
+      LinearLayout::identity1D(comp.getInDimSize(kBlock), kBlock, kBlock));
+  if (!warpLocal.has_value())
+    return std::nullopt;
+
+  int numRegBits = dstLayout->getInDimSizeLog2(kRegister);
+  int numLaneBits = dstLayout->getInDimSizeLog2(kLane);
+  if (srcLayout->getInDimSizeLog2(kLane) != numLaneBits)
+    return std::nullopt;
+  // divideRight drops the dimensions of size 1, which map to 0.
+  auto getBases = [&](StringAttr inDim, StringAttr outDim, int numBits) {
+    SmallVector<int32_t> ret(numBits, 0);
+    if (!warpLocal->hasInDim(inDim) || !warpLocal->hasOutDim(outDim))
+      return ret;
+    for (int i = 0; i < numBits; i++)
+      ret[i] = warpLocal->getBasis(inDim, i, outDim);
+    return ret;
+  };
+  SmallVector<int32_t> regToReg = getBases(kRegister, kRegister, numRegBits);
+  SmallVector<int32_t> regToLane = getBases(kRegister, kLane, numRegBits);
+  SmallVector<int32_t> laneToReg = getBases(kLane, kRegister, numLaneBits);
+  SmallVector<int32_t> laneToLane = getBases(kLane, kLane, numLaneBits);
+
+  // In a round, the lanes that read the same source lane must also read the
+  // same source register from it.  Find the sets of lanes that read the same
+  // source lane, i.e. the kernel of laneToLane, and among those the directions
+  // which would read a different register ("conflicts").
+  GF2LinearMap srcLaneOf;
+  SmallVector<int32_t> kernel;
+  for (int b = 0; b < numLaneBits; b++) {
+    if (!srcLaneOf.add(laneToLane[b], 1 << b))
+      kernel.push_back((1 << b) ^ srcLaneOf.apply(laneToLane[b]));
+  }
+  GF2LinearMap srcRegOfKernel;
+  SmallVector<int32_t> conflicts;
+  SmallVector<int32_t> broadcasts;
+  for (int32_t k : kernel) {
+    int32_t reg = applyBases(laneToReg, k);
+    if (srcRegOfKernel.add(reg, k))
+      conflicts.push_back(k);
+    else
+      broadcasts.push_back(k ^ srcRegOfKernel.apply(reg));
+  }
+  if (static_cast<int>(conflicts.size()) > kMaxSelectBits)
+    return std::nullopt;
+
+  // Resolve each conflict by having the lanes that differ in it receive
+  // different destination registers in the same round, picking registers that
+  // come from source lanes no other lane direction reaches.
+  GF2LinearMap srcLaneSpan;
+  for (int32_t lane : laneToLane)
+    srcLaneSpan.add(lane, 0);
+  GF2LinearMap laneToDst;
+  int reg = 0;
+  for (int32_t k : conflicts) {
+    while (reg < numRegBits && !srcLaneSpan.add(regToLane[reg], 0))
+      reg++;
+    if (reg == numRegBits)
+      return std::nullopt;
+    laneToDst.add(k, 1 << reg++);
+  }
+  for (int32_t k : broadcasts)
+    laneToDst.add(k, 0);
+  for (int b = 0; b < numLaneBits; b++)
+    laneToDst.add(1 << b, 0);
+
+  WarpShuffleSchedule schedule;
+  schedule.numRegisters = 1 << numRegBits;
+  schedule.numLanes = 1 << numLaneBits;
+  // Now each source lane is read for a single source register per round, which
+  // is a linear function of the lane.
+  GF2LinearMap supply;
+  for (int b = 0; b < numLaneBits; b++) {
+    int32_t dst = laneToDst.apply(1 << b);
+    int32_t srcLane = laneToLane[b] ^ applyBases(regToLane, dst);
+    int32_t srcReg = laneToReg[b] ^ applyBases(regToReg, dst);
+    schedule.laneToDstRegister.push_back(dst);
+    schedule.laneToSrcLane.push_back(srcLane);
+    bool added = supply.add(srcLane, srcReg);
+    assert((added || supply.apply(srcLane) == srcReg) &&
+           "lanes reading the same source lane need different registers");
+    (void)added;
+  }
+  for (int b = 0; b < numLaneBits; b++)
+    supply.add(1 << b, 0);
+  GF2LinearMap supplyRank;
+  for (int b = 0; b < numLaneBits; b++) {
+    schedule.laneToSrcRegister.push_back(supply.apply(1 << b));
+    supplyRank.add(schedule.laneToSrcRegister.back(), 0);
+  }
+  if (supplyRank.getRank() > kMaxSelectBits)
+    return std::nullopt;
+  for (int i = 0; i < numRegBits; i++) {
+    schedule.roundToSrcLane.push_back(regToLane[i]);
+    schedule.roundToSrcRegister.push_back(
+        regToReg[i] ^ applyBases(schedule.laneToSrcRegister, regToLane[i]));
   }
 
-  // TODO(jlebar): Remove these special cases once they're fully subsumed by the
-  // linear-layout check above.
-  return !isMmaToMmaShortcut(srcTy, dstTy) &&
-         !isMmaToDotShortcut(srcTy, dstTy) &&
-         !isMfmaToDotShortcut(srcTy, dstTy);
+  // Source lanes which only differ in lane bits that src broadcasts hold the
+  // same values.  If they also supply the same register, read those bits of the
+  // source lane from the lane itself, so that more rounds stay within a lane.
+  int32_t broadcastLanes = 0;
+  for (int b = 0; b < numLaneBits; b++) {
+    if (llvm::all_of(srcLayout->getBasis(kLane, b),
+                     [](int32_t x) { return x == 0; }) &&
+        schedule.laneToSrcRegister[b] == 0)
+      broadcastLanes |= 1 << b;
+  }
+  for (int b = 0; b < numLaneBits; b++) {
+    schedule.laneToSrcLane[b] = (schedule.laneToSrcLane[b] & ~broadcastLanes) |
+                                ((1 << b) & broadcastLanes);
+  }
+  for (int32_t &lane : schedule.roundToSrcLane)
+    lane &= ~broadcastLanes;
+  return schedule;
 }
 
 bool isMmaToDotShortcut(RankedTensorType srcTy, RankedTensorType dstTy) {
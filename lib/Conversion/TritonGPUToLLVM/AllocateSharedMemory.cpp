@@ -1,5 +1,6 @@
 #include "mlir/Pass/Pass.h"
 #include "triton/Analysis/Allocation.h"
+#include "triton/Analysis/AxisInfo.h"
 #include "triton/Analysis/Utility.h"
 #include "triton/Conversion/TritonGPUToLLVM/Passes.h"
 #include "triton/Dialect/Triton/IR/Dialect.h"
@@ -23,7 +24,32 @@ struct AllocateSharedMemory
   void runOnOperation() override {
     ModuleOp mod = getOperation();
     MLIRContext *ctx = &getContext();
-    ModuleAllocation allocation(mod);
+    // Without an explicit allocator, the policy selected by the module is
+    // used and the module is left untouched.
+    AllocationPolicy policy = getAllocationPolicy(mod);
+    if (allocator.hasValue()) {
+      StringRef allocatorName = allocator.getValue();
+      auto explicitPolicy = parseAllocationPolicy(allocatorName);
+      if (!explicitPolicy) {
+        mod.emitError("unknown shared memory allocator: ") << allocatorName;
+        return signalPassFailure();
+      }
+      policy = *explicitPolicy;
+      // Record the policy so that later analyses computing the allocation
+      // again agree with the offsets set here. The default policy only needs
+      // to be recorded to override the one selected by the module.
+      if (policy != AllocationPolicy::Bumping ||
+          mod->hasAttr("triton_gpu.shared-allocator"))
+        mod->setAttr("triton_gpu.shared-allocator",
+                     StringAttr::get(ctx, allocatorName));
+    }
+    // Choose the scratch buffers of layout conversions once, the allocation
+    // and the lowerings read the choice back from the ops. The expected bank
+    // conflicts are recorded too, so that they can be audited.
+    mod.walk([&](triton::gpu::ConvertLayoutOp cvt) {
+      recordScratchConfigForCvtLayout(cvt);
+    });
+    ModuleAllocation allocation(mod, policy);
 
     mod.walk([&](FunctionOpInterface funcOp) {
       funcOp.walk([&](Operation *op) {
@@ -47,6 +73,8 @@ struct AllocateSharedMemory
     mod->setAttr("triton_gpu.shared",
                  mlir::IntegerAttr::get(mlir::IntegerType::get(ctx, 32),
                                         allocation.getSharedMemorySize()));
+    // Only attributes are set, the values are left untouched.
+    markAnalysesPreserved<ModuleAxisInfoAnalysis>();
   }
 };
 
@@ -309,8 +309,10 @@ struct ConvertLayoutOpUsingLinearLayoutsConversion
   // Set benefit to 2 so that this pattern applies before other convert-layout
   // conversions.  TODO(jlebar): Eventually we want this to be the only pattern.
   explicit ConvertLayoutOpUsingLinearLayoutsConversion(
-      LLVMTypeConverter &typeConverter, PatternBenefit benefit = 2)
-      : ConvertOpToLLVMPattern(typeConverter, benefit) {}
+      LLVMTypeConverter &typeConverter, const TargetInfoBase &targetInfo,
+      PatternBenefit benefit = 2)
+      : ConvertOpToLLVMPattern(typeConverter, benefit), targetInfo(targetInfo) {
+  }
 
   LogicalResult
   matchAndRewrite(ConvertLayoutOp op, OpAdaptor adaptor,
@@ -341,7 +343,8 @@ struct ConvertLayoutOpUsingLinearLayoutsConversion
     // We can tell which case we're in by examining `conversion`.  If e.g. the
     // block -> block mapping is {1, 2, 4, ...} then there's no movement between
     // data in different CTAs and we know we're not in case 4.
-    LinearLayout conversion = srcLayout->invertAndCompose(*dstLayout);
+    LinearLayout conversion = *gpu::toLinearLayoutConversion(
+        shape, op.getSrc().getType().getEncoding(), op.getType().getEncoding());
 
     int numLanes = conversion.getInDimSize(str_attr("lane"));
     int numWarps = conversion.getInDimSize(str_attr("warp"));
@@ -365,11 +368,13 @@ struct ConvertLayoutOpUsingLinearLayoutsConversion
       return transferWithinThread(*c, op, adaptor, rewriter);
     }
 
-    if (std::optional<LinearLayout> c = conversion.divideRight(
-            LinearLayout::identity1D(numWarps, kWarp, kWarp) *
-            LinearLayout::identity1D(numBlocks, kBlock, kBlock));
-        c.has_value()) {
-      return transferWithinLane(*c, op, adaptor, rewriter);
+    // Case 2 is decided by getWarpShuffleSchedule, which cvtNeedsSharedMemory
+    // also uses, so that we never fall back to shared memory without a scratch
+    // buffer.
+    if (std::optional<WarpShuffleSchedule> schedule = getWarpShuffleSchedule(
+            op.getSrc().getType(), op.getType());
+        schedule.has_value()) {
+      return transferWithinLane(*schedule, op, adaptor, rewriter);
     }
 
     if (std::optional<LinearLayout> c = conversion.divideRight(
@@ -407,11 +412,105 @@ struct ConvertLayoutOpUsingLinearLayoutsConversion
     return success();
   }
 
-  LogicalResult transferWithinLane(const LinearLayout &conversion,
+  LogicalResult transferWithinLane(const WarpShuffleSchedule &schedule,
                                    ConvertLayoutOp op, OpAdaptor adaptor,
                                    ConversionPatternRewriter &rewriter) const {
-    // TODO(jlebar): Implement me.
-    return failure();
+    MLIRContext *ctx = op.getContext();
+    auto loc = op.getLoc();
+    StringAttr kRegister = str_attr("register");
+    StringAttr kLane = str_attr("lane");
+
+    assert(!cvtNeedsSharedMemory(op.getSrc().getType(), op.getType()));
+
+    auto inVals = unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    // Shuffles only move integers and floats.
+    bool isPtr = isa<triton::PointerType>(op.getType().getElementType());
+    Type llvmElemTy = inVals[0].getType();
+    if (isPtr) {
+      for (Value &val : inVals)
+        val = ptrtoint(i64_ty, val);
+    }
+
+    // The schedule stores the values of linear functions at the powers of two.
+    auto applyBases = [](ArrayRef<int32_t> bases, int32_t x) {
+      int32_t ret = 0;
+      for (auto [i, basis] : llvm::enumerate(bases)) {
+        if (x & (1 << i))
+          ret ^= basis;
+      }
+      return ret;
+    };
+    Value laneId = urem(getThreadId(rewriter, loc), i32_val(schedule.numLanes));
+    auto applyToLaneId = [&](ArrayRef<int32_t> bases, StringAttr outDim,
+                             int32_t outDimSize) {
+      std::vector<std::vector<int32_t>> laneBases;
+      for (int32_t basis : bases)
+        laneBases.push_back({basis});
+      LinearLayout layout({{kLane, laneBases}}, {{outDim, outDimSize}},
+                          /*requireSurjective=*/false);
+      return applyLinearLayout(loc, rewriter, layout, {{kLane, laneId}})[0]
+          .second;
+    };
+    // Returns vals[base ^ offset], where the runtime value `offset` is in the
+    // span of `offsetBases`.
+    auto selectRegister = [&](ArrayRef<Value> vals, int32_t base, Value offset,
+                              ArrayRef<int32_t> offsetBases) {
+      SmallVector<int32_t> span = {0};
+      for (int32_t basis : offsetBases) {
+        if (llvm::is_contained(span, basis))
+          continue;
+        for (int i = 0, e = span.size(); i < e; i++)
+          span.push_back(span[i] ^ basis);
+      }
+      Value ret = vals[base];
+      for (int32_t o : ArrayRef(span).drop_front())
+        ret = select(icmp_eq(offset, i32_val(o)), vals[base ^ o], ret);
+      return ret;
+    };
+
+    Value srcLaneOffset =
+        applyToLaneId(schedule.laneToSrcLane, kLane, schedule.numLanes);
+    Value supplyOffset =
+        applyToLaneId(schedule.laneToSrcRegister, kRegister, inVals.size());
+    Value dstOffset = applyToLaneId(schedule.laneToDstRegister, kRegister,
+                                    schedule.numRegisters);
+    bool readsOwnLane = llvm::all_of(
+        llvm::enumerate(schedule.laneToSrcLane),
+        [](auto it) { return it.value() == (1 << it.index()); });
+
+    // Rounds that read the same register from the same lanes, e.g. when dst
+    // holds an element in several registers, share one shuffle.
+    DenseMap<std::pair<int32_t, int32_t>, Value> shuffled;
+    SmallVector<Value> received(schedule.numRegisters);
+    for (int r = 0; r < schedule.numRegisters; r++) {
+      int32_t srcLane = applyBases(schedule.roundToSrcLane, r);
+      int32_t srcReg = applyBases(schedule.roundToSrcRegister, r);
+      auto [it, inserted] = shuffled.try_emplace({srcReg, srcLane});
+      if (inserted) {
+        Value val = selectRegister(inVals, srcReg, supplyOffset,
+                                   schedule.laneToSrcRegister);
+        if (srcLane != 0 || !readsOwnLane) {
+          Value lane = srcLaneOffset;
+          if (srcLane != 0)
+            lane = xor_(lane, i32_val(srcLane));
+          val = targetInfo.shuffleIdx(rewriter, loc, val, lane);
+        }
+        it->second = val;
+      }
+      received[r] = it->second;
+    }
+
+    SmallVector<Value> outVals(schedule.numRegisters);
+    for (int r = 0; r < schedule.numRegisters; r++) {
+      outVals[r] = selectRegister(received, r, dstOffset,
+                                  schedule.laneToDstRegister);
+      if (isPtr)
+        outVals[r] = inttoptr(llvmElemTy, outVals[r]);
+    }
+    Value result = packLLElements(loc, getTypeConverter(), outVals, rewriter,
+                                  op.getType());
+    rewriter.replaceOp(op, result);
+    return success();
   }
 
   LogicalResult transferWithinBlock(const LinearLayout &conversion,
@@ -428,6 +527,9 @@ struct ConvertLayoutOpUsingLinearLayoutsConversion
     // TODO(jlebar): Implement me.
     return failure();
   }
+
+private:
+  const TargetInfoBase &targetInfo;
 };
 
 } // namespace
@@ -440,7 +542,7 @@ void mlir::triton::populateConvertLayoutOpToLLVMPatterns(
   // Eventually the LL conversion will subsume all of the others and be the only
   // one left.
   patterns.add<gpu::ConvertLayoutOpUsingLinearLayoutsConversion>(
-      typeConverter, benefit.getBenefit() + 1);
+      typeConverter, targetInfo, benefit.getBenefit() + 1);
   patterns.add<gpu::ConvertLayoutOpConversion>(typeConverter, targetInfo,
                                                benefit);
   patterns.add<gpu::LocalLoadOpConversion>(typeConverter, targetInfo, benefit);
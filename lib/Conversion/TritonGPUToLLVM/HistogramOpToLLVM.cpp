@@ -13,7 +13,8 @@ static int log2Int(int64_t num) { return (num > 1) ? 1 + log2Int(num / 2) : 0; }
 // Create a ballot for each bit of the bin index (there
 // are only log2(num_bins) of these) and then apply bitwise operations to get
 // the indicator functions for the bins owned by this particular thread, and
-// only popcount those.
+// only popcount those. Values out of the bins are not counted, like on the
+// shared memory path.
 static SmallVector<Value> computeWarpLevelHistogram(
     Location loc, RankedTensorType srcType, SmallVector<Value> &srcValues,
     int numBins, int numThreadPerWarp, Value threadId,
@@ -48,6 +49,11 @@ static SmallVector<Value> computeWarpLevelHistogram(
     if (numThreadWithUniqueData < numThreadPerWarp) {
       mask = int_val(numThreadPerWarp, (1ULL << numThreadWithUniqueData) - 1);
     }
+    // The bin index is only made of the low bits of the value, so mask out
+    // the values out of the bins instead of wrapping them around.
+    Value inRange = targetInfo.ballot(rewriter, loc, int_ty(numThreadPerWarp),
+                                      icmp_ult(value, i32_val(numBins)));
+    mask = and_(mask, inRange);
     for (int i = 0; i < numBitsLaneId; i++) {
       Value updateMask = select(icmp_ne(and_(threadId, i32_val(1 << i)), zero),
                                 int_val(numThreadPerWarp, 0), fullMask);
@@ -140,6 +146,64 @@ static SmallVector<Value> computeCrossWarpHistogram(
   return histogramValues;
 }
 
+// Compute the histogram with atomic adds on counters in shared memory. When
+// the counters are privatized, each warp counts into its own copy and the
+// copies are merged while loading the bins owned by each thread.
+static SmallVector<Value> computeSharedMemoryHistogram(
+    Location loc, ConversionPatternRewriter &rewriter, RankedTensorType srcType,
+    Value baseSharedMemPtr, const SmallVector<Value> &srcValues, int numBins,
+    int numCopies, int numThreadPerWarp, const SmallVector<Value> &indices,
+    Value threadId, int numWarps) {
+  SmallVector<Value> histogramValues;
+  unsigned numThreadWithUniqueData =
+      triton::gpu::getThreadsPerWarpWithUniqueData(srcType.getEncoding(),
+                                                   srcType.getShape())[0];
+  unsigned numWarpsWithUniqueData =
+      triton::gpu::getWarpsPerCTAWithUniqueData(srcType.getEncoding(),
+                                                srcType.getShape())[0];
+  Value laneId = urem(threadId, i32_val(numThreadPerWarp));
+  Value warpId = udiv(threadId, i32_val(numThreadPerWarp));
+  // Initialize the counters of all the copies with zeros.
+  int numThreads = numWarps * numThreadPerWarp;
+  int numCounters = numCopies * numBins;
+  for (int i = 0; i < ceil(numCounters, numThreads); ++i) {
+    Value offset = add(threadId, i32_val(i * numThreads));
+    offset = urem(offset, i32_val(numCounters));
+    Value sharedMemPtr =
+        gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, offset);
+    store(i32_val(0), sharedMemPtr);
+  }
+  barrier();
+  // Elements replicated across lanes or warps are only counted once, and
+  // values out of the bins are not counted.
+  Value isUnique = and_(icmp_ult(laneId, i32_val(numThreadWithUniqueData)),
+                        icmp_ult(warpId, i32_val(numWarpsWithUniqueData)));
+  Value copyOffset = i32_val(0);
+  if (numCopies > 1)
+    copyOffset = mul(warpId, i32_val(numBins));
+  for (Value value : srcValues) {
+    Value isCounted = and_(isUnique, icmp_ult(value, i32_val(numBins)));
+    Value offset = add(copyOffset, select(isCounted, value, i32_val(0)));
+    Value sharedMemPtr =
+        gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, offset);
+    atomicAdd(sharedMemPtr, zext(i32_ty, isCounted), loc, rewriter);
+  }
+  barrier();
+  // Load the histogram to registers with the right layout, summing the copies.
+  for (Value index : indices) {
+    Value val = load(i32_ty, gep(baseSharedMemPtr.getType(), i32_ty,
+                                 baseSharedMemPtr, index));
+    for (int i = 1; i < numCopies; ++i) {
+      Value offset = add(index, i32_val(i * numBins));
+      Value sharedMemPtr =
+          gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, offset);
+      val = add(val, load(i32_ty, sharedMemPtr));
+    }
+    histogramValues.push_back(val);
+  }
+  return histogramValues;
+}
+
 namespace {
 struct HistogramOpConversion
     : public ConvertOpToLLVMPattern<triton::HistogramOp> {
@@ -167,20 +231,12 @@ public:
            numThreadsPerWarp == 64 &&
                "Only supports 32 or 64 threads per warp");
     int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
+    HistogramOpHelper helper(op);
     // Pad out the bins so that we have at least one bin per thread within a
     // warp.
-    numBins = std::max(numBins, numThreadsPerWarp);
+    numBins = helper.getNumBins();
     Value threadId = getThreadId(rewriter, loc);
     auto srcType = op.getSrc().getType();
-    // First compute a warp local histogram based on values owned by each warps.
-    SmallVector<Value> warpLevelHistogram = computeWarpLevelHistogram(
-        loc, srcType, srcValues, numBins, numThreadsPerWarp, threadId, rewriter,
-        targetInfo);
-
-    // Then use atomic to update the histogram in shared memory.
-    // TODO: we could skip this for cases with num_warps=1 as long as we can
-    // generate the right layout. Currently the warp level histogram generates
-    // data in the default blocked layout.
     Value baseSharedMemPtr =
         LLVM::getSharedMemoryBase(loc, rewriter, op.getOperation());
     auto dstType = op.getType();
@@ -190,9 +246,29 @@ public:
     SmallVector<Value> innerDimIndices;
     for (int i = 0; i < indices.size(); ++i)
       innerDimIndices.push_back(indices[i][0]);
-    SmallVector<Value> histogramValue = computeCrossWarpHistogram(
-        loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram, numBins,
-        numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+
+    SmallVector<Value> histogramValue;
+    if (helper.isSharedMemoryLowering()) {
+      // With many bins, count the elements directly in shared memory.
+      histogramValue = computeSharedMemoryHistogram(
+          loc, rewriter, srcType, baseSharedMemPtr, srcValues, numBins,
+          helper.getNumCopies(), numThreadsPerWarp, innerDimIndices, threadId,
+          numWarps);
+    } else {
+      // First compute a warp local histogram based on values owned by each
+      // warps.
+      SmallVector<Value> warpLevelHistogram = computeWarpLevelHistogram(
+          loc, srcType, srcValues, numBins, numThreadsPerWarp, threadId,
+          rewriter, targetInfo);
+
+      // Then use atomic to update the histogram in shared memory.
+      // TODO: we could skip this for cases with num_warps=1 as long as we can
+      // generate the right layout. Currently the warp level histogram
+      // generates data in the default blocked layout.
+      histogramValue = computeCrossWarpHistogram(
+          loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram, numBins,
+          numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+    }
 
     Value results = packLLElements(loc, typeConverter, histogramValue, rewriter,
                                    op.getType());
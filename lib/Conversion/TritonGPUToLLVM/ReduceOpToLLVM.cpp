@@ -58,6 +58,15 @@ public:
 
     sync(rewriter, loc, op);
 
+    if (helper.isInterWarpReduceInRegisters()) {
+      // Combine the partial reductions of the warps directly into the output
+      // values, without writing them back to shared memory.
+      loadReductionAndPackResult(helper, smemShape, smemBases,
+                                 helper.getInterWarpSizeWithUniqueData(),
+                                 rewriter);
+      return success();
+    }
+
     // The second round of shuffle reduction
     //   now the problem size: sizeInterWarps, s1, s2, .. , sn
     //   where sizeInterWarps is 2^m
@@ -68,11 +77,11 @@ public:
 
     // We could avoid this barrier in some of the layouts, however this is not
     // the general case.
-    // TODO: optimize the barrier in case the layouts are accepted.
     sync(rewriter, loc, op);
 
     // set output values
-    loadReductionAndPackResult(helper, smemShape, smemBases, rewriter);
+    loadReductionAndPackResult(helper, smemShape, smemBases,
+                               /*numPartials=*/1, rewriter);
 
     return success();
   }
@@ -370,59 +379,76 @@ private:
   }
 
   // Load the final reduction from shared memory and replace the reduce result
-  // with it.
+  // with it. With numPartials > 1, shared memory holds the partial reduction
+  // of each warp along the axis instead, and they are combined here.
   void loadReductionAndPackResult(ReduceOpHelper &helper,
                                   SmallVector<unsigned> smemShape,
                                   SmallVector<Value> &smemBases,
+                                  unsigned numPartials,
                                   ConversionPatternRewriter &rewriter) const {
     triton::ReduceOp op = helper.getOperation();
     Location loc = op.getLoc();
-    auto srcLayout = helper.getSrcLayout();
     auto axis = op.getAxis();
     auto smemOrder = helper.getOrderWithAxisAtBeginning();
-    SmallVector<Value> results(op.getNumOperands());
-    for (unsigned i = 0; i < op.getNumOperands(); ++i) {
-      auto elemTy = getElementType(op, i);
-      if (auto resultTy =
-              dyn_cast<RankedTensorType>(op.getResult()[i].getType())) {
-        // nd-tensor where n >= 1
-        auto resultLayout = cast<SliceEncodingAttr>(resultTy.getEncoding());
-        unsigned resultElems = getTotalElemsPerThread(resultTy);
-        auto resultIndices = emitIndices(loc, rewriter, targetInfo,
-                                         resultLayout, resultTy, true);
-        auto resultShape = resultTy.getShape();
-        auto resultCTATile = getShapePerCTATile(resultLayout, resultShape);
-        assert(resultIndices.size() == resultElems);
-
-        SmallVector<Value> resultVals(resultElems);
-        for (size_t j = 0; j < resultElems; ++j) {
-          SmallVector<Value> readIdx = resultIndices[j];
-          readIdx.insert(readIdx.begin() + op.getAxis(), i32_val(0));
-          for (size_t resultIdx = 0, resultDim = resultShape.size();
-               resultIdx < resultDim; ++resultIdx) {
-            auto smemIdx = resultIdx < op.getAxis() ? resultIdx : resultIdx + 1;
-            if (resultCTATile[resultIdx] > smemShape[smemIdx] ||
-                resultShape[resultIdx] > smemShape[smemIdx]) {
-              // When srcShape smaller then src sizePerThread, only srcShape
-              // elements is accumulated in smem. Modulo smemShape effectively
-              // replicates srcShape elements to src sizePerThread.
-              readIdx[smemIdx] =
-                  urem(readIdx[smemIdx], i32_val(smemShape[smemIdx]));
-            }
-          }
-          Value readOffset =
-              linearize(rewriter, loc, readIdx, smemShape, smemOrder);
+    auto loadReduction = [&](SmallVector<Value> readIdx) {
+      SmallVector<Value> acc;
+      for (unsigned partial = 0; partial < numPartials; ++partial) {
+        readIdx[axis] = i32_val(partial);
+        Value readOffset =
+            linearize(rewriter, loc, readIdx, smemShape, smemOrder);
+        SmallVector<Value> cur(op.getNumOperands());
+        for (unsigned i = 0; i < op.getNumOperands(); ++i) {
+          auto elemTy = getElementType(op, i);
           Value readPtr = gep(ptr_ty(rewriter.getContext(), 3), elemTy,
                               smemBases[i], readOffset);
-          resultVals[j] = load(elemTy, readPtr);
+          cur[i] = load(elemTy, readPtr);
         }
+        accumulate(rewriter, op.getCombineOp(), acc, cur, partial == 0);
+      }
+      return acc;
+    };
 
-        results[i] = packLLElements(loc, getTypeConverter(), resultVals,
-                                    rewriter, resultTy);
-      } else {
-        // 0d-tensor -> scalar
-        results[i] = load(elemTy, smemBases[i]);
+    SmallVector<Value> results(op.getNumOperands());
+    auto resultTy = dyn_cast<RankedTensorType>(op.getResult()[0].getType());
+    if (!resultTy) {
+      // 0d-tensor -> scalar
+      results = loadReduction({i32_val(0)});
+      rewriter.replaceOp(op, results);
+      return;
+    }
+    // nd-tensor where n >= 1, all the results have the same layout.
+    auto resultLayout = cast<SliceEncodingAttr>(resultTy.getEncoding());
+    unsigned resultElems = getTotalElemsPerThread(resultTy);
+    auto resultIndices =
+        emitIndices(loc, rewriter, targetInfo, resultLayout, resultTy, true);
+    auto resultShape = resultTy.getShape();
+    auto resultCTATile = getShapePerCTATile(resultLayout, resultShape);
+    assert(resultIndices.size() == resultElems);
+
+    SmallVector<SmallVector<Value>> resultVals(op.getNumOperands());
+    for (size_t j = 0; j < resultElems; ++j) {
+      SmallVector<Value> readIdx = resultIndices[j];
+      readIdx.insert(readIdx.begin() + op.getAxis(), i32_val(0));
+      for (size_t resultIdx = 0, resultDim = resultShape.size();
+           resultIdx < resultDim; ++resultIdx) {
+        auto smemIdx = resultIdx < op.getAxis() ? resultIdx : resultIdx + 1;
+        if (resultCTATile[resultIdx] > smemShape[smemIdx] ||
+            resultShape[resultIdx] > smemShape[smemIdx]) {
+          // When srcShape smaller then src sizePerThread, only srcShape
+          // elements is accumulated in smem. Modulo smemShape effectively
+          // replicates srcShape elements to src sizePerThread.
+          readIdx[smemIdx] =
+              urem(readIdx[smemIdx], i32_val(smemShape[smemIdx]));
+        }
       }
+      SmallVector<Value> vals = loadReduction(readIdx);
+      for (unsigned i = 0; i < op.getNumOperands(); ++i)
+        resultVals[i].push_back(vals[i]);
+    }
+
+    for (unsigned i = 0; i < op.getNumOperands(); ++i) {
+      results[i] = packLLElements(loc, getTypeConverter(), resultVals[i],
+                                  rewriter, op.getResult()[i].getType());
     }
     rewriter.replaceOp(op, results);
   }
@@ -32,15 +32,17 @@ namespace ttng = ::mlir::triton::nvidia_gpu;
 namespace mlir::triton {
 class ReduceOp;
 class ScanOp;
+class SortOp;
 } // namespace mlir::triton
 
 template <typename SourceOp>
 class ConvertTritonGPUReduceScanToLLVMPattern
     : public ConvertOpToLLVMPattern<SourceOp> {
 public:
-  // Make sure the class is only instantiated with Reduce and Scan
+  // Make sure the class is only instantiated with Reduce, Scan and Sort
   static_assert(std::is_same_v<SourceOp, ReduceOp> ||
-                std::is_same_v<SourceOp, ScanOp>);
+                std::is_same_v<SourceOp, ScanOp> ||
+                std::is_same_v<SourceOp, SortOp>);
 
   using ConvertOpToLLVMPattern<SourceOp>::getTypeConverter;
   using ConvertOpToLLVMPattern<SourceOp>::ConvertOpToLLVMPattern;
@@ -51,7 +53,7 @@ public:
     return getTypeConverter()->convertType(ty);
   }
 
-  // Helper to compute the smem bases in both reductions and scans
+  // Helper to compute the smem bases in reductions, scans and sorts
   SmallVector<Value> getSmemBases(SourceOp op, unsigned elems,
                                   ConversionPatternRewriter &rewriter) const {
     auto loc = op.getLoc();
@@ -6,6 +6,7 @@
 #include "triton/Conversion/TritonGPUToLLVM/PatternTritonGPUOpToLLVM.h"
 #include "triton/Conversion/TritonGPUToLLVM/TargetInfoBase.h"
 #include "triton/Conversion/TritonGPUToLLVM/Utility.h"
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
 #include "llvm/ADT/STLExtras.h"
 
 using namespace mlir;
@@ -373,6 +374,10 @@ private:
                      Value warpId) const;
   LogicalResult emitFastScan(triton::ScanOp op, triton::ScanOpAdaptor adaptor,
                              ConversionPatternRewriter &rewriter) const;
+  LogicalResult emitLinearLayoutScan(triton::ScanOp op,
+                                     triton::ScanOpAdaptor adaptor,
+                                     ConversionPatternRewriter &rewriter,
+                                     ScanLoweringHelper &helper) const;
 };
 
 SmallVector<Value>
@@ -487,6 +492,8 @@ ScanOpConversion::emitFastScan(triton::ScanOp op, triton::ScanOpAdaptor adaptor,
   auto loc = helper.getLoc();
   if (!helper.isSupported())
     return failure();
+  if (helper.isLinearLayoutLowering())
+    return emitLinearLayoutScan(op, adaptor, rewriter, helper);
 
   Value threadId = getThreadId(rewriter, loc);
   auto mod = op->getParentOfType<ModuleOp>();
@@ -580,6 +587,232 @@ ScanOpConversion::emitFastScan(triton::ScanOp op, triton::ScanOpAdaptor adaptor,
   rewriter.replaceOp(op, results);
   return success();
 }
+
+// Lowering of the encodings other than blocked, derived from their linear
+// layout. The position of an element along the axis is the sum of the axis
+// bits of its register, lane and warp. The elements of each tile of
+// contiguous elements below the lowest warp bit are scanned with a butterfly
+// over the register and lane bits, which also leaves the total of the tile in
+// all of its elements. The totals of the tiles, owned by different warps or by
+// the registers above the warps, are then combined through shared memory.
+LogicalResult ScanOpConversion::emitLinearLayoutScan(
+    triton::ScanOp op, triton::ScanOpAdaptor adaptor,
+    ConversionPatternRewriter &rewriter, ScanLoweringHelper &helper) const {
+  Location loc = helper.getLoc();
+  MLIRContext *ctx = rewriter.getContext();
+  unsigned axis = helper.getAxis();
+  unsigned numOperands = helper.getNumOperands();
+  bool reverse = helper.getReverse();
+  ArrayRef<int64_t> shape = helper.getShape();
+  Region &combineOp = helper.getCombineOp();
+  LinearLayout layout =
+      *triton::gpu::toLinearLayout(shape, helper.getSrcLayout());
+
+  StringAttr kRegister = str_attr("register");
+  StringAttr kLane = str_attr("lane");
+  StringAttr kWarp = str_attr("warp");
+  StringAttr kBlock = str_attr("block");
+  StringAttr kAxis = str_attr("dim" + std::to_string(axis));
+  auto getAxisBases = [&](StringAttr inDim) {
+    SmallVector<int32_t> ret;
+    for (int i = 0; i < layout.getInDimSizeLog2(inDim); i++)
+      ret.push_back(layout.getBasis(inDim, i, kAxis));
+    return ret;
+  };
+  SmallVector<int32_t> regAxisBases = getAxisBases(kRegister);
+  SmallVector<int32_t> laneAxisBases = getAxisBases(kLane);
+  SmallVector<int32_t> warpAxisBases = getAxisBases(kWarp);
+
+  unsigned tileSizeLog2 = helper.getAxisTileSizeLog2();
+  int32_t tileSize = 1 << tileSizeLog2;
+  unsigned numTiles = helper.getAxisNumTiles();
+  // Registers whose bits are in copyRegs hold the same elements as the
+  // register without them, they are only computed once. The register bits
+  // along the axis are split between the ones within a tile and the ones
+  // selecting the tile.
+  unsigned numRegs = layout.getInDimSize(kRegister);
+  unsigned copyRegs = 0;
+  unsigned innerRegs = 0;
+  unsigned tileRegs = 0;
+  for (auto [i, axisBase] : llvm::enumerate(regAxisBases)) {
+    if (llvm::all_of(layout.getBasis(kRegister, i),
+                     [](int32_t b) { return b == 0; }))
+      copyRegs |= 1 << i;
+    else if (axisBase >= tileSize)
+      tileRegs |= 1 << i;
+    else if (axisBase != 0)
+      innerRegs |= 1 << i;
+  }
+  unsigned laneAxisMask = 0;
+  for (auto [i, axisBase] : llvm::enumerate(laneAxisBases)) {
+    if (axisBase != 0)
+      laneAxisMask |= 1 << i;
+  }
+
+  auto srcValues =
+      unpackInputs(loc, op, adaptor, rewriter, *getTypeConverter());
+  assert(srcValues.size() == numRegs);
+  Value threadId = getThreadId(rewriter, loc);
+  auto mod = op->getParentOfType<ModuleOp>();
+  unsigned iWarpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+  Value warpSize = i32_val(iWarpSize);
+  Value warpId = udiv(threadId, warpSize);
+  Value laneId = urem(threadId, warpSize);
+
+  // Scan the tiles one axis bit at a time. Once the bits below a given bit
+  // are processed, each element holds the scan and the total of the elements
+  // that only differ from it in those bits. In the reverse direction the
+  // elements with the bit set come first.
+  SmallVector<SmallVector<Value>> scan = srcValues;
+  SmallVector<SmallVector<Value>> total = srcValues;
+  for (int32_t axisBit = 1; axisBit < tileSize; axisBit <<= 1) {
+    auto regIt = llvm::find(regAxisBases, axisBit);
+    if (regIt != regAxisBases.end()) {
+      unsigned regBit = 1 << (regIt - regAxisBases.begin());
+      for (unsigned reg = 0; reg < numRegs; reg++) {
+        if (reg & (regBit | copyRegs))
+          continue;
+        unsigned first = reverse ? reg | regBit : reg;
+        unsigned second = reverse ? reg : reg | regBit;
+        scan[second] =
+            accumulate(rewriter, combineOp, total[first], scan[second]);
+        total[first] =
+            accumulate(rewriter, combineOp, total[first], total[second]);
+        total[second] = total[first];
+      }
+      continue;
+    }
+    auto laneIt = llvm::find(laneAxisBases, axisBit);
+    assert(laneIt != laneAxisBases.end() && "axis bit not owned by a lane");
+    unsigned laneBit = 1 << (laneIt - laneAxisBases.begin());
+    Value isSecond = icmp_eq(and_(laneId, i32_val(laneBit)),
+                             i32_val(reverse ? 0 : laneBit));
+    for (unsigned reg = 0; reg < numRegs; reg++) {
+      if (reg & copyRegs)
+        continue;
+      // Both lanes combine the totals in the same order, which matters for
+      // combine functions that aren't commutative.
+      SmallVector<Value> other(numOperands);
+      SmallVector<Value> lhs(numOperands);
+      SmallVector<Value> rhs(numOperands);
+      for (unsigned i = 0; i < numOperands; ++i) {
+        other[i] = targetInfo.shuffleXor(rewriter, loc, total[reg][i], laneBit);
+        lhs[i] = select(isSecond, other[i], total[reg][i]);
+        rhs[i] = select(isSecond, total[reg][i], other[i]);
+      }
+      SmallVector<Value> newScan =
+          accumulate(rewriter, combineOp, other, scan[reg]);
+      total[reg] = accumulate(rewriter, combineOp, lhs, rhs);
+      for (unsigned i = 0; i < numOperands; ++i)
+        scan[reg][i] = select(isSecond, newScan[i], scan[reg][i]);
+    }
+  }
+
+  if (numTiles > 1) {
+    // The index of the tile of each element, in the order of the scan.
+    Value warpTile = i32_val(0);
+    for (auto [i, axisBase] : llvm::enumerate(warpAxisBases)) {
+      if (axisBase == 0)
+        continue;
+      Value bit = and_(lshr(warpId, i32_val(i)), i32_val(1));
+      unsigned shift = llvm::Log2_32(axisBase) - tileSizeLog2;
+      warpTile = or_(warpTile, shl(bit, i32_val(shift)));
+    }
+    auto getTile = [&](unsigned reg) -> Value {
+      int32_t regTile = 0;
+      for (auto [i, axisBase] : llvm::enumerate(regAxisBases)) {
+        if (reg & tileRegs & (1 << i))
+          regTile |= axisBase >> tileSizeLog2;
+      }
+      Value tile = or_(warpTile, i32_val(regTile));
+      return reverse ? xor_(tile, i32_val(numTiles - 1)) : tile;
+    };
+
+    // The totals of the tiles of each set of independent scans are stored
+    // next to each other, at the flat index of their non-axis coordinates.
+    auto elems = helper.getScratchSizeInElems();
+    SmallVector<Value> smemBases = getSmemBases(op, elems, rewriter);
+    SmallVector<Type> smemTypes(numOperands);
+    for (unsigned i = 0; i < numOperands; ++i)
+      smemTypes[i] = getElementType(op, i);
+    llvm::MapVector<unsigned, Value> columnBases;
+    for (unsigned reg = 0; reg < numRegs; reg++) {
+      if (reg & (copyRegs | innerRegs | tileRegs))
+        continue;
+      auto coords = applyLinearLayout(loc, rewriter, layout,
+                                      {{kRegister, i32_val(reg)},
+                                       {kLane, laneId},
+                                       {kWarp, warpId},
+                                       {kBlock, i32_val(0)}});
+      Value column = i32_val(0);
+      for (unsigned dim = 0; dim < shape.size(); ++dim) {
+        if (dim != axis)
+          column = add(mul(column, i32_val(shape[dim])), coords[dim].second);
+      }
+      columnBases[reg] = mul(column, i32_val(numTiles));
+    }
+
+    Value isWriter = icmp_eq(and_(laneId, i32_val(laneAxisMask)), i32_val(0));
+    for (unsigned reg = 0; reg < numRegs; reg++) {
+      if (reg & (copyRegs | innerRegs))
+        continue;
+      Value index = add(columnBases[reg & ~tileRegs], getTile(reg));
+      for (unsigned i = 0; i < numOperands; ++i) {
+        Value writePtr = gep(ptr_ty(ctx, 3), smemTypes[i], smemBases[i], index);
+        targetInfo.storeShared(rewriter, loc, writePtr, total[reg][i],
+                               isWriter);
+      }
+    }
+    barrier();
+
+    for (auto [columnReg, columnBase] : columnBases) {
+      // The prefixes of the first numTiles - 1 tiles, which are shared by the
+      // registers of the column.
+      SmallVector<SmallVector<Value>> prefixes;
+      for (unsigned tile = 0; tile + 1 < numTiles; ++tile) {
+        Value index = add(columnBase, i32_val(tile));
+        SmallVector<Value> tileTotal(numOperands);
+        for (unsigned i = 0; i < numOperands; ++i) {
+          Value readPtr =
+              gep(ptr_ty(ctx, 3), smemTypes[i], smemBases[i], index);
+          tileTotal[i] = load(smemTypes[i], readPtr);
+        }
+        prefixes.push_back(prefixes.empty()
+                               ? tileTotal
+                               : accumulate(rewriter, combineOp,
+                                            prefixes.back(), tileTotal));
+      }
+      for (unsigned reg = 0; reg < numRegs; reg++) {
+        if ((reg & ~(innerRegs | tileRegs)) != columnReg)
+          continue;
+        Value tile = getTile(reg);
+        SmallVector<Value> prefix = prefixes[0];
+        for (unsigned i = 1; i < prefixes.size(); ++i) {
+          Value mask = icmp_ugt(tile, i32_val(i));
+          for (unsigned j = 0; j < numOperands; ++j)
+            prefix[j] = select(mask, prefixes[i][j], prefix[j]);
+        }
+        SmallVector<Value> newScan =
+            accumulate(rewriter, combineOp, prefix, scan[reg]);
+        Value isFirstTile = icmp_eq(tile, i32_val(0));
+        for (unsigned i = 0; i < numOperands; ++i)
+          scan[reg][i] = select(isFirstTile, scan[reg][i], newScan[i]);
+      }
+    }
+  }
+
+  SmallVector<Value> results(numOperands);
+  for (unsigned i = 0; i < numOperands; ++i) {
+    SmallVector<Value> values;
+    for (unsigned reg = 0; reg < numRegs; reg++)
+      values.push_back(scan[reg & ~copyRegs][i]);
+    auto resultTy = cast<RankedTensorType>(op.getResult()[i].getType());
+    results[i] =
+        packLLElements(loc, getTypeConverter(), values, rewriter, resultTy);
+  }
+  rewriter.replaceOp(op, results);
+  return success();
+}
 } // namespace
 
 void mlir::triton::populateScanOpToLLVMPatterns(
@@ -0,0 +1,302 @@
+#include "ReduceScanCommon.h"
+#include "mlir/Support/LLVM.h"
+#include "triton/Analysis/Utility.h"
+#include "triton/Conversion/TritonGPUToLLVM/PatternTritonGPUOpToLLVM.h"
+#include "triton/Conversion/TritonGPUToLLVM/TargetInfoBase.h"
+#include "triton/Conversion/TritonGPUToLLVM/Utility.h"
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
+#include "llvm/ADT/STLExtras.h"
+
+using namespace mlir;
+using namespace mlir::triton;
+
+// Inline the comparator region and return whether the elements `lhs` must come
+// before the elements `rhs`.
+static Value applyComparator(ConversionPatternRewriter &rewriter,
+                             Region &comparator, ValueRange lhs,
+                             ValueRange rhs) {
+  assert(lhs.size() == rhs.size());
+  // Create a new copy of the comparator block, and inline it
+  Block *currentBlock = rewriter.getBlock();
+  Region &parent = *currentBlock->getParent();
+  rewriter.cloneRegionBefore(comparator, &parent.front());
+  auto &newComparator = parent.front();
+  auto returnOp = cast<triton::SortReturnOp>(newComparator.getTerminator());
+
+  SmallVector<Value> comparatorArgs(lhs.begin(), lhs.end());
+  comparatorArgs.append(rhs.begin(), rhs.end());
+  rewriter.inlineBlockBefore(&newComparator, &*rewriter.getInsertionPoint(),
+                             comparatorArgs);
+  Value result = rewriter.getRemappedValue(returnOp.getResult());
+  // Delete the terminator, which is no longer used
+  rewriter.eraseOp(returnOp);
+  return result;
+}
+
+namespace {
+// Lowering of a bitonic sorting network. The position of an element along the
+// axis is the sum of the axis bits of its register, lane and warp, so each
+// compare-exchange, between the elements whose positions differ in one bit, is
+// either within a thread, a shuffle within a warp, or an exchange through
+// shared memory across warps.
+struct SortOpConversion
+    : public ConvertTritonGPUReduceScanToLLVMPattern<triton::SortOp> {
+public:
+  using ConvertTritonGPUReduceScanToLLVMPattern<
+      triton::SortOp>::ConvertTritonGPUReduceScanToLLVMPattern;
+  explicit SortOpConversion(LLVMTypeConverter &typeConverter,
+                            const TargetInfoBase &targetInfo,
+                            PatternBenefit benefit = 1)
+      : ConvertTritonGPUReduceScanToLLVMPattern<triton::SortOp>(typeConverter,
+                                                                benefit),
+        targetInfo(targetInfo) {}
+
+  LogicalResult
+  matchAndRewrite(triton::SortOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override;
+
+private:
+  const TargetInfoBase &targetInfo;
+};
+
+LogicalResult
+SortOpConversion::matchAndRewrite(triton::SortOp op, OpAdaptor adaptor,
+                                  ConversionPatternRewriter &rewriter) const {
+  SortOpHelper helper(op);
+  if (!helper.isSupported())
+    return failure();
+
+  Location loc = op.getLoc();
+  MLIRContext *ctx = rewriter.getContext();
+  unsigned axis = op.getAxis();
+  unsigned numOperands = op.getNumOperands();
+  RankedTensorType srcTy = op.getInputTypes()[0];
+  ArrayRef<int64_t> shape = srcTy.getShape();
+  int32_t axisSize = shape[axis];
+  Region &comparator = op.getComparator();
+  LinearLayout layout =
+      *triton::gpu::toLinearLayout(shape, srcTy.getEncoding());
+
+  StringAttr kRegister = str_attr("register");
+  StringAttr kLane = str_attr("lane");
+  StringAttr kWarp = str_attr("warp");
+  StringAttr kBlock = str_attr("block");
+  StringAttr kAxis = str_attr("dim" + std::to_string(axis));
+  auto getAxisBases = [&](StringAttr inDim) {
+    SmallVector<int32_t> ret;
+    for (int i = 0; i < layout.getInDimSizeLog2(inDim); i++)
+      ret.push_back(layout.getBasis(inDim, i, kAxis));
+    return ret;
+  };
+  SmallVector<int32_t> regAxisBases = getAxisBases(kRegister);
+  SmallVector<int32_t> laneAxisBases = getAxisBases(kLane);
+  SmallVector<int32_t> warpAxisBases = getAxisBases(kWarp);
+
+  // Registers whose bits are in copyRegs hold the same elements as the
+  // register without them, they are only sorted once.
+  unsigned numRegs = layout.getInDimSize(kRegister);
+  unsigned copyRegs = 0;
+  for (unsigned i = 0; i < regAxisBases.size(); i++) {
+    if (llvm::all_of(layout.getBasis(kRegister, i),
+                     [](int32_t b) { return b == 0; }))
+      copyRegs |= 1 << i;
+  }
+
+  SmallVector<SmallVector<Value>> values(numRegs);
+  for (Value src : adaptor.getSrcs()) {
+    auto elems = unpackLLElements(loc, src, rewriter);
+    assert(elems.size() == numRegs);
+    for (unsigned reg = 0; reg < numRegs; reg++)
+      values[reg].push_back(elems[reg]);
+  }
+  Value threadId = getThreadId(rewriter, loc);
+  auto mod = op->getParentOfType<ModuleOp>();
+  unsigned iWarpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+  Value warpSize = i32_val(iWarpSize);
+  Value warpId = udiv(threadId, warpSize);
+  Value laneId = urem(threadId, warpSize);
+
+  // Return whether the given bit of the position along the axis of the element
+  // in register `reg` is set.
+  auto isAxisBitSet = [&](unsigned reg, int32_t axisBit) -> Value {
+    auto regIt = llvm::find(regAxisBases, axisBit);
+    if (regIt != regAxisBases.end())
+      return reg & (1 << (regIt - regAxisBases.begin())) ? true_val()
+                                                          : false_val();
+    auto laneIt = llvm::find(laneAxisBases, axisBit);
+    if (laneIt != laneAxisBases.end()) {
+      unsigned laneBit = 1 << (laneIt - laneAxisBases.begin());
+      return icmp_ne(and_(laneId, i32_val(laneBit)), i32_val(0));
+    }
+    auto warpIt = llvm::find(warpAxisBases, axisBit);
+    assert(warpIt != warpAxisBases.end() && "axis bit not owned by a warp");
+    unsigned warpBit = 1 << (warpIt - warpAxisBases.begin());
+    return icmp_ne(and_(warpId, i32_val(warpBit)), i32_val(0));
+  };
+
+  // The elements are exchanged across warps and gathered for the top k through
+  // the scratch buffer, which holds the tensor at the flat index of the
+  // elements.
+  SmallVector<Value> smemBases;
+  SmallVector<Type> smemTypes(numOperands);
+  if (helper.getScratchSizeInBytes() > 0) {
+    smemBases = getSmemBases(op, helper.getScratchSizeInElems(), rewriter);
+    for (unsigned i = 0; i < numOperands; ++i)
+      smemTypes[i] = getElementType(op, i);
+  }
+  auto getFlatIndex = [&](const LinearLayout &ll, unsigned reg) {
+    auto coords = applyLinearLayout(loc, rewriter, ll,
+                                    {{kRegister, i32_val(reg)},
+                                     {kLane, laneId},
+                                     {kWarp, warpId},
+                                     {kBlock, i32_val(0)}});
+    Value index = i32_val(0);
+    for (unsigned dim = 0; dim < shape.size(); ++dim)
+      index = add(mul(index, i32_val(shape[dim])), coords[dim].second);
+    return index;
+  };
+  SmallVector<Value> flatIndices;
+  bool isScratchRead = false;
+  auto storeToScratch = [&]() {
+    if (flatIndices.empty()) {
+      flatIndices.resize(numRegs);
+      for (unsigned reg = 0; reg < numRegs; reg++) {
+        if (!(reg & copyRegs))
+          flatIndices[reg] = getFlatIndex(layout, reg);
+      }
+    }
+    // Wait for the reads of the previous exchange.
+    if (isScratchRead)
+      barrier();
+    for (unsigned reg = 0; reg < numRegs; reg++) {
+      if (reg & copyRegs)
+        continue;
+      for (unsigned i = 0; i < numOperands; ++i) {
+        Value writePtr =
+            gep(ptr_ty(ctx, 3), smemTypes[i], smemBases[i], flatIndices[reg]);
+        targetInfo.storeShared(rewriter, loc, writePtr, values[reg][i],
+                               true_val());
+      }
+    }
+    barrier();
+    isScratchRead = true;
+  };
+
+  // The flat index of the elements one apart along the axis.
+  int32_t axisStride = 1;
+  for (unsigned dim = axis + 1; dim < shape.size(); ++dim)
+    axisStride *= shape[dim];
+
+  // The sequences of 2 << stage elements are sorted in alternating directions
+  // by merging the sorted halves, which are in opposite directions. The last
+  // stage sorts the whole axis in the order of the comparator.
+  for (int32_t seqSize = 2; seqSize <= axisSize; seqSize <<= 1) {
+    auto isDescending = [&](unsigned reg) {
+      return seqSize < axisSize ? isAxisBitSet(reg, seqSize) : false_val();
+    };
+    for (int32_t axisBit = seqSize / 2; axisBit >= 1; axisBit >>= 1) {
+      auto regIt = llvm::find(regAxisBases, axisBit);
+      if (regIt != regAxisBases.end()) {
+        unsigned regBit = 1 << (regIt - regAxisBases.begin());
+        for (unsigned reg = 0; reg < numRegs; reg++) {
+          if (reg & (regBit | copyRegs))
+            continue;
+          // In a descending sequence the element of the upper register
+          // comes first.
+          unsigned upperReg = reg | regBit;
+          Value descending = isDescending(reg);
+          SmallVector<Value> first(numOperands);
+          SmallVector<Value> second(numOperands);
+          for (unsigned i = 0; i < numOperands; ++i) {
+            first[i] = select(descending, values[upperReg][i], values[reg][i]);
+            second[i] = select(descending, values[reg][i], values[upperReg][i]);
+          }
+          Value swap = applyComparator(rewriter, comparator, second, first);
+          for (unsigned i = 0; i < numOperands; ++i) {
+            Value lower = values[reg][i];
+            values[reg][i] = select(swap, values[upperReg][i], lower);
+            values[upperReg][i] = select(swap, lower, values[upperReg][i]);
+          }
+        }
+        continue;
+      }
+
+      auto laneIt = llvm::find(laneAxisBases, axisBit);
+      unsigned laneBit = 0;
+      if (laneIt != laneAxisBases.end())
+        laneBit = 1 << (laneIt - laneAxisBases.begin());
+      else
+        storeToScratch();
+      for (unsigned reg = 0; reg < numRegs; reg++) {
+        if (reg & copyRegs)
+          continue;
+        SmallVector<Value> other(numOperands);
+        for (unsigned i = 0; i < numOperands; ++i) {
+          if (laneBit != 0) {
+            other[i] =
+                targetInfo.shuffleXor(rewriter, loc, values[reg][i], laneBit);
+          } else {
+            Value index = xor_(flatIndices[reg], i32_val(axisBit * axisStride));
+            Value readPtr =
+                gep(ptr_ty(ctx, 3), smemTypes[i], smemBases[i], index);
+            other[i] = load(smemTypes[i], readPtr);
+          }
+        }
+        // The element keeps the first of the pair if it is the lower one of
+        // an ascending sequence or the upper one of a descending sequence.
+        // Both elements of the pair evaluate the comparator on the same
+        // arguments, so that they agree on whether to swap.
+        Value keepFirst =
+            icmp_eq(isAxisBitSet(reg, axisBit), isDescending(reg));
+        SmallVector<Value> lhs(numOperands);
+        SmallVector<Value> rhs(numOperands);
+        for (unsigned i = 0; i < numOperands; ++i) {
+          lhs[i] = select(keepFirst, other[i], values[reg][i]);
+          rhs[i] = select(keepFirst, values[reg][i], other[i]);
+        }
+        Value swap = applyComparator(rewriter, comparator, lhs, rhs);
+        for (unsigned i = 0; i < numOperands; ++i)
+          values[reg][i] = select(swap, other[i], values[reg][i]);
+      }
+    }
+  }
+
+  auto resultTy = cast<RankedTensorType>(op.getResult()[0].getType());
+  SmallVector<SmallVector<Value>> results(numOperands);
+  if (helper.isTopK()) {
+    // The first k elements along the axis are read back at the positions the
+    // layout of the result assigns to each register.
+    storeToScratch();
+    LinearLayout resultLayout = *triton::gpu::toLinearLayout(
+        resultTy.getShape(), resultTy.getEncoding());
+    unsigned numResultRegs = resultLayout.getInDimSize(kRegister);
+    for (unsigned reg = 0; reg < numResultRegs; reg++) {
+      Value index = getFlatIndex(resultLayout, reg);
+      for (unsigned i = 0; i < numOperands; ++i) {
+        Value readPtr = gep(ptr_ty(ctx, 3), smemTypes[i], smemBases[i], index);
+        results[i].push_back(load(smemTypes[i], readPtr));
+      }
+    }
+  } else {
+    for (unsigned reg = 0; reg < numRegs; reg++) {
+      for (unsigned i = 0; i < numOperands; ++i)
+        results[i].push_back(values[reg & ~copyRegs][i]);
+    }
+  }
+
+  SmallVector<Value> packed(numOperands);
+  for (unsigned i = 0; i < numOperands; ++i) {
+    auto retTy = cast<RankedTensorType>(op.getResult()[i].getType());
+    packed[i] =
+        packLLElements(loc, getTypeConverter(), results[i], rewriter, retTy);
+  }
+  rewriter.replaceOp(op, packed);
+  return success();
+}
+} // namespace
+
+void mlir::triton::populateSortOpToLLVMPatterns(
+    LLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    const TargetInfoBase &targetInfo, PatternBenefit benefit) {
+  patterns.add<SortOpConversion>(typeConverter, targetInfo, benefit);
+}
@@ -477,6 +477,26 @@ struct TritonScanPattern : public OpConversionPattern<triton::ScanOp> {
   }
 };
 
+struct TritonSortPattern : public OpConversionPattern<triton::SortOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  // The results keep the layout of the operands, also when only the first k
+  // elements are returned.
+  LogicalResult
+  matchAndRewrite(triton::SortOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto newSort = rewriter.create<triton::SortOp>(
+        op.getLoc(), adaptor.getOperands(), adaptor.getAxis(), op.getK());
+    addNamedAttrs(newSort, adaptor.getAttributes());
+
+    auto &newComparator = newSort.getComparator();
+    rewriter.cloneRegionBefore(op.getComparator(), newComparator,
+                               newComparator.end());
+    rewriter.replaceOp(op, newSort.getResult());
+    return success();
+  }
+};
+
 class TritonFuncOpPattern : public OpConversionPattern<triton::FuncOp> {
 public:
   using OpConversionPattern::OpConversionPattern;
@@ -541,7 +561,8 @@ void populateTritonPatterns(TritonGPUTypeConverter &typeConverter,
       GenericOpPattern<triton::MulhiUIOp>,
       GenericOpPattern<triton::ElementwiseInlineAsmOp>, TritonReducePattern,
       GenericOpPattern<triton::ReduceReturnOp>, TritonScanPattern,
-      GenericOpPattern<triton::ScanReturnOp>,
+      GenericOpPattern<triton::ScanReturnOp>, TritonSortPattern,
+      GenericOpPattern<triton::SortReturnOp>,
       GenericOpPattern<triton::MakeRangeOp>, TritonExpandDimsPattern,
       TritonTransPattern, TritonDotPattern, GenericOpPattern<triton::LoadOp>,
       GenericOpPattern<triton::StoreOp>, GenericOpPattern<triton::HistogramOp>,
@@ -396,10 +396,10 @@ LogicalResult ReduceOp::inferReturnTypes(
 
 // Helpers for Reductions and Scans
 template <class Op> LogicalResult verifyReduceScan(Op &op) {
-  if (op.getOperands().empty()) {
+  if (op.getSrcs().empty()) {
     return op.emitOpError() << "must have at least 1 operand";
   }
-  if (op.getNumOperands() != op.getNumResults()) {
+  if (op.getSrcs().size() != op.getNumResults()) {
     return op.emitOpError() << "must have the same number of inputs as outputs";
   }
 
@@ -419,10 +419,9 @@ template <class Op> LogicalResult verifyReduceScan(Op &op) {
   return success();
 }
 
-template <class ReturnOp, class Op>
-static LogicalResult verifyRegionsImpl(Op &op) {
+template <class Op> static LogicalResult verifyRegionArgumentsImpl(Op &op) {
   auto argElementTypes = op.getElementTypes();
-  const auto &operands = op.getOperands();
+  const auto &operands = op.getSrcs();
   const auto numArgs = 2 * operands.size();
   auto &block = *op.getBody();
   if (block.getNumArguments() != numArgs) {
@@ -441,7 +440,16 @@ static LogicalResult verifyRegionsImpl(Op &op) {
              << " to have type " << argElemTy << " but got " << blockArgTy;
     }
   }
+  return success();
+}
 
+template <class ReturnOp, class Op>
+static LogicalResult verifyRegionsImpl(Op &op) {
+  if (failed(verifyRegionArgumentsImpl(op)))
+    return failure();
+  auto argElementTypes = op.getElementTypes();
+  const auto &operands = op.getSrcs();
+  auto &block = *op.getBody();
   auto terminator = dyn_cast<ReturnOp>(block.getTerminator());
   if (!terminator) {
     return op.emitOpError()
@@ -538,6 +546,136 @@ llvm::SmallVector<Type> ScanOp::getElementTypes() {
 
 unsigned ScanOp::getNumOperands() { return this->getOperands().size(); }
 
+//-- CrossProgramScanOp --
+void CrossProgramScanOp::build(OpBuilder &builder, OperationState &state,
+                               ValueRange srcs, Value workspace) {
+  SmallVector<Type> inferredReturnTypes;
+  for (auto arg : srcs)
+    inferredReturnTypes.push_back(arg.getType());
+  CrossProgramScanOp::build(builder, state, inferredReturnTypes, srcs,
+                            workspace);
+}
+
+LogicalResult CrossProgramScanOp::inferReturnTypes(
+    MLIRContext *context, std::optional<Location> location,
+    ValueRange operands, DictionaryAttr attributes, OpaqueProperties properties,
+    RegionRange regions, SmallVectorImpl<Type> &inferredReturnTypes) {
+  // The last operand is the workspace.
+  for (auto arg : operands.drop_back())
+    inferredReturnTypes.push_back(arg.getType());
+  return success();
+}
+
+LogicalResult CrossProgramScanOp::verify() {
+  if (failed(verifyReduceScan(*this)))
+    return failure();
+  auto srcTys = getInputTypes();
+  for (auto srcTy : srcTys) {
+    if (srcTy.getRank() != 1)
+      return emitOpError() << "only supports 1D tensors";
+    if (srcTy.getShape() != srcTys[0].getShape())
+      return emitOpError() << "operands must have the same shape";
+    // The workspace holds up to 8 bytes per element.
+    Type elemTy = srcTy.getElementType();
+    if (!elemTy.isIntOrFloat() || elemTy.getIntOrFloatBitWidth() > 64)
+      return emitOpError()
+             << "only supports integer and floating-point elements of up to "
+                "64 bits";
+  }
+  return success();
+}
+
+LogicalResult CrossProgramScanOp::verifyRegions() {
+  return verifyRegionsImpl<ScanReturnOp>(*this);
+}
+
+llvm::SmallVector<RankedTensorType> CrossProgramScanOp::getInputTypes() {
+  return getInputTypesImpl(getSrcs());
+}
+
+llvm::SmallVector<Type> CrossProgramScanOp::getElementTypes() {
+  return getElementTypesImpl(getSrcs());
+}
+
+//-- SortOp --
+static RankedTensorType inferSortReturnType(RankedTensorType srcTy, int axis,
+                                            std::optional<int> k) {
+  auto retShape = srcTy.getShape().vec();
+  if (k.has_value())
+    retShape[axis] = *k;
+  return RankedTensorType::get(retShape, srcTy.getElementType(),
+                               srcTy.getEncoding());
+}
+
+void SortOp::build(OpBuilder &builder, OperationState &state, ValueRange srcs,
+                   int axis, std::optional<int> k) {
+  SmallVector<Type> inferredReturnTypes;
+  for (auto src : srcs) {
+    auto srcTy = cast<RankedTensorType>(src.getType());
+    inferredReturnTypes.push_back(inferSortReturnType(srcTy, axis, k));
+  }
+  IntegerAttr kAttr = k.has_value() ? builder.getI32IntegerAttr(*k) : nullptr;
+  SortOp::build(builder, state, inferredReturnTypes, srcs,
+                builder.getI32IntegerAttr(axis), kAttr);
+}
+
+LogicalResult
+SortOp::inferReturnTypes(MLIRContext *context, std::optional<Location> location,
+                         ValueRange operands, DictionaryAttr attributes,
+                         OpaqueProperties properties, RegionRange regions,
+                         SmallVectorImpl<Type> &inferredReturnTypes) {
+  Properties *prop = properties.as<Properties *>();
+  int axis = prop->axis.getInt();
+  std::optional<int> k;
+  if (prop->k)
+    k = prop->k.getInt();
+  for (auto arg : operands) {
+    auto argTy = cast<RankedTensorType>(arg.getType());
+    if (axis < 0 || axis >= argTy.getRank())
+      return failure();
+    inferredReturnTypes.push_back(inferSortReturnType(argTy, axis, k));
+  }
+  return success();
+}
+
+LogicalResult SortOp::verify() {
+  if (failed(verifyReduceScan(*this)))
+    return failure();
+  auto srcTys = getInputTypes();
+  for (auto srcTy : srcTys) {
+    if (srcTy.getShape() != srcTys[0].getShape())
+      return emitOpError() << "operands must have the same shape";
+  }
+  if (getAxis() >= srcTys[0].getRank())
+    return emitOpError() << "axis out of range";
+  int64_t axisSize = srcTys[0].getShape()[getAxis()];
+  if (!llvm::isPowerOf2_64(axisSize))
+    return emitOpError() << "axis size must be a power of two";
+  if (auto k = getK()) {
+    if (*k < 1 || *k > axisSize)
+      return emitOpError() << "k must be between 1 and the axis size "
+                           << axisSize << " but got " << *k;
+    // The result is a tensor too, whose dimensions are powers of two.
+    if (!llvm::isPowerOf2_64(*k))
+      return emitOpError() << "k must be a power of two but got " << *k;
+  }
+  return success();
+}
+
+LogicalResult SortOp::verifyRegions() {
+  return verifyRegionArgumentsImpl(*this);
+}
+
+llvm::SmallVector<RankedTensorType> SortOp::getInputTypes() {
+  return getInputTypesImpl(getSrcs());
+}
+
+llvm::SmallVector<Type> SortOp::getElementTypes() {
+  return getElementTypesImpl(getSrcs());
+}
+
+unsigned SortOp::getNumOperands() { return this->getOperands().size(); }
+
 //-- SplatOp --
 OpFoldResult SplatOp::fold(FoldAdaptor adaptor) {
   auto value = adaptor.getSrc();
@@ -0,0 +1,211 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Support/LLVM.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "triton/Analysis/AxisInfo.h"
+#include "triton/Analysis/RangeInfo.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#define GEN_PASS_DEF_TRITONFOLDMASKS
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace mlir::triton {
+namespace {
+
+Value getBoolConstant(OpBuilder &builder, Location loc, Type type,
+                      bool value) {
+  if (auto tensorTy = dyn_cast<RankedTensorType>(type))
+    return builder.create<arith::ConstantOp>(
+        loc, DenseElementsAttr::get(tensorTy, value));
+  return builder.create<arith::ConstantOp>(loc,
+                                           builder.getIntegerAttr(type, value));
+}
+
+// Looks through the operations that only replicate the elements of `value`.
+Value getSource(Value value) {
+  while (Operation *op = value.getDefiningOp()) {
+    if (!isa<SplatOp, BroadcastOp, ExpandDimsOp>(op))
+      break;
+    value = op->getOperand(0);
+  }
+  return value;
+}
+
+// Returns true if `value` is the mask of a memory access, possibly combined
+// with other masks.
+bool isUsedAsMask(Value value) {
+  SmallVector<Value> worklist{value};
+  DenseSet<Value> visited;
+  while (!worklist.empty()) {
+    Value curr = worklist.pop_back_val();
+    if (!visited.insert(curr).second)
+      continue;
+    for (Operation *user : curr.getUsers()) {
+      if (auto loadOp = dyn_cast<LoadOp>(user)) {
+        if (loadOp.getMask() == curr)
+          return true;
+      } else if (auto storeOp = dyn_cast<StoreOp>(user)) {
+        if (storeOp.getMask() == curr)
+          return true;
+      } else if (auto atomicOp = dyn_cast<AtomicRMWOp>(user)) {
+        if (atomicOp.getMask() == curr)
+          return true;
+      } else if (isa<arith::AndIOp, SplatOp, BroadcastOp, ExpandDimsOp>(
+                     user)) {
+        worklist.push_back(user->getResult(0));
+      }
+    }
+  }
+  return false;
+}
+
+// Returns true if `cmpOp` is `iv + r < ub` for the induction variable `iv` and
+// the upper bound `ub` of `forOp`, where r is in [0, step).
+//
+// If the lower bound is non-negative, such a mask is true in the iterations
+// whose last element is in bounds, i.e. all but the last one if the trip count
+// is not a multiple of the step.
+bool isLoopBoundMask(arith::CmpIOp cmpOp, scf::ForOp forOp, int64_t step,
+                     ModuleRangeInfoAnalysis &rangeInfoAnalysis) {
+  Value lhs = cmpOp.getLhs();
+  Value rhs = cmpOp.getRhs();
+  switch (cmpOp.getPredicate()) {
+  case arith::CmpIPredicate::slt:
+  case arith::CmpIPredicate::ult:
+    break;
+  case arith::CmpIPredicate::sgt:
+  case arith::CmpIPredicate::ugt:
+    std::swap(lhs, rhs);
+    break;
+  default:
+    return false;
+  }
+  if (getSource(rhs) != forOp.getUpperBound())
+    return false;
+  Value iv = forOp.getInductionVar();
+  if (getSource(lhs) == iv)
+    return true;
+  auto addOp = lhs.getDefiningOp<arith::AddIOp>();
+  if (!addOp)
+    return false;
+  for (auto [x, r] : {std::make_pair(addOp.getLhs(), addOp.getRhs()),
+                      std::make_pair(addOp.getRhs(), addOp.getLhs())}) {
+    if (getSource(x) != iv)
+      continue;
+    auto *rangeInfo = rangeInfoAnalysis.getRangeInfo(r);
+    if (rangeInfo && rangeInfo->getMin() >= 0 && rangeInfo->getMax() < step)
+      return true;
+  }
+  return false;
+}
+
+// Returns the masks of `forOp` that are true in all but its last iteration.
+SmallVector<arith::CmpIOp>
+getLoopBoundMasks(scf::ForOp forOp,
+                  ModuleRangeInfoAnalysis &rangeInfoAnalysis) {
+  auto step = getConstantIntValue(forOp.getStep());
+  if (!step || *step <= 1)
+    return {};
+  auto *lb = rangeInfoAnalysis.getRangeInfo(forOp.getLowerBound());
+  if (!lb || lb->getMin() < 0)
+    return {};
+  // Loops with dots are software pipelined, duplicating them would also
+  // duplicate their prologues and epilogues.
+  if (forOp.getBody()
+          ->walk([](DotOp) { return WalkResult::interrupt(); })
+          .wasInterrupted())
+    return {};
+  SmallVector<arith::CmpIOp> masks;
+  forOp.getBody()->walk([&](arith::CmpIOp cmpOp) {
+    if (!rangeInfoAnalysis.getConstantCondition(cmpOp.getResult()) &&
+        isUsedAsMask(cmpOp.getResult()) &&
+        isLoopBoundMask(cmpOp, forOp, *step, rangeInfoAnalysis))
+      masks.push_back(cmpOp);
+  });
+  return masks;
+}
+
+// Splits `forOp` into a main loop, in which `masks` are all true, followed by
+// the original loop running the remaining iteration, if any.
+void splitLoop(scf::ForOp forOp, ArrayRef<arith::CmpIOp> masks) {
+  OpBuilder builder(forOp);
+  Location loc = forOp.getLoc();
+  Value lb = forOp.getLowerBound();
+  Value step = forOp.getStep();
+  // The main loop stops at the last multiple of the step away from the lower
+  // bound that does not exceed the upper bound. The lower bound is
+  // non-negative, so the subtraction cannot overflow.
+  Value splitPoint =
+      builder.create<arith::MaxSIOp>(loc, forOp.getUpperBound(), lb);
+  Value tripRange = builder.create<arith::SubIOp>(loc, splitPoint, lb);
+  Value remainder = builder.create<arith::RemSIOp>(loc, tripRange, step);
+  splitPoint = builder.create<arith::SubIOp>(loc, splitPoint, remainder);
+
+  IRMapping mapping;
+  auto mainLoop = cast<scf::ForOp>(builder.clone(*forOp, mapping));
+  mainLoop.setUpperBound(splitPoint);
+  for (arith::CmpIOp mask : masks) {
+    Operation *newMask = mapping.lookup(mask.getResult()).getDefiningOp();
+    OpBuilder maskBuilder(newMask);
+    newMask->getResult(0).replaceAllUsesWith(getBoolConstant(
+        maskBuilder, newMask->getLoc(), mask.getType(), /*value=*/true));
+    newMask->erase();
+  }
+
+  forOp.setLowerBound(splitPoint);
+  forOp.getInitArgsMutable().assign(mainLoop.getResults());
+}
+
+class FoldMasksPass : public ::impl::TritonFoldMasksBase<FoldMasksPass> {
+public:
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    ModuleOp m = getOperation();
+
+    // Changing the IR invalidates the analyses, so everything is collected
+    // first. This also keeps the loops split here from being split again.
+    ModuleAxisInfoAnalysis &axisInfoAnalysis =
+        ModuleAxisInfoAnalysis::get(getAnalysisManager());
+    ModuleRangeInfoAnalysis rangeInfoAnalysis(m, axisInfoAnalysis);
+    SmallVector<std::pair<arith::CmpIOp, bool>> constantCmps;
+    m.walk([&](arith::CmpIOp cmpOp) {
+      Value result = cmpOp.getResult();
+      if (auto value = rangeInfoAnalysis.getConstantCondition(result))
+        constantCmps.push_back({cmpOp, *value});
+    });
+    SmallVector<std::pair<scf::ForOp, SmallVector<arith::CmpIOp>>> loops;
+    m.walk([&](scf::ForOp forOp) {
+      auto masks = getLoopBoundMasks(forOp, rangeInfoAnalysis);
+      if (!masks.empty())
+        loops.push_back({forOp, std::move(masks)});
+    });
+
+    for (auto [cmpOp, value] : constantCmps) {
+      OpBuilder builder(cmpOp);
+      cmpOp.replaceAllUsesWith(
+          getBoolConstant(builder, cmpOp.getLoc(), cmpOp.getType(), value));
+      cmpOp.erase();
+    }
+    for (auto &[forOp, masks] : loops)
+      splitLoop(forOp, masks);
+
+    // load(ptr, splat(1), ...) => load(ptr, ...)
+    // store(ptr, value, splat(1)) => store(ptr, value)
+    RewritePatternSet patterns(context);
+    LoadOp::getCanonicalizationPatterns(patterns, context);
+    StoreOp::getCanonicalizationPatterns(patterns, context);
+    if (applyPatternsAndFoldGreedily(m, std::move(patterns)).failed())
+      signalPassFailure();
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::Pass> createFoldMasksPass() {
+  return std::make_unique<FoldMasksPass>();
+}
+
+} // namespace mlir::triton
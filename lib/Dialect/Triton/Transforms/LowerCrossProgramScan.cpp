@@ -0,0 +1,425 @@
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Support/LLVM.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+
+#define GEN_PASS_DEF_TRITONLOWERCROSSPROGRAMSCAN
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+namespace mlir::triton {
+namespace {
+
+// The status flag of a program in the workspace.
+enum ScanStatus : int32_t {
+  // The program has not published anything yet.
+  NotReady = 0,
+  // The aggregate of the elements of the program is published.
+  AggregateReady = 1,
+  // The inclusive prefix of the program, i.e. the aggregate of the elements
+  // of all programs up to and including it, is published.
+  PrefixReady = 2,
+};
+
+// Each program owns a record of the workspace: its status flag, padded to 8
+// bytes, followed for each operand by an 8-byte slot for the aggregate and an
+// 8-byte slot for the inclusive prefix. The padding of the first record of
+// each chain holds the counter the tile ids of the chain are taken from.
+constexpr int64_t kFlagBytes = 8;
+constexpr int64_t kSlotBytes = 8;
+constexpr int64_t kTileCounterOffset = 4;
+
+int64_t getRecordBytes(unsigned numOperands) {
+  return kFlagBytes + 2 * kSlotBytes * numOperands;
+}
+
+int64_t getAggregateOffset(unsigned operand) {
+  return kFlagBytes + 2 * kSlotBytes * operand;
+}
+
+int64_t getPrefixOffset(unsigned operand) {
+  return getAggregateOffset(operand) + kSlotBytes;
+}
+
+Value createI32(OpBuilder &builder, Location loc, int64_t value) {
+  return builder.create<arith::ConstantIntOp>(loc, value, 32);
+}
+
+Value createI8Ptr(OpBuilder &builder, Location loc, Value ptr) {
+  auto ptrTy = cast<PointerType>(ptr.getType());
+  return builder.create<BitcastOp>(
+      loc, PointerType::get(builder.getI8Type(), ptrTy.getAddressSpace()), ptr);
+}
+
+// Programs along axes 1 and 2 of the grid own separate chains of records.
+Value createChainIdx(OpBuilder &builder, Location loc) {
+  Type i32Ty = builder.getI32Type();
+  auto getProgramId = [&](ProgramIDDim dim) -> Value {
+    return builder.create<GetProgramIdOp>(
+        loc, i32Ty, ProgramIDDimAttr::get(builder.getContext(), dim));
+  };
+  Value numProgramsY = builder.create<GetNumProgramsOp>(
+      loc, i32Ty, ProgramIDDimAttr::get(builder.getContext(), ProgramIDDim::Y));
+  return builder.create<arith::AddIOp>(
+      loc, getProgramId(ProgramIDDim::Y),
+      builder.create<arith::MulIOp>(loc, numProgramsY,
+                                    getProgramId(ProgramIDDim::Z)));
+}
+
+Value createNumProgramsX(OpBuilder &builder, Location loc) {
+  return builder.create<GetNumProgramsOp>(
+      loc, builder.getI32Type(),
+      ProgramIDDimAttr::get(builder.getContext(), ProgramIDDim::X));
+}
+
+// Returns a pointer of type `elemTy` to the byte `offset` of `record`.
+Value createSlotPtr(OpBuilder &builder, Location loc, Value record,
+                    int64_t offset, Type elemTy) {
+  auto ptrTy = cast<PointerType>(record.getType());
+  Value ptr = builder.create<AddPtrOp>(loc, ptrTy, record,
+                                       createI32(builder, loc, offset));
+  return builder.create<BitcastOp>(
+      loc, PointerType::get(elemTy, ptrTy.getAddressSpace()), ptr);
+}
+
+// Applies the combine region of `op` to the scalars `lhs` and `rhs`.
+SmallVector<Value> createCombine(OpBuilder &builder, CrossProgramScanOp op,
+                                 ValueRange lhs, ValueRange rhs) {
+  Block &combineBlock = op.getCombineOp().front();
+  IRMapping mapping;
+  mapping.map(combineBlock.getArguments().take_front(lhs.size()), lhs);
+  mapping.map(combineBlock.getArguments().drop_front(lhs.size()), rhs);
+  for (Operation &combineOp : combineBlock.without_terminator())
+    builder.clone(combineOp, mapping);
+  return llvm::map_to_vector(
+      combineBlock.getTerminator()->getOperands(),
+      [&](Value value) { return mapping.lookupOrDefault(value); });
+}
+
+// Scans `srcs` along `axis` with the combine region of `op`.
+ScanOp createScan(OpBuilder &builder, CrossProgramScanOp op, ValueRange srcs,
+                  int axis) {
+  auto scanOp =
+      builder.create<ScanOp>(op.getLoc(), srcs, axis, /*reverse=*/false);
+  IRMapping mapping;
+  op.getCombineOp().cloneInto(&scanOp.getCombineOp(), mapping);
+  return scanOp;
+}
+
+// Returns the last element of each of the 1D tensors `values`, which is
+// selected by a reduction keeping the element with the largest index.
+SmallVector<Value> createLastElements(OpBuilder &builder, Location loc,
+                                      ValueRange values) {
+  auto tensorTy = cast<RankedTensorType>(values[0].getType());
+  auto indexTy = RankedTensorType::get(
+      tensorTy.getShape(), builder.getI32Type(), tensorTy.getEncoding());
+  SmallVector<Value> srcs{
+      builder.create<MakeRangeOp>(loc, indexTy, 0, tensorTy.getShape()[0])};
+  srcs.append(values.begin(), values.end());
+  auto reduceOp = builder.create<ReduceOp>(loc, srcs, /*axis=*/0);
+
+  SmallVector<Type> elemTys = llvm::map_to_vector(
+      srcs, [](Value src) { return getElementTypeOrSelf(src); });
+  SmallVector<Type> argTys(elemTys);
+  argTys.append(elemTys.begin(), elemTys.end());
+  SmallVector<Location> argLocs(argTys.size(), loc);
+  OpBuilder::InsertionGuard guard(builder);
+  Block *block =
+      builder.createBlock(&reduceOp.getCombineOp(), {}, argTys, argLocs);
+  unsigned numSrcs = srcs.size();
+  Value isLater = builder.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::sgt, block->getArgument(0),
+      block->getArgument(numSrcs));
+  SmallVector<Value> results;
+  for (unsigned i = 0; i < numSrcs; ++i) {
+    results.push_back(builder.create<arith::SelectOp>(
+        loc, isLater, block->getArgument(i), block->getArgument(numSrcs + i)));
+  }
+  builder.create<ReduceReturnOp>(loc, results);
+  return llvm::to_vector(reduceOp.getResults().drop_front());
+}
+
+// Spins until the status flag at `flagPtr` is set and returns it. The acquire
+// orders the loads of the published values after the flag.
+Value createWaitForStatus(OpBuilder &builder, Location loc, Value flagPtr) {
+  Type i32Ty = builder.getI32Type();
+  auto whileOp = builder.create<scf::WhileOp>(loc, TypeRange{i32Ty},
+                                              ValueRange{});
+  OpBuilder::InsertionGuard guard(builder);
+  builder.createBlock(&whileOp.getBefore());
+  Value status = builder.create<AtomicRMWOp>(
+      loc, i32Ty, RMWOp::ADD, flagPtr, createI32(builder, loc, 0),
+      /*mask=*/Value(), MemSemantic::ACQUIRE, MemSyncScope::GPU);
+  Value notReady = builder.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::eq, status,
+      createI32(builder, loc, ScanStatus::NotReady));
+  builder.create<scf::ConditionOp>(loc, notReady, status);
+  builder.createBlock(&whileOp.getAfter(), {}, {i32Ty}, {loc});
+  builder.create<scf::YieldOp>(loc);
+  return whileOp.getResult(0);
+}
+
+// Combines the values published by the predecessors of the program, from the
+// nearest one backwards, until one of them has published its inclusive
+// prefix. Returns the exclusive prefix of the program.
+SmallVector<Value> createLookBack(OpBuilder &builder, CrossProgramScanOp op,
+                                  Value workspace, Value recordIdx) {
+  Location loc = op.getLoc();
+  unsigned numOperands = op.getSrcs().size();
+  SmallVector<Type> elemTys = op.getElementTypes();
+  Value start = builder.create<arith::SubIOp>(loc, recordIdx,
+                                              createI32(builder, loc, 1));
+
+  // The state of the loop is the record to look at, whether an inclusive
+  // prefix has been combined, and the combined values, which are only valid
+  // after the first iteration.
+  SmallVector<Value> inits{start, builder.create<arith::ConstantIntOp>(
+                                      loc, /*value=*/0, /*width=*/1)};
+  for (Type elemTy : elemTys) {
+    inits.push_back(builder.create<arith::ConstantOp>(
+        loc, elemTy, builder.getZeroAttr(elemTy)));
+  }
+  SmallVector<Type> stateTys = llvm::to_vector(ValueRange(inits).getTypes());
+  SmallVector<Location> stateLocs(stateTys.size(), loc);
+  auto whileOp = builder.create<scf::WhileOp>(loc, stateTys, inits);
+
+  OpBuilder::InsertionGuard guard(builder);
+  Block *before =
+      builder.createBlock(&whileOp.getBefore(), {}, stateTys, stateLocs);
+  Value notDone = builder.create<arith::XOrIOp>(
+      loc, before->getArgument(1),
+      builder.create<arith::ConstantIntOp>(loc, /*value=*/1, /*width=*/1));
+  builder.create<scf::ConditionOp>(loc, notDone, before->getArguments());
+
+  Block *after =
+      builder.createBlock(&whileOp.getAfter(), {}, stateTys, stateLocs);
+  Value idx = after->getArgument(0);
+  Value record = builder.create<AddPtrOp>(
+      loc, workspace.getType(), workspace,
+      builder.create<arith::MulIOp>(
+          loc, idx, createI32(builder, loc, getRecordBytes(numOperands))));
+  Value status = createWaitForStatus(
+      builder, loc,
+      createSlotPtr(builder, loc, record, 0, builder.getI32Type()));
+  Value hasPrefix = builder.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::eq, status,
+      createI32(builder, loc, ScanStatus::PrefixReady));
+  SmallVector<Value> values;
+  for (auto [i, elemTy] : llvm::enumerate(elemTys)) {
+    Value ptr = builder.create<arith::SelectOp>(
+        loc, hasPrefix,
+        createSlotPtr(builder, loc, record, getPrefixOffset(i), elemTy),
+        createSlotPtr(builder, loc, record, getAggregateOffset(i), elemTy));
+    values.push_back(builder.create<LoadOp>(loc, ptr, CacheModifier::NONE,
+                                            EvictionPolicy::NORMAL,
+                                            /*isVolatile=*/true));
+  }
+  // The values of the predecessor precede the ones combined so far.
+  SmallVector<Value> combined =
+      createCombine(builder, op, values, after->getArguments().drop_front(2));
+  Value isFirst = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                                idx, start);
+  SmallVector<Value> yields{
+      builder.create<arith::SubIOp>(loc, idx, createI32(builder, loc, 1)),
+      hasPrefix};
+  for (auto [value, acc] : llvm::zip(values, combined))
+    yields.push_back(
+        builder.create<arith::SelectOp>(loc, isFirst, value, acc));
+  builder.create<scf::YieldOp>(loc, yields);
+
+  return llvm::to_vector(whileOp.getResults().drop_front(2));
+}
+
+// Lowers the cross program scan to a decoupled look-back scan:
+//
+//   local = scan(srcs)
+//   aggregate = local[-1]
+//   publish aggregate, or inclusive prefix if pid == 0
+//   if pid > 0:
+//     prefix = look back at the predecessors
+//     publish combine(prefix, aggregate) as inclusive prefix
+//     result = combine(prefix, local)
+//
+// Every program publishes its aggregate before it waits for its predecessors,
+// and `pid` is the tile id of the program, taken in the order the programs
+// start (see createTileId), so a program only waits for programs that have
+// started, whatever the order the hardware schedules them in.
+void lowerCrossProgramScan(CrossProgramScanOp op, Value pid) {
+  OpBuilder builder(op);
+  Location loc = op.getLoc();
+  unsigned numOperands = op.getSrcs().size();
+  SmallVector<Type> elemTys = op.getElementTypes();
+
+  ScanOp localScan = createScan(builder, op, op.getSrcs(), /*axis=*/0);
+  SmallVector<Value> local = llvm::to_vector(localScan.getResults());
+  SmallVector<Value> aggregate = createLastElements(builder, loc, local);
+
+  Type i32Ty = builder.getI32Type();
+  Value recordIdx = builder.create<arith::AddIOp>(
+      loc, pid,
+      builder.create<arith::MulIOp>(loc, createNumProgramsX(builder, loc),
+                                    createChainIdx(builder, loc)));
+
+  Value workspace = createI8Ptr(builder, loc, op.getWorkspace());
+  Value record = builder.create<AddPtrOp>(
+      loc, workspace.getType(), workspace,
+      builder.create<arith::MulIOp>(
+          loc, recordIdx,
+          createI32(builder, loc, getRecordBytes(numOperands))));
+  Value flagPtr = createSlotPtr(builder, loc, record, 0, i32Ty);
+  auto publish = [&](ValueRange values, Value isPrefix, Value status) {
+    for (auto [i, value] : llvm::enumerate(values)) {
+      Type elemTy = elemTys[i];
+      Value ptr = builder.create<arith::SelectOp>(
+          loc, isPrefix,
+          createSlotPtr(builder, loc, record, getPrefixOffset(i), elemTy),
+          createSlotPtr(builder, loc, record, getAggregateOffset(i), elemTy));
+      builder.create<StoreOp>(loc, ptr, value, CacheModifier::NONE,
+                              EvictionPolicy::NORMAL);
+    }
+    // The release orders the stores of the values before the flag.
+    builder.create<AtomicRMWOp>(loc, i32Ty, RMWOp::XCHG, flagPtr, status,
+                                /*mask=*/Value(), MemSemantic::RELEASE,
+                                MemSyncScope::GPU);
+  };
+
+  // The aggregate of the first program is its inclusive prefix.
+  Value isFirstProgram = builder.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::eq, pid, createI32(builder, loc, 0));
+  publish(aggregate, isFirstProgram,
+          builder.create<arith::SelectOp>(
+              loc, isFirstProgram,
+              createI32(builder, loc, ScanStatus::PrefixReady),
+              createI32(builder, loc, ScanStatus::AggregateReady)));
+
+  auto ifOp = builder.create<scf::IfOp>(
+      loc, elemTys,
+      builder.create<arith::XOrIOp>(
+          loc, isFirstProgram,
+          builder.create<arith::ConstantIntOp>(loc, /*value=*/1,
+                                               /*width=*/1)),
+      /*withElseRegion=*/true);
+  {
+    OpBuilder::InsertionGuard guard(builder);
+    builder.setInsertionPointToStart(ifOp.thenBlock());
+    SmallVector<Value> prefix =
+        createLookBack(builder, op, workspace, recordIdx);
+    Value isPrefix = builder.create<arith::ConstantIntOp>(loc, /*value=*/1,
+                                                          /*width=*/1);
+    publish(createCombine(builder, op, prefix, aggregate), isPrefix,
+            createI32(builder, loc, ScanStatus::PrefixReady));
+    builder.create<scf::YieldOp>(loc, prefix);
+
+    // The first program has no prefix, its result is the local scan.
+    builder.setInsertionPointToStart(ifOp.elseBlock());
+    SmallVector<Value> zeros;
+    for (Type elemTy : elemTys) {
+      zeros.push_back(builder.create<arith::ConstantOp>(
+          loc, elemTy, builder.getZeroAttr(elemTy)));
+    }
+    builder.create<scf::YieldOp>(loc, zeros);
+  }
+
+  // Combine the prefix with every element by scanning the pairs
+  // (prefix, local[i]), which applies the combine region in the right order
+  // without an identity.
+  SmallVector<Value> pairs;
+  for (auto [prefix, value] : llvm::zip(ifOp.getResults(), local)) {
+    Value splat = builder.create<SplatOp>(loc, value.getType(), prefix);
+    pairs.push_back(builder.create<JoinOp>(loc, splat, value));
+  }
+  ScanOp pairScan = createScan(builder, op, pairs, /*axis=*/1);
+  SmallVector<Value> results;
+  for (auto [scanned, value] : llvm::zip(pairScan.getResults(), local)) {
+    Value combined = builder.create<SplitOp>(loc, scanned).getOutRHS();
+    results.push_back(builder.create<arith::SelectOp>(loc, isFirstProgram,
+                                                      value, combined));
+  }
+  op->replaceAllUsesWith(results);
+  op.erase();
+}
+
+// Takes the tile id of the program from the counter of its chain in the
+// workspace of `op`, at the entry of `funcOp`, and replaces the program id
+// along axis 0 with it. The programs along axis 0 are interchangeable, so
+// this only renames them, in the order they start.
+FailureOr<Value> createTileId(FuncOp funcOp, CrossProgramScanOp op) {
+  Block &entry = funcOp.getBody().front();
+  auto workspaceArg = dyn_cast<BlockArgument>(op.getWorkspace());
+  if (!workspaceArg || workspaceArg.getOwner() != &entry) {
+    op.emitOpError("requires the workspace to be an argument of the kernel");
+    return failure();
+  }
+
+  SmallVector<GetProgramIdOp> programIdOps;
+  funcOp.walk([&](GetProgramIdOp programIdOp) {
+    if (programIdOp.getAxis() == ProgramIDDim::X)
+      programIdOps.push_back(programIdOp);
+  });
+
+  OpBuilder builder = OpBuilder::atBlockBegin(&entry);
+  Location loc = op.getLoc();
+  Type i32Ty = builder.getI32Type();
+  Value workspace = createI8Ptr(builder, loc, workspaceArg);
+  Value chainIdx = createChainIdx(builder, loc);
+  Value firstRecordIdx = builder.create<arith::MulIOp>(
+      loc, chainIdx, createNumProgramsX(builder, loc));
+  Value chainRecord = builder.create<AddPtrOp>(
+      loc, workspace.getType(), workspace,
+      builder.create<arith::MulIOp>(
+          loc, firstRecordIdx,
+          createI32(builder, loc, getRecordBytes(op.getSrcs().size()))));
+  Value tileId = builder.create<AtomicRMWOp>(
+      loc, i32Ty, RMWOp::ADD,
+      createSlotPtr(builder, loc, chainRecord, kTileCounterOffset, i32Ty),
+      createI32(builder, loc, 1), /*mask=*/Value(), MemSemantic::RELAXED,
+      MemSyncScope::GPU);
+  for (GetProgramIdOp programIdOp : programIdOps) {
+    programIdOp.replaceAllUsesWith(tileId);
+    programIdOp.erase();
+  }
+  return tileId;
+}
+
+class LowerCrossProgramScanPass
+    : public ::impl::TritonLowerCrossProgramScanBase<
+          LowerCrossProgramScanPass> {
+public:
+  void runOnOperation() override {
+    getOperation().walk([&](FuncOp funcOp) {
+      SmallVector<CrossProgramScanOp> scanOps;
+      funcOp.walk(
+          [&](CrossProgramScanOp scanOp) { scanOps.push_back(scanOp); });
+      if (scanOps.empty())
+        return;
+      // Each scan publishes the records of its programs in its workspace, so
+      // two scans can't share one.
+      DenseMap<Value, CrossProgramScanOp> scanOfWorkspace;
+      for (CrossProgramScanOp scanOp : scanOps) {
+        auto [it, inserted] =
+            scanOfWorkspace.try_emplace(scanOp.getWorkspace(), scanOp);
+        if (!inserted) {
+          scanOp.emitOpError("shares its workspace with another scan")
+                  .attachNote(it->second.getLoc())
+              << "the other scan";
+          return signalPassFailure();
+        }
+      }
+      // All the scans of the kernel share the tile ids of the first one.
+      FailureOr<Value> tileId = createTileId(funcOp, scanOps.front());
+      if (failed(tileId))
+        return signalPassFailure();
+      for (CrossProgramScanOp scanOp : scanOps)
+        lowerCrossProgramScan(scanOp, *tileId);
+    });
+  }
+};
+
+} // namespace
+
+std::unique_ptr<mlir::Pass> createLowerCrossProgramScanPass() {
+  return std::make_unique<LowerCrossProgramScanPass>();
+}
+
+} // namespace mlir::triton
@@ -7,10 +7,19 @@
 #include "triton/Tools/LinearLayout.h"
 #include "triton/Tools/StrUtil.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MathExtras.h"
 
+#include <mutex>
+#include <shared_mutex>
+
+#define DEBUG_TYPE "linear-layout-conversions"
+
+STATISTIC(NumCacheHits, "Number of linear layouts found in the cache");
+STATISTIC(NumCacheMisses, "Number of linear layouts computed");
+
 namespace mlir::triton::gpu {
 namespace {
 
@@ -737,11 +746,9 @@ LinearLayout sharedToLinearLayoutLeadingOffset(ArrayRef<int64_t> shape,
   return combineCtaCgaWithShape(tileLayout, shared.getCTALayout(), shape);
 }
 
-} // anonymous namespace
-
 std::optional<LinearLayout>
-toLinearLayout(ArrayRef<int64_t> shape, Attribute layout,
-               std::optional<int32_t> elemBitWidth /*= std::nullopt*/) {
+toLinearLayoutImpl(ArrayRef<int64_t> shape, Attribute layout,
+                   std::optional<int32_t> elemBitWidth) {
   if (auto blocked = dyn_cast<BlockedEncodingAttr>(layout)) {
     return blockedToLinearLayout(shape, blocked);
   }
@@ -775,4 +782,74 @@ toLinearLayout(ArrayRef<int64_t> shape, Attribute layout,
   return std::nullopt;
 }
 
+// Only shared layouts with a leading offset depend on the element bit width,
+// dropping it from the other keys lets all element types share their entries.
+std::optional<int32_t> getCacheBitWidth(Attribute layout,
+                                        std::optional<int32_t> elemBitWidth) {
+  auto shared = dyn_cast<SharedEncodingAttr>(layout);
+  if (!shared || !shared.getHasLeadingOffset())
+    return std::nullopt;
+  return elemBitWidth;
+}
+
+std::optional<LinearLayout>
+getOrCompute(LinearLayoutCache::Key key,
+             function_ref<std::optional<LinearLayout>()> compute) {
+  auto *dialect = key.layout.getContext()->getLoadedDialect<TritonGPUDialect>();
+  if (!dialect)
+    return compute();
+  return dialect->llCache.getOrCompute(key, compute);
+}
+
+} // anonymous namespace
+
+const std::optional<LinearLayout> &LinearLayoutCache::getOrCompute(
+    const Key &key, function_ref<std::optional<LinearLayout>()> compute) {
+  {
+    std::shared_lock lock(mutex);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+      ++NumCacheHits;
+      return it->second;
+    }
+  }
+  // Compute outside of the lock, the conversions may look up other layouts.
+  // Another thread may have inserted the same key in the meantime, in which
+  // case its result is kept.
+  ++NumCacheMisses;
+  std::optional<LinearLayout> result = compute();
+  std::scoped_lock lock(mutex);
+  return cache.try_emplace(key, std::move(result)).first->second;
+}
+
+std::optional<LinearLayout>
+toLinearLayout(ArrayRef<int64_t> shape, Attribute layout,
+               std::optional<int32_t> elemBitWidth /*= std::nullopt*/) {
+  elemBitWidth = getCacheBitWidth(layout, elemBitWidth);
+  return getOrCompute(
+      {llvm::to_vector(shape), layout, /*dstLayout=*/{}, elemBitWidth},
+      [&] { return toLinearLayoutImpl(shape, layout, elemBitWidth); });
+}
+
+std::optional<LinearLayout>
+toLinearLayoutConversion(ArrayRef<int64_t> shape, Attribute srcLayout,
+                         Attribute dstLayout,
+                         std::optional<int32_t> elemBitWidth) {
+  // The bit width only matters if one of the layouts depends on it.
+  if (!getCacheBitWidth(srcLayout, elemBitWidth) &&
+      !getCacheBitWidth(dstLayout, elemBitWidth))
+    elemBitWidth = std::nullopt;
+  return getOrCompute(
+      {llvm::to_vector(shape), srcLayout, dstLayout, elemBitWidth},
+      [&]() -> std::optional<LinearLayout> {
+        std::optional<LinearLayout> src =
+            toLinearLayout(shape, srcLayout, elemBitWidth);
+        std::optional<LinearLayout> dst =
+            toLinearLayout(shape, dstLayout, elemBitWidth);
+        if (!src.has_value() || !dst.has_value())
+          return std::nullopt;
+        return src->invertAndCompose(*dst);
+      });
+}
+
 } // namespace mlir::triton::gpu
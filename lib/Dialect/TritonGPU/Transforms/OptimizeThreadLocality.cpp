@@ -6,6 +6,7 @@
 #include "mlir/Support/LLVM.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "mlir/Transforms/Passes.h"
+#include "triton/Analysis/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
 #include "triton/Dialect/TritonGPU/Transforms/Passes.h"
 #include "triton/Dialect/TritonGPU/Transforms/Utility.h"
@@ -90,6 +91,98 @@ struct OptimizeReshapeLayoutPattern
   }
 };
 
+// Merge a reduction with an earlier independent reduction of the same shape
+// and layout along the same axis into a single reduction of all their
+// operands, so that the partial results of the warps of both go through the
+// same scratch buffer and barriers.
+struct CombineReductionsPattern
+    : public mlir::OpRewritePattern<triton::ReduceOp> {
+  CombineReductionsPattern(mlir::MLIRContext *context)
+      : OpRewritePattern<triton::ReduceOp>(context, 1) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(triton::ReduceOp reduceOp,
+                  mlir::PatternRewriter &rewriter) const override {
+    // Reductions within a warp don't synchronize between warps.
+    if (ReduceOpHelper(reduceOp).isWarpSynchronous())
+      return failure();
+    triton::ReduceOp prevOp;
+    for (Operation *op = reduceOp->getPrevNode(); op; op = op->getPrevNode()) {
+      auto candidate = dyn_cast<triton::ReduceOp>(op);
+      if (candidate && canCombine(candidate, reduceOp)) {
+        prevOp = candidate;
+        break;
+      }
+    }
+    if (!prevOp)
+      return failure();
+
+    // The combined reduction takes the place of the later one, the operands
+    // of both are defined before it.
+    SmallVector<Value> srcs = llvm::to_vector(prevOp.getSrcs());
+    srcs.append(reduceOp.getSrcs().begin(), reduceOp.getSrcs().end());
+    unsigned numPrevSrcs = prevOp.getSrcs().size();
+    unsigned numSrcs = srcs.size();
+    rewriter.setInsertionPoint(reduceOp);
+    auto newReduce = rewriter.create<triton::ReduceOp>(reduceOp.getLoc(), srcs,
+                                                       reduceOp.getAxis());
+
+    // The combine region takes the accumulators of both reductions followed by
+    // their current values, and runs the two combine functions side by side.
+    SmallVector<Type> argTypes;
+    for (int i = 0; i < 2; ++i) {
+      for (Type elemTy : newReduce.getElementTypes())
+        argTypes.push_back(elemTy);
+    }
+    SmallVector<Location> argLocs(argTypes.size(), reduceOp.getLoc());
+    Block *block = rewriter.createBlock(&newReduce.getCombineOp(), {},
+                                        argTypes, argLocs);
+    SmallVector<Value> results;
+    auto cloneCombineOp = [&](triton::ReduceOp op, unsigned offset) {
+      Block &oldBlock = op.getCombineOp().front();
+      unsigned numOpSrcs = op.getSrcs().size();
+      IRMapping mapping;
+      for (unsigned i = 0; i < numOpSrcs; ++i) {
+        mapping.map(oldBlock.getArgument(i), block->getArgument(offset + i));
+        mapping.map(oldBlock.getArgument(numOpSrcs + i),
+                    block->getArgument(numSrcs + offset + i));
+      }
+      for (Operation &oldOp : oldBlock.without_terminator())
+        rewriter.clone(oldOp, mapping);
+      for (Value result : oldBlock.getTerminator()->getOperands())
+        results.push_back(mapping.lookupOrDefault(result));
+    };
+    cloneCombineOp(prevOp, 0);
+    cloneCombineOp(reduceOp, numPrevSrcs);
+    rewriter.create<triton::ReduceReturnOp>(reduceOp.getLoc(), results);
+
+    rewriter.replaceOp(prevOp, newReduce.getResult().take_front(numPrevSrcs));
+    rewriter.replaceOp(reduceOp, newReduce.getResult().drop_front(numPrevSrcs));
+    return mlir::success();
+  }
+
+private:
+  // The earlier reduction can be delayed to the later one if none of its
+  // results is used before it, which also excludes the later reduction
+  // depending on the earlier one.
+  bool canCombine(triton::ReduceOp prevOp, triton::ReduceOp reduceOp) const {
+    if (prevOp.getAxis() != reduceOp.getAxis())
+      return false;
+    auto prevType = prevOp.getInputTypes()[0];
+    auto type = reduceOp.getInputTypes()[0];
+    if (prevType.getShape() != type.getShape() ||
+        prevType.getEncoding() != type.getEncoding())
+      return false;
+    Block *block = reduceOp->getBlock();
+    for (Operation *user : prevOp->getUsers()) {
+      Operation *ancestor = block->findAncestorOpInBlock(*user);
+      if (!ancestor || !reduceOp->isBeforeInBlock(ancestor))
+        return false;
+    }
+    return true;
+  }
+};
+
 } // namespace
 
 class TritonGPUOptimizeThreadLocalityPass
@@ -226,6 +319,14 @@ class TritonGPUOptimizeThreadLocalityPass
       oldYield.erase();
       forOp.erase();
     }
+
+    // Finally share the synchronization of independent reductions.
+    mlir::RewritePatternSet combinePatterns(&getContext());
+    combinePatterns.add<CombineReductionsPattern>(&getContext());
+    if (mlir::applyPatternsAndFoldGreedily(mod, std::move(combinePatterns))
+            .failed()) {
+      signalPassFailure();
+    }
   };
 
 private:
@@ -530,10 +530,8 @@ assignMemoryLayouts(llvm::SmallVector<std::tuple<Operation *, int, Operation *>>
 
 static llvm::MapVector<Operation *, LoadInfo>
 scheduleLoads(scf::ForOp forOp, tt::CoarseSchedule &schedule,
-              DenseSet<Operation *> &rootUsers, int numStages) {
-  ModuleOp moduleOp = forOp->getParentOfType<ModuleOp>();
-  tt::ModuleAxisInfoAnalysis axisInfoAnalysis(moduleOp);
-
+              DenseSet<Operation *> &rootUsers, int numStages,
+              tt::ModuleAxisInfoAnalysis &axisInfoAnalysis) {
   // Get all loads that are (transitively) used by dot ops and their distance
   // to the dot op.
   llvm::SmallVector<std::tuple<Operation *, int, Operation *>>
@@ -1062,17 +1060,14 @@ static void invalidateBarriers(OpBuilder &builder,
   }
 }
 
-bool mlir::triton::preProcessLoopAndGetSchedule(
-    scf::ForOp &forOp, int numStages, mlir::triton::PipeliningOption &options) {
-  // Schedule the loads and root ops (dot ops) in the loop. This will give us
-  // a scaffold for the final schedule.
-  DenseSet<Operation *> rootUsers;
-  tt::CoarseSchedule coarseSchedule(numStages);
-  llvm::MapVector<Operation *, LoadInfo> loadToInfo =
-      scheduleLoads(forOp, coarseSchedule, rootUsers, numStages);
-  if (loadToInfo.empty())
-    return false;
-
+// Convert the scheduled loads into async loads, complete the schedule of the
+// loop around them and fill out the pipeline options.
+static void
+createAsyncLoadsAndSchedule(scf::ForOp &forOp,
+                            tt::CoarseSchedule &coarseSchedule,
+                            llvm::MapVector<Operation *, LoadInfo> &loadToInfo,
+                            DenseSet<Operation *> &rootUsers, int numStages,
+                            mlir::triton::PipeliningOption &options) {
   LLVM_DEBUG({
     LDBG("Coarse schedule loads only:");
     coarseSchedule.dump();
@@ -1139,6 +1134,263 @@ bool mlir::triton::preProcessLoopAndGetSchedule(
   // Explicitly deallocate allocated tensors after the wait op
   for (auto alloc : allocs)
     builder.create<ttg::LocalDeallocOp>(forOp.getLoc(), alloc);
+}
+
+bool mlir::triton::preProcessLoopAndGetSchedule(
+    scf::ForOp &forOp, int numStages,
+    mlir::triton::ModuleAxisInfoAnalysis &axisInfoAnalysis,
+    mlir::triton::PipeliningOption &options) {
+  // Schedule the loads and root ops (dot ops) in the loop. This will give us
+  // a scaffold for the final schedule.
+  DenseSet<Operation *> rootUsers;
+  tt::CoarseSchedule coarseSchedule(numStages);
+  llvm::MapVector<Operation *, LoadInfo> loadToInfo =
+      scheduleLoads(forOp, coarseSchedule, rootUsers, numStages,
+                    axisInfoAnalysis);
+  if (loadToInfo.empty())
+    return false;
+
+  createAsyncLoadsAndSchedule(forOp, coarseSchedule, loadToInfo, rootUsers,
+                              numStages, options);
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Streaming loops
+//
+// Loops without dot ops are pipelined with a latency-driven modulo schedule.
+// Each load is issued as many iterations ahead of its consumers as needed for
+// the work of the iterations in between to cover the latency of global memory,
+// bounded by the number of stages and by the shared memory of the buffers.
+//===----------------------------------------------------------------------===//
+
+namespace {
+// Rough latencies in cycles used to estimate the initiation interval of the
+// loop. Ops are assumed to issue once per element they hold in each thread.
+constexpr int64_t kGlobalLoadLatency = 600;
+constexpr int64_t kExpensiveOpCost = 4;
+constexpr int64_t kReduceLatency = 64;
+// Upper bound on the shared memory of the buffers of a streaming loop.
+constexpr int64_t kMaxStreamingSharedMemory = 64 * 1024;
+} // namespace
+
+static int64_t getElemsPerThread(Type type) {
+  auto tensorTy = dyn_cast<RankedTensorType>(type);
+  if (!tensorTy ||
+      !isa_and_nonnull<ttg::DistributedEncodingTrait>(tensorTy.getEncoding()))
+    return 1;
+  return ttg::getTotalElemsPerThread(tensorTy);
+}
+
+// Estimate the number of cycles a warp needs to issue the op.
+static int64_t getIssueCycles(Operation *op) {
+  int64_t elems = 1;
+  for (Type type : op->getOperandTypes())
+    elems = std::max(elems, getElemsPerThread(type));
+  for (Type type : op->getResultTypes())
+    elems = std::max(elems, getElemsPerThread(type));
+  if (isa<tt::ReduceOp, tt::ScanOp>(op))
+    return elems + kReduceLatency;
+  if (isa<tt::PreciseSqrtOp, tt::PreciseDivFOp, tt::ExternElementwiseOp>(op) ||
+      isa<math::MathDialect>(op->getDialect()))
+    return elems * kExpensiveOpCost;
+  return elems;
+}
+
+// Estimate the number of cycles between the starts of two iterations of the
+// loop once the given loads are asynchronous.
+static int64_t estimateInitiationInterval(
+    scf::ForOp forOp, const llvm::MapVector<Operation *, LoadInfo> &loads) {
+  int64_t cycles = 0;
+  forOp.getBody()->walk<WalkOrder::PreOrder>([&](Operation *op) {
+    if (loads.count(op) || op->hasTrait<OpTrait::IsTerminator>())
+      return WalkResult::advance();
+    cycles += getIssueCycles(op);
+    // The combine regions are accounted for in the latency of the op.
+    if (isa<tt::ReduceOp, tt::ScanOp>(op))
+      return WalkResult::skip();
+    return WalkResult::advance();
+  });
+  return std::max<int64_t>(cycles, 1);
+}
+
+// Return true if the load only feeds elementwise ops and reductions of the
+// loop body, which can consume it iterations after it was issued.
+static bool isStreamingLoad(tt::LoadOp loadOp, scf::ForOp forOp) {
+  if (!isa<RankedTensorType>(loadOp.getType()) || loadOp->use_empty())
+    return false;
+  return llvm::all_of(loadOp->getUsers(), [&](Operation *user) {
+    return user->getBlock() == forOp.getBody() &&
+           (user->hasTrait<OpTrait::Elementwise>() ||
+            isa<tt::ReduceOp, ttg::ConvertLayoutOp>(user));
+  });
+}
+
+// Return true if the operands of the load depend on a memory access of a
+// previous iteration, in which case it cannot be issued ahead of it.
+static bool dependsOnPreviousIteration(tt::LoadOp loadOp, scf::ForOp forOp) {
+  Block *body = forOp.getBody();
+  SmallVector<std::pair<Value, bool>> worklist;
+  // Values already visited within the iteration of the load and across it.
+  DenseSet<Value> seen[2];
+  for (Value operand : loadOp->getOperands())
+    worklist.push_back({operand, /*crossedIteration=*/false});
+  while (!worklist.empty()) {
+    Value v;
+    bool crossedIteration;
+    std::tie(v, crossedIteration) = worklist.pop_back_val();
+    if (!seen[crossedIteration].insert(v).second)
+      continue;
+    if (auto arg = dyn_cast<BlockArgument>(v)) {
+      if (arg.getOwner() == body && arg.getArgNumber() > 0)
+        worklist.push_back(
+            {body->getTerminator()->getOperand(arg.getArgNumber() - 1), true});
+      continue;
+    }
+    Operation *defOp = body->findAncestorOpInBlock(*v.getDefiningOp());
+    if (!defOp)
+      continue;
+    if (crossedIteration &&
+        isa<tt::LoadOp, tt::AtomicRMWOp, tt::AtomicCASOp>(defOp))
+      return true;
+    defOp->walk([&](Operation *nestedOp) {
+      for (Value operand : nestedOp->getOperands())
+        worklist.push_back({operand, crossedIteration});
+    });
+  }
+  return false;
+}
+
+// Return true if the loop writes global memory. Without alias information, a
+// load issued iterations ahead may then read memory before an iteration in
+// between writes it, e.g. in in-place updates and recurrences.
+static bool writesGlobalMemory(scf::ForOp forOp) {
+  return forOp->walk([](Operation *op) {
+               // The effects of ops with regions are those of the nested ops,
+               // which are visited too. Ops with unknown effects, e.g. calls,
+               // may write anywhere.
+               auto memEffects = dyn_cast<MemoryEffectOpInterface>(op);
+               if (!memEffects)
+                 return op->hasTrait<OpTrait::HasRecursiveMemoryEffects>()
+                            ? WalkResult::advance()
+                            : WalkResult::interrupt();
+               SmallVector<MemoryEffects::EffectInstance> effects;
+               memEffects.getEffects(effects);
+               bool writes = llvm::any_of(effects, [](auto &effect) {
+                 return isa<MemoryEffects::Write>(effect.getEffect()) &&
+                        effect.getResource() == tt::GlobalMemory::get();
+               });
+               return writes ? WalkResult::interrupt()
+                             : WalkResult::advance();
+             })
+      .wasInterrupted();
+}
+
+bool mlir::triton::preProcessStreamingLoopAndGetSchedule(
+    scf::ForOp &forOp, int numStages,
+    mlir::triton::ModuleAxisInfoAnalysis &axisInfoAnalysis,
+    mlir::triton::PipeliningOption &options) {
+  // Loops with dot ops are left to the schedule built around the dots.
+  if (forOp
+          ->walk([](Operation *op) {
+            return op->hasTrait<OpTrait::DotLike>() ? WalkResult::interrupt()
+                                                    : WalkResult::advance();
+          })
+          .wasInterrupted())
+    return false;
+  if (writesGlobalMemory(forOp))
+    return false;
+
+  SmallVector<tt::LoadOp> loads;
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    auto loadOp = dyn_cast<tt::LoadOp>(op);
+    if (loadOp && isStreamingLoad(loadOp, forOp) &&
+        !dependsOnPreviousIteration(loadOp, forOp))
+      loads.push_back(loadOp);
+  }
+
+  // The indirection level of a load is the number of loads between it and the
+  // consumers in the same iteration. The loads are visited from the back of
+  // the loop so that the loads using a load are visited before it.
+  DenseMap<Operation *, int> loadToLevel;
+  llvm::SmallVector<std::tuple<Operation *, int, Operation *>>
+      loadOpToIndLevelAndUse;
+  for (tt::LoadOp loadOp : llvm::reverse(loads)) {
+    SetVector<Operation *> forwardSlice;
+    getForwardSlice(loadOp.getResult(), &forwardSlice);
+    int level = 0;
+    Operation *use = *loadOp->getUsers().begin();
+    for (Operation *op : forwardSlice) {
+      auto it = loadToLevel.find(op);
+      if (it != loadToLevel.end() && it->second + 1 > level) {
+        level = it->second + 1;
+        use = op;
+      }
+    }
+    loadToLevel[loadOp] = level;
+    loadOpToIndLevelAndUse.push_back({loadOp, level, use});
+  }
+  if (loadOpToIndLevelAndUse.empty())
+    return false;
+
+  llvm::MapVector<Operation *, LoadInfo> loadToInfo =
+      assignMemoryLayouts(loadOpToIndLevelAndUse, axisInfoAnalysis);
+  if (loadToInfo.empty())
+    return false;
+
+  int maxIndirectionLevel = 0;
+  int64_t bytesPerIteration = 0;
+  for (auto [loadOp, level, use] : loadOpToIndLevelAndUse) {
+    if (loadToInfo.count(loadOp) == 0)
+      continue;
+    maxIndirectionLevel = std::max(maxIndirectionLevel, level);
+    auto ty = cast<RankedTensorType>(loadOp->getResultTypes()[0]);
+    bytesPerIteration +=
+        product(ty.getShape()) * ty.getElementTypeBitWidth() / 8;
+  }
+
+  // Issue the loads as many iterations ahead as needed to cover their latency
+  // with the iterations in between.
+  int64_t initiationInterval = estimateInitiationInterval(forOp, loadToInfo);
+  int64_t distance = ceil<int64_t>(kGlobalLoadLatency, initiationInterval);
+  distance =
+      std::min<int64_t>(distance, (numStages - 1) / (maxIndirectionLevel + 1));
+  distance = std::min<int64_t>(distance,
+                               kMaxStreamingSharedMemory / bytesPerIteration);
+  LDBG("Streaming loop with initiation interval "
+       << initiationInterval << " cycles, loads issued " << distance
+       << " iterations ahead");
+  if (distance < 1)
+    return false;
+
+  // The loads are only as many stages apart as their distance, which saves
+  // the buffers that a schedule over all the stages would need.
+  int loopNumStages = (maxIndirectionLevel + 1) * distance + 1;
+  DenseSet<Operation *> rootUsers;
+  tt::CoarseSchedule coarseSchedule(loopNumStages);
+  tt::CoarseSchedule::Cluster rootUsersCluster =
+      coarseSchedule.clusters.newAtFront();
+  for (auto [loadOp, level, use] : loadOpToIndLevelAndUse) {
+    if (loadToInfo.count(loadOp) == 0 || level != 0)
+      continue;
+    for (Operation *user : loadOp->getUsers()) {
+      coarseSchedule.insertIfAbsent(user, loopNumStages - 1, rootUsersCluster);
+      rootUsers.insert(user);
+    }
+  }
+  SmallVector<tt::CoarseSchedule::Cluster> loadsClusters;
+  for (int i = 0; i < maxIndirectionLevel + 1; i++)
+    loadsClusters.push_back(coarseSchedule.clusters.newAtBack());
+  for (auto [loadOp, level, use] : loadOpToIndLevelAndUse) {
+    if (loadToInfo.count(loadOp) == 0)
+      continue;
+    int stage = (maxIndirectionLevel - level) * distance;
+    coarseSchedule.insert(loadOp, stage, loadsClusters[level]);
+    loadToInfo[loadOp].distToUse = distance;
+  }
+
+  createAsyncLoadsAndSchedule(forOp, coarseSchedule, loadToInfo, rootUsers,
+                              loopNumStages, options);
   return true;
 }
 
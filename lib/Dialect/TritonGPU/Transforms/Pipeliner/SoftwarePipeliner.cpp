@@ -70,15 +70,20 @@ static void tryAndPipelineOuterLoop(scf::ForOp forOp) {
       mlir::triton::pipelineForLoop(rewriter, forOp, options);
 }
 
-static bool pipelineLoop(scf::ForOp forOp, int numStages) {
+static bool pipelineLoop(scf::ForOp forOp, int numStages,
+                         ModuleAxisInfoAnalysis &axisInfoAnalysis) {
   mlir::triton::PipeliningOption options;
   if (!preCondition(forOp))
     return false;
 
   bool foundSchedule = false;
-  foundSchedule = preProcessLoopAndGetSchedule(forOp, numStages, options);
+  foundSchedule =
+      preProcessLoopAndGetSchedule(forOp, numStages, axisInfoAnalysis, options);
+  // Loops whose loads don't feed a dot stream them through shared memory.
+  if (!foundSchedule)
+    foundSchedule = preProcessStreamingLoopAndGetSchedule(
+        forOp, numStages, axisInfoAnalysis, options);
 
-  // TODO: add more pipelines strategy.
   if (!foundSchedule)
     return false;
 
@@ -122,7 +127,20 @@ struct PipelinePass : public impl::TritonGPUPipelineBase<PipelinePass> {
     for (scf::ForOp forOp : loops) {
       auto outerLoop = dyn_cast<scf::ForOp>(forOp->getParentOp());
       int loopNumStages = getNumStagesOrDefault(forOp);
-      bool pipelined = pipelineLoop(forOp, loopNumStages);
+      // Pipelining a loop creates new values in and around it and replaces its
+      // results. The loops are visited in post-order, so the new values are
+      // only seen by the loops enclosing it or using its results. The analysis
+      // of the module is therefore only recomputed for those.
+      bool invalidatesAxisInfo =
+          forOp->getParentOfType<scf::ForOp>() ||
+          llvm::any_of(forOp->getUsers(), [](Operation *user) {
+            return user->getParentOfType<scf::ForOp>();
+          });
+      auto &axisInfoAnalysis =
+          ModuleAxisInfoAnalysis::get(getAnalysisManager());
+      bool pipelined = pipelineLoop(forOp, loopNumStages, axisInfoAnalysis);
+      if (invalidatesAxisInfo)
+        getAnalysisManager().invalidate(AnalysisManager::PreservedAnalyses());
       if (pipelined && outerLoop && getNumStagesOrDefault(outerLoop) > 1)
         outerLoops.insert(outerLoop);
     }
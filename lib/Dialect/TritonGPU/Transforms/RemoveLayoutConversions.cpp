@@ -36,6 +36,80 @@ namespace gpu {
 
 namespace {
 
+// Estimates the cost of layout conversions and of recomputing values in
+// another layout.  Costs are in units of one cheap ALU instruction on a 32-bit
+// register of every thread, summed over the whole tensor.
+class LayoutCostModel {
+public:
+  // Cost of converting a tensor of type `srcTy` to `dstEncoding`.
+  int64_t getConvertCost(RankedTensorType srcTy, Attribute dstEncoding);
+  // Cost of computing the results of `op` once more.
+  int64_t getRematCost(Operation *op);
+
+private:
+  DenseMap<std::pair<Type, Attribute>, int64_t> convertCosts;
+};
+
+// A store and a load of shared memory, per 32-bit register, which are slow to
+// issue and are often serialized by bank conflicts.
+constexpr int64_t kSharedMemoryCost = 32;
+// The barriers around the scratch buffer of a conversion through shared
+// memory, which stall all the warps.
+constexpr int64_t kBarrierCost = 256;
+// A warp shuffle, per 32-bit register.
+constexpr int64_t kShuffleCost = 4;
+// Instructions lowered to several instructions or to the special function
+// unit, per 32-bit register.  Loads are assumed to hit the L1 cache.
+constexpr int64_t kExpensiveOpCost = 8;
+
+int64_t getNumRegisters(RankedTensorType type) {
+  Type elemTy = type.getElementType();
+  unsigned bitWidth = isa<PointerType>(elemTy)
+                          ? 64
+                          : std::max(elemTy.getIntOrFloatBitWidth(), 1u);
+  return type.getNumElements() * llvm::divideCeil(bitWidth, 32);
+}
+
+int64_t LayoutCostModel::getConvertCost(RankedTensorType srcTy,
+                                        Attribute dstEncoding) {
+  if (srcTy.getEncoding() == dstEncoding)
+    return 0;
+  auto it = convertCosts.find({srcTy, dstEncoding});
+  if (it != convertCosts.end())
+    return it->second;
+  auto dstTy = RankedTensorType::get(srcTy.getShape(), srcTy.getElementType(),
+                                     dstEncoding);
+  // Conversions that only move data between the registers of a thread are
+  // free, the others go through warp shuffles or shared memory.
+  int64_t cost = 0;
+  if (!cvtReordersRegisters(srcTy, dstTy)) {
+    int64_t numRegisters = getNumRegisters(srcTy);
+    if (cvtNeedsSharedMemory(srcTy, dstTy))
+      cost = kSharedMemoryCost * numRegisters + 2 * kBarrierCost;
+    else
+      cost = kShuffleCost * numRegisters;
+  }
+  convertCosts[{srcTy, dstEncoding}] = cost;
+  return cost;
+}
+
+int64_t LayoutCostModel::getRematCost(Operation *op) {
+  if (isa<arith::ConstantOp, MakeRangeOp, SplatOp>(op))
+    return 0;
+  int64_t multiplier = 1;
+  if (isa<LoadOp, PreciseDivFOp, PreciseSqrtOp, ExternElementwiseOp,
+          arith::DivFOp, arith::DivSIOp, arith::DivUIOp, arith::RemFOp,
+          arith::RemSIOp, arith::RemUIOp>(op) ||
+      isa<math::MathDialect>(op->getDialect()))
+    multiplier = kExpensiveOpCost;
+  int64_t cost = 0;
+  for (Type type : op->getResultTypes()) {
+    if (auto tensorTy = dyn_cast<RankedTensorType>(type))
+      cost += multiplier * getNumRegisters(tensorTy);
+  }
+  return cost;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -80,6 +154,9 @@ public:
                    SmallVector<Value> &changed, Operation *op);
   // Resolve cases where a value has multiple layouts associated to it.
   void resolveConflicts();
+  // Estimate the cost of the conversions inserted by the rewrite if each value
+  // is given the layout returned by `getEncoding`.
+  int64_t getRewriteCost(function_ref<Attribute(Value)> getEncoding);
   // Rewrite the IR for the full module.
   void rewrite();
   // Rewrite the IR for a region.
@@ -111,6 +188,7 @@ private:
   DenseMap<std::pair<Value, Attribute>, Value> rewriteMapping;
   SetVector<Operation *> opToDelete;
   FuncOp funcOp;
+  LayoutCostModel costModel;
 };
 
 class LayoutRematerialization {
@@ -136,6 +214,8 @@ public:
                     ConvertLayoutOp convertOp, IRMapping &mapping);
   void rewriteSlice(SetVector<Value> &slice, DenseMap<Value, Attribute> &layout,
                     ConvertLayoutOp convertOp);
+  // Estimate the cost of the ops that rewriting `slice` duplicates.
+  int64_t getRematCost(SetVector<Value> &slice, ConvertLayoutOp convertOp);
 
 private:
   void updateRematMapping(SmallVector<std::tuple<Value, Value>> &values);
@@ -148,6 +228,7 @@ private:
   // DenseMap<std::pair<Operation*, Attribute>, Operation*>
   SetVector<Operation *> opToDelete;
   FuncOp funcOp;
+  LayoutCostModel costModel;
 };
 
 void LayoutRematerialization::addRematValue(Value old, Attribute encoding,
@@ -391,24 +472,123 @@ void LayoutPropagation::propagateLayout() {
   }
 }
 
+bool reduceToScalar(Operation *op) {
+  // For reductions returning a scalar we can change the src encoding without
+  // affecting the output.
+  return isa<ReduceOp>(op) && !isa<RankedTensorType>(op->getResultTypes()[0]);
+}
+
+int64_t
+LayoutPropagation::getRewriteCost(function_ref<Attribute(Value)> getEncoding) {
+  auto getEncodingAfterRewrite = [&](Value value) {
+    if (layouts.count(value))
+      return getEncoding(value);
+    return cast<RankedTensorType>(value.getType()).getEncoding();
+  };
+  // The encoding in which the rewrite uses the value of `use`, which mirrors
+  // rewriteOp and friends.
+  auto getUseEncoding = [&](OpOperand &use) -> Attribute {
+    Operation *user = use.getOwner();
+    unsigned idx = use.getOperandNumber();
+    if (auto forOp = dyn_cast<scf::ForOp>(user))
+      return getEncodingAfterRewrite(forOp.getTiedLoopResult(&use));
+    if (auto whileOp = dyn_cast<scf::WhileOp>(user))
+      return getEncodingAfterRewrite(whileOp.getBeforeArguments()[idx]);
+    if (auto yieldOp = dyn_cast<scf::YieldOp>(user)) {
+      Operation *parent = yieldOp->getParentOp();
+      if (isa<scf::ForOp, scf::IfOp>(parent))
+        return getEncodingAfterRewrite(parent->getResult(idx));
+      if (auto whileOp = dyn_cast<scf::WhileOp>(parent))
+        return getEncodingAfterRewrite(whileOp.getBeforeArguments()[idx]);
+    }
+    if (auto conditionOp = dyn_cast<scf::ConditionOp>(user)) {
+      auto whileOp = cast<scf::WhileOp>(conditionOp->getParentOp());
+      return getEncodingAfterRewrite(whileOp->getResult(idx - 1));
+    }
+    if (reduceToScalar(user) || isa<AssertOp>(user))
+      return getEncodingAfterRewrite(use.get());
+    Attribute encoding =
+        cast<RankedTensorType>(use.get().getType()).getEncoding();
+    if (user->getNumResults() == 0 || !layouts.count(user->getResult(0)))
+      return encoding;
+    Attribute dstEncoding = getEncoding(user->getResult(0));
+    if (isa<ConvertLayoutOp>(user))
+      return dstEncoding;
+    // Ops that fold into a conversion keep their operands.
+    if (canFoldIntoConversion(user, dstEncoding))
+      return encoding;
+    return inferSrcEncoding(user, dstEncoding).value_or(encoding);
+  };
+
+  int64_t cost = 0;
+  funcOp.walk([&](Operation *op) {
+    for (OpOperand &use : op->getOpOperands()) {
+      auto tensorType = dyn_cast<RankedTensorType>(use.get().getType());
+      if (!tensorType)
+        continue;
+      auto srcType = RankedTensorType::get(
+          tensorType.getShape(), tensorType.getElementType(),
+          getEncodingAfterRewrite(use.get()));
+      cost += costModel.getConvertCost(srcType, getUseEncoding(use));
+    }
+  });
+  return cost;
+}
+
 void LayoutPropagation::resolveConflicts() {
-  for (auto &it : layouts) {
-    Operation *op = it.first.getDefiningOp();
-    LayoutInfo &info = it.second;
-    if (info.encodings.size() <= 1)
-      continue;
-    // Hacky resolve, prefer block encoding.
-    // TODO: add a proper heuristic.
-    Attribute encoding = *info.encodings.begin();
+  // Hacky resolve, prefer block encoding for loads and stores and MMA encodings
+  // otherwise.
+  auto getPreferredEncoding = [&](Value value) {
+    LayoutInfo &info = layouts[value];
+    Operation *op = value.getDefiningOp();
     bool isLoadOrStore =
         op && isa<LoadOp, StoreOp, AtomicRMWOp, AtomicCASOp>(op);
     for (Attribute e : info.encodings) {
       if ((isLoadOrStore && isa<BlockedEncodingAttr>(e)) ||
-          (!isLoadOrStore && isa<MmaEncodingTrait>(e))) {
-        encoding = e;
-        break;
-      }
+          (!isLoadOrStore && isa<MmaEncodingTrait>(e)))
+        return e;
     }
+    return *info.encodings.begin();
+  };
+
+  SetVector<Attribute> candidates;
+  for (auto &it : layouts) {
+    LayoutInfo &info = it.second;
+    if (info.encodings.size() > 1)
+      candidates.insert(info.encodings.begin(), info.encodings.end());
+  }
+  if (candidates.empty())
+    return;
+
+  // Picking the cheapest encoding of each value independently would break the
+  // chains of values propagated from the same anchor, and searching all the
+  // assignments is exponential.  Instead, each encoding is tried as the
+  // preferred one of every value it is a candidate for, and the cheapest of
+  // these assignments wins over the heuristic one if it is strictly cheaper.
+  std::function<Attribute(Value)> getEncoding = getPreferredEncoding;
+  int64_t bestCost = getRewriteCost(getEncoding);
+  LDBG("resolveConflicts: heuristic assignment cost " << bestCost);
+  for (Attribute candidate : candidates) {
+    auto getCandidateEncoding = [&, candidate](Value value) {
+      if (layouts[value].encodings.count(candidate))
+        return candidate;
+      return getPreferredEncoding(value);
+    };
+    int64_t cost = getRewriteCost(getCandidateEncoding);
+    LDBG("resolveConflicts: cost " << cost << " preferring " << candidate);
+    if (cost < bestCost) {
+      bestCost = cost;
+      getEncoding = getCandidateEncoding;
+    }
+  }
+
+  SmallVector<std::pair<Value, Attribute>> resolved;
+  for (auto &it : layouts) {
+    if (it.second.encodings.size() > 1)
+      resolved.push_back({it.first, getEncoding(it.first)});
+  }
+  for (auto [value, encoding] : resolved) {
+    LayoutInfo &info = layouts[value];
     info.encodings.clear();
     info.encodings.insert(encoding);
   }
@@ -431,12 +611,6 @@ void LayoutPropagation::dump() {
 
 void LayoutPropagation::rewrite() { rewriteRegion(funcOp->getRegion(0)); }
 
-bool reduceToScalar(Operation *op) {
-  // For reductions returning a scalar we can change the src encoding without
-  // affecting the output.
-  return isa<ReduceOp>(op) && !isa<RankedTensorType>(op->getResultTypes()[0]);
-}
-
 void LayoutPropagation::rewriteRegion(Region &region) {
   std::deque<Region *> queue = {&region};
   while (!queue.empty()) {
@@ -1028,6 +1202,53 @@ LogicalResult getRematerializableSlice(
   return success();
 }
 
+int64_t LayoutRematerialization::getRematCost(SetVector<Value> &slice,
+                                              ConvertLayoutOp convertOp) {
+  // A value of the slice is dead after the rewrite if it only flows to the
+  // conversion through the slice, in which case recomputing it in the new
+  // layout does not duplicate any work.  Loop carried values are assumed to be
+  // dead until proven otherwise.
+  DenseMap<Value, bool> deadValues;
+  std::function<bool(Value)> isDeadAfterRewrite = [&](Value value) {
+    auto [it, inserted] = deadValues.try_emplace(value, true);
+    if (!inserted)
+      return it->second;
+    bool dead = llvm::all_of(value.getUses(), [&](OpOperand &use) {
+      Operation *user = use.getOwner();
+      if (user == convertOp)
+        return true;
+      SmallVector<Value> usedBy;
+      if (auto yieldOp = dyn_cast<scf::YieldOp>(user)) {
+        Operation *parent = yieldOp->getParentOp();
+        if (!isa<scf::ForOp, scf::IfOp>(parent))
+          return false;
+        usedBy.push_back(parent->getResult(use.getOperandNumber()));
+        if (auto forOp = dyn_cast<scf::ForOp>(parent))
+          usedBy.push_back(forOp.getRegionIterArg(use.getOperandNumber()));
+      } else {
+        if (user->getNumResults() == 0)
+          return false;
+        usedBy.append(user->result_begin(), user->result_end());
+      }
+      return llvm::all_of(usedBy, [&](Value v) {
+        return v.use_empty() || (slice.contains(v) && isDeadAfterRewrite(v));
+      });
+    });
+    deadValues[value] = dead;
+    return dead;
+  };
+
+  int64_t cost = 0;
+  DenseSet<Operation *> duplicatedOps;
+  for (Value v : slice) {
+    Operation *op = v.getDefiningOp();
+    if (!op || isDeadAfterRewrite(v) || !duplicatedOps.insert(op).second)
+      continue;
+    cost += costModel.getRematCost(op);
+  }
+  return cost;
+}
+
 void LayoutRematerialization::backwardRematerialization() {
   // Go through each ConvertLayoutOp.
   SmallVector<ConvertLayoutOp> convertOps;
@@ -1080,12 +1301,23 @@ void LayoutRematerialization::backwardRematerialization(
     return;
   }
 
+  // 2. Check that recomputing the slice in the new layout is cheaper than the
+  // conversion.
+  int64_t convertCost = costModel.getConvertCost(convertOp.getSrc().getType(),
+                                                 targetType.getEncoding());
+  int64_t rematCost = getRematCost(slice, convertOp);
+  LDBG("  convert cost " << convertCost << ", remat cost " << rematCost);
+  if (rematCost > convertCost) {
+    LDBG("  remat is more expensive than the convert");
+    return;
+  }
+
   LLVM_DEBUG({
     DBGS() << "  remat convert op " << convertOp << '\n';
     for (Value v : slice)
       DBGS() << "    " << v << '\n';
   });
-  // 2. Rewrite the slice.
+  // 3. Rewrite the slice.
   rewriteSlice(slice, layout, convertOp);
 }
 
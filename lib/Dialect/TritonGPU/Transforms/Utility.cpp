@@ -434,9 +434,16 @@ static std::optional<Attribute> inferSrcEncoding(triton::ReshapeOp op,
 }
 
 std::optional<Attribute> inferSrcEncoding(Operation *op, Attribute encoding) {
-  if (isa<triton::ScanOp>(op)) {
-    // Scan only supports blocked encoding at the moment.
-    if (!isa<triton::gpu::BlockedEncodingAttr>(encoding))
+  if (auto scan = dyn_cast<triton::ScanOp>(op)) {
+    // Scan only supports the encodings whose axis structure it can derive.
+    if (!ScanLoweringHelper::isSupportedLayout(
+            scan.getInputTypes()[0].getShape(), encoding, scan.getAxis()))
+      return std::nullopt;
+  }
+  if (auto sort = dyn_cast<triton::SortOp>(op)) {
+    // Sort needs each bit of the axis to be owned by a single hardware bit.
+    if (!SortOpHelper::isSupportedLayout(sort.getInputTypes()[0].getShape(),
+                                         encoding, sort.getAxis()))
       return std::nullopt;
   }
   if (op->hasTrait<mlir::OpTrait::SameOperandsAndResultEncoding>() ||
@@ -464,8 +471,14 @@ std::optional<Attribute> inferSrcEncoding(Operation *op, Attribute encoding) {
 }
 
 std::optional<Attribute> inferDstEncoding(Operation *op, Attribute encoding) {
-  if (isa<triton::ScanOp>(op)) {
-    if (!isa<triton::gpu::BlockedEncodingAttr>(encoding))
+  if (auto scan = dyn_cast<triton::ScanOp>(op)) {
+    if (!ScanLoweringHelper::isSupportedLayout(
+            scan.getInputTypes()[0].getShape(), encoding, scan.getAxis()))
+      return std::nullopt;
+  }
+  if (auto sort = dyn_cast<triton::SortOp>(op)) {
+    if (!SortOpHelper::isSupportedLayout(sort.getInputTypes()[0].getShape(),
+                                         encoding, sort.getAxis()))
       return std::nullopt;
   }
   if (op->hasTrait<mlir::OpTrait::SameOperandsAndResultEncoding>() ||
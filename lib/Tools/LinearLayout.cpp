@@ -31,13 +31,35 @@ BasesT makeBasesMap(
   return ret;
 }
 
+// A matrix over GF(2) in the row-major format used by f2reduce.  Each row
+// takes `stride` 64-bit words, so there's no limit on the number of columns.
+// Column c of row r is bit c % 64 of the word row(r)[c / 64].
+struct F2Matrix {
+  int numRows;
+  int numCols;
+  int stride;
+  // Note `new uint64_t[n]()` is zero-initialized, but `new uint64_t[n]` is
+  // not.
+  std::unique_ptr<uint64_t[]> data;
+
+  F2Matrix(int numRows, int numCols)
+      : numRows(numRows), numCols(numCols),
+        stride(std::max<int>(1, llvm::divideCeil(numCols, 64))),
+        data(new uint64_t[numRows * stride]()) {}
+
+  uint64_t *row(int r) { return &data[r * stride]; }
+  const uint64_t *row(int r) const { return &data[r * stride]; }
+
+  bool get(int r, int c) const { return (row(r)[c / 64] >> (c % 64)) & 1; }
+  void set(int r, int c) { row(r)[c / 64] |= uint64_t{1} << (c % 64); }
+};
+
 // Dump the matrix to stderr in a human-readable format for debugging.
-void dumpMatrix(uint64_t *m, int numRows, int numCols) {
-  assert(numCols <= 64);
-  for (int r = 0; r < numRows; r++) {
+void dumpMatrix(const F2Matrix &m) {
+  for (int r = 0; r < m.numRows; r++) {
     llvm::errs() << "0b";
-    for (int c = 0; c < numCols; c++) {
-      llvm::errs() << ((m[r] & (1 << c)) != 0 ? "1" : "0");
+    for (int c = 0; c < m.numCols; c++) {
+      llvm::errs() << (m.get(r, c) ? "1" : "0");
     }
     llvm::errs() << "\n";
   }
@@ -48,23 +70,16 @@ void dumpMatrix(uint64_t *m, int numRows, int numCols) {
 //
 // This function is called from the constructor of LinearLayout, so be careful
 // not to use any functions that create LLs in here.
-std::unique_ptr<uint64_t[]> getMatrix(const LinearLayout &layout) {
-  int numRows = layout.getTotalOutDimSizeLog2();
-  int numCols = layout.getTotalInDimSizeLog2();
-
-  // Don't handle giant LLs.  This makes some things easier; for example, each
-  // row can be a single uint64_t.
-  assert(numCols <= 64 && "LinearLayout too large");
-  assert(numRows <= 64 && "LinearLayout too large");
-
-  // Suppose we have a layout specified by the following values.
+F2Matrix getMatrix(const LinearLayout &layout) {
+  // The rows are the transpose of the packed columns of the layout.  Suppose
+  // we have a layout specified by the following values.
   //
   //   L(0,1) = (0b01, 0b1)
   //   L(0,2) = (0b10, 0b0)
   //   L(1,0) = (0b10, 0b0)
   //   L(2,0) = (0b11, 0b0)
   //
-  // We will create one column per entry above.  The max bit width of the
+  // The columns are [0b101, 0b010, 0b010, 0b011], and the max bit width of the
   // codomain is (2,1), so our matrix will have 2+1=3 rows.  The final matrix
   // will be
   //
@@ -72,69 +87,50 @@ std::unique_ptr<uint64_t[]> getMatrix(const LinearLayout &layout) {
   //  |    ↓         ↓         ↓         ↓      |   | 0b0111 |
   //  | L(0,1)[1] L(0,2)[1] L(1,0)[1] L(2,0)[1] | = | 0b1000 |
   //  |    ↓         ↓         ↓         ↓      |
-  //
-  // Note `new uint64_t[n]()` is zero-initialized, but `new uint64_t[n]` is not.
-  std::unique_ptr<uint64_t[]> m(new uint64_t[numRows]());
-  int r = 0;
-  for (StringAttr outDim : layout.getOutDimNames()) {
-    int c = 0;
-    for (StringAttr inDim : layout.getInDimNames()) {
-      for (int i = 0; i < layout.getInDimSizeLog2(inDim); i++) {
-        uint64_t basis = layout.getBasis(inDim, i, outDim);
-        for (int j = 0; j < layout.getOutDimSizeLog2(outDim); j++) {
-          m[r + j] |= ((basis >> j) & 1) << c;
-        }
-        c++;
-      }
+  F2Matrix m(layout.getTotalOutDimSizeLog2(), layout.getTotalInDimSizeLog2());
+  for (auto [c, column] : llvm::enumerate(layout.getColumns())) {
+    for (uint64_t bits = column; bits != 0; bits &= bits - 1) {
+      m.set(__builtin_ctzll(bits), c);
     }
-    r += layout.getOutDimSizeLog2(outDim);
   }
-
   return m;
 }
 
 // Get a matrix for `layout` with its codomain expanded so it's injective, i.e.
 // each input element maps to a unique output element.  We do this by finding
 // columns that are equal to 0 and adding a new row with a 1 in that column.
-std::tuple<std::unique_ptr<uint64_t[]>, int /*numRows*/, int /*numCols*/>
-getInjectiveMat(const LinearLayout &layout) {
+F2Matrix getInjectiveMat(const LinearLayout &layout) {
+  ArrayRef<uint64_t> columns = layout.getColumns();
   int numRows = layout.getTotalOutDimSizeLog2();
-  int numCols = layout.getTotalInDimSizeLog2();
-  std::unique_ptr<uint64_t[]> mat = getMatrix(layout);
-
-  // Bits of mat or-reduced along the columns (so there's just one row).
-  uint64_t colBits = 0;
-  for (int r = 0; r < numRows; r++) {
-    colBits |= mat[r];
-  }
-  auto expanded = std::unique_ptr<uint64_t[]>(new uint64_t[numRows + numCols]);
-  std::memcpy(expanded.get(), mat.get(), numRows * sizeof(uint64_t));
-  for (int c = 0; c < numCols; c++) {
-    if ((colBits & (1 << c)) == 0) {
-      expanded[numRows++] = (1 << c);
+  int numZeroColumns = llvm::count(columns, 0);
+  F2Matrix expanded(numRows + numZeroColumns, columns.size());
+  for (auto [c, column] : llvm::enumerate(columns)) {
+    if (column == 0) {
+      expanded.set(numRows++, c);
+    }
+    for (uint64_t bits = column; bits != 0; bits &= bits - 1) {
+      expanded.set(__builtin_ctzll(bits), c);
     }
   }
-  return std::make_tuple(std::move(expanded), numRows, numCols);
+  return expanded;
 }
 
 // Compute the rank of the matrix formed by taking the bases for the given
 // outDim as columns.  In other words, finds the number of linearly-independent
 // bases for this output dimension.
-int getMatrixRank(std::unique_ptr<uint64_t[]> m, int numRows, int numCols) {
+int getMatrixRank(F2Matrix m) {
   // f2reduce underflows if the number of cols is 0, return the rank early in
   // this case.
-  if (numCols == 0) {
+  if (m.numCols == 0) {
     return 0;
   }
-  // stride is specified in number of 64-bit words per row, and we pack our
-  // matrix so that there's only one uint64_t per row.
-  assert(numCols <= 64);
-  f2reduce::inplace_rref_strided(m.get(), numRows, numCols, /*stride=*/1);
+  f2reduce::inplace_rref_strided(m.data.get(), m.numRows, m.numCols, m.stride);
 
   // The rank of the reduced matrix is simply the number of nonzero rows.
   int rank = 0;
-  for (int i = 0; i < numRows; i++) {
-    if (m[i] != 0)
+  for (int r = 0; r < m.numRows; r++) {
+    if (llvm::any_of(ArrayRef<uint64_t>(m.row(r), m.stride),
+                     [](uint64_t word) { return word != 0; }))
       rank++;
   }
   return rank;
@@ -199,6 +195,28 @@ void eraseEmptyInOutDims(BasesT &bases,
   }
 }
 
+// Unpacks columns in the format of LinearLayout::columns into bases for the
+// given in-dims, with their sizes in log2, and out-dims.
+BasesT unpackColumns(ArrayRef<uint64_t> columns,
+                     ArrayRef<std::pair<StringAttr, int32_t>> inDimSizesLog2,
+                     ArrayRef<std::pair<StringAttr, int32_t>> outDims) {
+  BasesT bases;
+  int c = 0;
+  for (auto [inDim, sizeLog2] : inDimSizesLog2) {
+    auto &inDimBases = bases[inDim];
+    for (int i = 0; i < sizeLog2; i++) {
+      uint64_t column = columns[c++];
+      auto &basis = inDimBases.emplace_back();
+      for (auto [outDim, size] : outDims) {
+        basis.push_back(column & (size - 1));
+        column >>= llvm::Log2_32(size);
+      }
+    }
+  }
+  assert(c == columns.size());
+  return bases;
+}
+
 } // anonymous namespace
 
 /*static*/ std::optional<LinearLayout>
@@ -304,6 +322,13 @@ LinearLayout::checkInvariants(bool requireSurjective) {
     }
   }
 
+  if (getTotalOutDimSizeLog2() > 64) {
+    return "Layout is too large, the out-dims have more than 64 bits in "
+           "total:" +
+           toString();
+  }
+  packColumns();
+
   // Determine whether the this layout is surjective, i.e. that every `out`
   // coordinate can be reached by some `in` coordinate.
   //
@@ -315,9 +340,7 @@ LinearLayout::checkInvariants(bool requireSurjective) {
   // for an n x n matrix.  Our matrix size is sum(inDimSizeLog2) x
   // sum(outDimSizeLog2), so this should be plenty fast.
   this->surjective =
-      getMatrixRank(getMatrix(*this), /*numRows=*/getTotalOutDimSizeLog2(),
-                    /*numCols=*/getTotalInDimSizeLog2()) ==
-      getTotalOutDimSizeLog2();
+      getMatrixRank(getMatrix(*this)) == getTotalOutDimSizeLog2();
 
   if (requireSurjective && !surjective) {
     return "Layout is expected to be surjective, i.e. every `out` coordinate "
@@ -327,6 +350,29 @@ LinearLayout::checkInvariants(bool requireSurjective) {
   return std::nullopt;
 }
 
+void LinearLayout::packColumns() {
+  outDimBitOffsets.clear();
+  int32_t bitOffset = 0;
+  for (StringAttr outDim : getOutDimNames()) {
+    outDimBitOffsets.push_back(bitOffset);
+    bitOffset += getOutDimSizeLog2(outDim);
+  }
+
+  columns.clear();
+  inDimColumnOffsets.clear();
+  for (const auto &[inDim, inDimBases] : bases) {
+    inDimColumnOffsets.push_back(columns.size());
+    for (const auto &basis : inDimBases) {
+      uint64_t column = 0;
+      for (auto [i, b] : llvm::enumerate(basis)) {
+        column |= uint64_t(b) << outDimBitOffsets[i];
+      }
+      columns.push_back(column);
+    }
+  }
+  inDimColumnOffsets.push_back(columns.size());
+}
+
 LinearLayout::LinearLayout(
     ArrayRef<std::pair<StringAttr, std::vector<std::vector<int32_t>>>> bases,
     ArrayRef<StringAttr> outDimNames)
@@ -377,6 +423,14 @@ int32_t LinearLayout::getOutDimIndex(StringAttr outDim) const {
                            toString());
 }
 
+int32_t LinearLayout::getInDimIndex(StringAttr inDim) const {
+  auto it = bases.find(inDim);
+  if (it == bases.end()) {
+    return -1;
+  }
+  return it - bases.begin();
+}
+
 int32_t LinearLayout::getInDimSizeLog2(StringAttr inDim) const {
   auto it = bases.find(inDim);
   assert(it != bases.end());
@@ -478,11 +532,11 @@ LinearLayout LinearLayout::reshapeIns(
   assert(llvm::all_of(newInDims, [&](auto &inDim) {
     return llvm::isPowerOf2_32(inDim.second);
   }));
-  assert(getTotalInDimSize() == std::accumulate(newInDims.begin(),
-                                                newInDims.end(), 1,
-                                                [&](int32_t acc, auto &inDim) {
-                                                  return acc * inDim.second;
-                                                }));
+  assert(getTotalInDimSizeLog2() ==
+         std::accumulate(newInDims.begin(), newInDims.end(), 0,
+                         [&](int32_t acc, auto &inDim) {
+                           return acc + llvm::Log2_32(inDim.second);
+                         }));
 
   // First flatten into a single in-dimension.  Then split it up according
   // to `newInDims`.
@@ -510,10 +564,11 @@ LinearLayout LinearLayout::reshapeOuts(
   assert(llvm::all_of(newOutDims, [&](auto &outDim) {
     return llvm::isPowerOf2_32(outDim.second);
   }));
-  assert(getTotalOutDimSize() ==
-         std::accumulate(
-             newOutDims.begin(), newOutDims.end(), 1,
-             [&](int32_t acc, auto &outDim) { return acc * outDim.second; }));
+  assert(getTotalOutDimSizeLog2() ==
+         std::accumulate(newOutDims.begin(), newOutDims.end(), 0,
+                         [&](int32_t acc, auto &outDim) {
+                           return acc + llvm::Log2_32(outDim.second);
+                         }));
 
   SmallVector<int32_t> shifts;
   shifts.push_back(0);
@@ -755,17 +810,29 @@ bool LinearLayout::sublayoutIsIdentity(ArrayRef<StringAttr> inDimNames,
 
 SmallVector<std::pair<StringAttr, int32_t>>
 LinearLayout::apply(ArrayRef<std::pair<StringAttr, int32_t>> ins) const {
-  assertDimsEqualIgnoringOrder(llvm::make_first_range(ins), getInDimNames());
+  if (ins.size() != bases.size()) {
+    assertDimsEqualIgnoringOrder(llvm::make_first_range(ins), getInDimNames());
+  }
 
-  SmallVector<std::pair<StringAttr, int32_t>> ret;
-  for (StringAttr outDim : getOutDimNames()) {
-    int32_t outVal = 0;
-    for (auto &[inDim, val] : ins) {
-      for (int i = 0; i < getInDimSizeLog2(inDim); i++) {
-        if (val & (1 << i))
-          outVal ^= getBasis(inDim, i, outDim);
-      }
+  // xor the columns of the input bits that are set.
+  uint64_t out = 0;
+  for (auto [inDim, val] : ins) {
+    int32_t inDimIdx = getInDimIndex(inDim);
+    if (inDimIdx == -1) {
+      assertDimsEqualIgnoringOrder(llvm::make_first_range(ins),
+                                   getInDimNames());
     }
+    int32_t offset = inDimColumnOffsets[inDimIdx];
+    int32_t sizeLog2 = inDimColumnOffsets[inDimIdx + 1] - offset;
+    for (uint64_t bits = val & llvm::maskTrailingOnes<uint64_t>(sizeLog2);
+         bits != 0; bits &= bits - 1) {
+      out ^= columns[offset + __builtin_ctzll(bits)];
+    }
+  }
+
+  SmallVector<std::pair<StringAttr, int32_t>> ret;
+  for (auto [i, outDim] : llvm::enumerate(getOutDimNames())) {
+    int32_t outVal = (out >> outDimBitOffsets[i]) & (getOutDimSize(outDim) - 1);
     ret.push_back({outDim, outVal});
   }
   return ret;
@@ -777,28 +844,37 @@ LinearLayout LinearLayout::compose(const LinearLayout &outer) const {
     assert(getOutDimSize(outDim) <= outer.getInDimSize(outDim));
   }
 
-  BasesT newBases;
-  for (const auto &[inDim, inDimBases] : bases) {
-    auto &newInDimBases = newBases[inDim];
-    for (const auto &basis : inDimBases) {
-      SmallVector<std::pair<StringAttr, int32_t>> bases;
-      for (auto [outDim, b] : llvm::zip(getOutDimNames(), basis)) {
-        bases.push_back({outDim, b});
-      }
-      auto newBases = outer.apply(bases);
-      auto newBasesRange = llvm::make_second_range(newBases);
-      newInDimBases.push_back(
-          std::vector<int32_t>(newBasesRange.begin(), newBasesRange.end()));
+  // The composition is the matrix product of outer's columns, reordered to
+  // match our out-dims, and our columns.  outerColumns[b] is the image under
+  // `outer` of bit b of our output.
+  SmallVector<uint64_t> outerColumns;
+  for (StringAttr outDim : getOutDimNames()) {
+    int32_t offset = outer.inDimColumnOffsets[outer.getInDimIndex(outDim)];
+    for (int i = 0; i < getOutDimSizeLog2(outDim); i++) {
+      outerColumns.push_back(outer.columns[offset + i]);
+    }
+  }
+  SmallVector<uint64_t> newColumns;
+  for (uint64_t column : columns) {
+    uint64_t newColumn = 0;
+    for (uint64_t bits = column; bits != 0; bits &= bits - 1) {
+      newColumn ^= outerColumns[__builtin_ctzll(bits)];
     }
+    newColumns.push_back(newColumn);
   }
 
+  SmallVector<std::pair<StringAttr, int32_t>> inDimSizesLog2;
+  for (StringAttr inDim : getInDimNames()) {
+    inDimSizesLog2.push_back({inDim, getInDimSizeLog2(inDim)});
+  }
+  auto newOutDims = llvm::to_vector(outer.outDims);
   bool compositionIsSurjective =
       isSurjective() && outer.isSurjective() &&
       llvm::all_of(getOutDimNames(), [&](StringAttr outDim) {
         return getOutDimSize(outDim) == outer.getInDimSize(outDim);
       });
-  return LinearLayout(std::move(newBases), llvm::to_vector(outer.outDims),
-                      compositionIsSurjective);
+  return LinearLayout(unpackColumns(newColumns, inDimSizesLog2, newOutDims),
+                      newOutDims, compositionIsSurjective);
 }
 
 LinearLayout LinearLayout::invertAndCompose(const LinearLayout &outer) const {
@@ -845,74 +921,79 @@ LinearLayout LinearLayout::invertAndCompose(const LinearLayout &outer) const {
   //
   // Thus making A and B injective encodes our desire not to cross blocks,
   // or more generally our desire that C(x) != 0 where possible.
-  auto [matThis, numRowsThis, numColsThis] = getInjectiveMat(*this);
-  auto [matOuter, numRowsOuter, numColsOuter] = getInjectiveMat(
+  F2Matrix matThis = getInjectiveMat(*this);
+  F2Matrix matOuter = getInjectiveMat(
       outer.transposeOuts(llvm::to_vector(this->getOutDimNames())));
+  int numColsOuter = matOuter.numCols;
+  int numRowsOuter = matOuter.numRows;
 
   // Concatenate `matOuter` and `matThis` horizontally (i.e. `matThis`
-  // is to the right of `matOuter`).
-  int combinedNumRows = std::max(numRowsThis, numRowsOuter);
-  int combinedNumCols = numColsThis + numColsOuter;
-  assert(combinedNumCols <= 64 && "Can't handle huge layouts");
-
-  std::unique_ptr<uint64_t[]> m(new uint64_t[combinedNumRows]());
+  // is to the right of `matOuter`).  The rows span as many 64-bit words as
+  // needed, so large layouts are supported too.
+  F2Matrix m(std::max(matThis.numRows, numRowsOuter),
+             numColsOuter + matThis.numCols);
   for (int r = 0; r < numRowsOuter; r++) {
-    m[r] = matOuter[r];
+    std::copy_n(matOuter.row(r), matOuter.stride, m.row(r));
   }
-  for (int r = 0; r < numRowsThis; r++) {
-    m[r] |= matThis[r] << numColsOuter;
+  for (int r = 0; r < matThis.numRows; r++) {
+    for (int c = 0; c < matThis.numCols; c++) {
+      if (matThis.get(r, c))
+        m.set(r, numColsOuter + c);
+    }
   }
 
   // Perform Gaussian elimination on `m`.  Because `outer` was modified to
   // be bijective, the first half of the matrix should be the identity
   // matrix.  The remaining half are the bases for the combined
   // transformation.
-  //
-  // `stride` is specified in number of 64-bit words per row, and we pack
-  // our matrix so that there's only one uint64_t per row.
-  f2reduce::inplace_rref_strided(m.get(), combinedNumRows, combinedNumCols,
-                                 /*stride=*/1);
+  f2reduce::inplace_rref_strided(m.data.get(), m.numRows, m.numCols, m.stride);
 
   // Check that the first half of the matrix is indeed the identity.
   for (int r = 0; r < std::min(numRowsOuter, numColsOuter); r++) {
     for (int c = 0; c < std::min(numColsOuter, numRowsOuter); c++) {
-      if (((m[r] >> c) & 1) != (r == c ? 1 : 0)) {
+      if (m.get(r, c) != (r == c)) {
         llvm::report_fatal_error("First half of the matrix was not the "
                                  "identity, bug in invertAndCompose");
       }
     }
   }
 
-  // We need names for the in/out dim of the flattened layout we're going to
-  // read off from `m`.  These could be anything, doesn't matter.
-  StringAttr inDim1D = *getInDimNames().begin();
-  StringAttr outDim1D = *getOutDimNames().begin();
-
-  // Read off the new bases.  These are for a flattened 1D -> 1D
-  // transformation from `this`'s in-dims to `outer`'s in-dims.
-  BasesT newBases;
-  auto &bs = newBases[inDim1D];
-  for (int c = 0; c < numColsThis; c++) {
-    int32_t basis = 0;
-    for (int r = 0; r < numRowsOuter; r++) {
-      basis |= (m[r] >> (numColsOuter + c) & 1) << r;
-    }
-    bs.push_back({basis});
-  }
-
-  LinearLayout flatComposed(std::move(newBases),
-                            {{outDim1D, outer.getTotalInDimSize()}},
-                            /*requireSurjective=*/false);
-
-  SmallVector<std::pair<StringAttr, int32_t>> retInDims;
+  // Read off the new bases, from `this`'s in-dims to `outer`'s in-dims.  Row
+  // r of `m` is bit r of `outer`'s in-dims flattened in order, the first one
+  // being the most minor.  There may be more rows than an int32 has bits, so
+  // the rows are split into `outer`'s in-dims instead of read off as a
+  // flattened 1D -> 1D transformation.
   SmallVector<std::pair<StringAttr, int32_t>> retOutDims;
-  for (StringAttr dim : getInDimNames()) {
-    retInDims.push_back({dim, getInDimSize(dim)});
-  }
+  SmallVector<int> retOutDimRowOffsets;
+  int numRetOutRows = 0;
   for (StringAttr dim : outer.getInDimNames()) {
     retOutDims.push_back({dim, outer.getInDimSize(dim)});
+    retOutDimRowOffsets.push_back(numRetOutRows);
+    numRetOutRows += outer.getInDimSizeLog2(dim);
+  }
+
+  BasesT newBases;
+  int c = 0;
+  for (StringAttr inDim : getInDimNames()) {
+    auto &bs = newBases[inDim];
+    for (int i = 0; i < getInDimSizeLog2(inDim); i++, c++) {
+      std::vector<int32_t> basis(retOutDims.size(), 0);
+      for (int r = 0; r < numRowsOuter; r++) {
+        if (!m.get(r, numColsOuter + c))
+          continue;
+        if (r >= numRetOutRows) {
+          llvm::report_fatal_error("Basis out of the range of outer's "
+                                   "in-dims, bug in invertAndCompose");
+        }
+        int j = llvm::upper_bound(retOutDimRowOffsets, r) -
+                retOutDimRowOffsets.begin() - 1;
+        basis[j] |= int32_t{1} << (r - retOutDimRowOffsets[j]);
+      }
+      bs.push_back(std::move(basis));
+    }
   }
-  return flatComposed.reshapeIns(retInDims).reshapeOuts(retOutDims);
+  return LinearLayout(std::move(newBases), retOutDims,
+                      /*requireSurjective=*/false);
 }
 
 bool operator==(LinearLayout lhs, LinearLayout rhs) {
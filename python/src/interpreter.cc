@@ -1,14 +1,26 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace py = pybind11;
 
 namespace {
 
+template <typename T>
+using contiguous_array =
+    py::array_t<T, py::array::c_style | py::array::forcecast>;
+
 enum class MemSemantic { ACQUIRE_RELEASE, ACQUIRE, RELEASE, RELAXED };
 
 enum class RMWOp { ADD, FADD, AND, OR, XOR, XCHG, MAX, MIN, UMIN, UMAX };
@@ -70,7 +82,7 @@ public:
   AtomicOp(const uint64_t *ptr, size_t numel, int order)
       : ptr(ptr), numel(numel), order(order) {}
 
-  void apply() {
+  virtual void apply() {
     for (size_t i = 0; i < numel; ++i) {
       applyAt(reinterpret_cast<void *>(ptr[i]), i);
     }
@@ -108,6 +120,122 @@ protected:
   const bool *mask;
 };
 
+// Base class of the commutative RMW ops. Lanes that update the same address
+// (e.g. histogram bins or split-k partial sums) are combined locally and the
+// result is written with a single atomic per address instead of one per lane,
+// which avoids contending on the same cache line when programs run in
+// parallel. Lanes of an address are still applied in lane order, so memory
+// and the per-lane return values are the same as with one atomic per lane.
+template <typename DType>
+class CombiningAtomicRMWOp : public AtomicRMWOpBase<DType> {
+public:
+  using AtomicRMWOpBase<DType>::AtomicRMWOpBase;
+
+  void apply() override {
+    // Pointers like `ptr + offsets` hit distinct addresses: nothing to combine
+    if (hasIncreasingAddresses())
+      return AtomicOp::apply();
+    groupLanes();
+    for (size_t head : heads)
+      applyGroup(reinterpret_cast<DType *>(this->ptr[head]), head);
+  }
+
+protected:
+  // Value of a location holding `acc` after applying `value` to it
+  virtual DType combine(DType acc, DType value) const = 0;
+
+  // Whether the values of a group can be combined first and then applied
+  // with a single atomic
+  virtual bool isAssociative() const { return true; }
+
+private:
+  static constexpr size_t kNone = ~size_t(0);
+
+  bool hasIncreasingAddresses() const {
+    uint64_t prev = 0;
+    bool first = true;
+    for (size_t i = 0; i < this->numel; ++i) {
+      if (!this->mask[i])
+        continue;
+      if (!first && this->ptr[i] <= prev)
+        return false;
+      prev = this->ptr[i];
+      first = false;
+    }
+    return true;
+  }
+
+  // Links the active lanes of every address in lane order: `heads` holds the
+  // first lane of each address and `next` the following lane of the same
+  // address. Addresses are looked up in an open addressing hash table.
+  void groupLanes() {
+    const uint64_t *ptr = this->ptr;
+    int log2Slots = 1;
+    while ((size_t(1) << log2Slots) < 2 * this->numel)
+      ++log2Slots;
+    size_t slotMask = (size_t(1) << log2Slots) - 1;
+    std::vector<size_t> slots(slotMask + 1, kNone);
+    std::vector<size_t> tails;
+    heads.clear();
+    next.assign(this->numel, kNone);
+    for (size_t i = 0; i < this->numel; ++i) {
+      if (!this->mask[i])
+        continue;
+      // Fibonacci hashing of the address
+      size_t slot = (ptr[i] * 0x9E3779B97F4A7C15ull) >> (64 - log2Slots);
+      while (slots[slot] != kNone && ptr[heads[slots[slot]]] != ptr[i])
+        slot = (slot + 1) & slotMask;
+      if (slots[slot] == kNone) {
+        slots[slot] = heads.size();
+        heads.push_back(i);
+        tails.push_back(i);
+      } else {
+        size_t &tail = tails[slots[slot]];
+        next[tail] = i;
+        tail = i;
+      }
+    }
+  }
+
+  void applyGroup(DType *loc, size_t head) {
+    auto *val = static_cast<const DType *>(this->val);
+    auto *ret = static_cast<DType *>(this->ret);
+    if (next[head] == kNone) {
+      ret[head] = this->applyAtMasked(loc, val[head], this->order);
+      return;
+    }
+    auto replay = [&](DType acc) {
+      for (size_t lane = head; lane != kNone; lane = next[lane]) {
+        ret[lane] = acc;
+        acc = combine(acc, val[lane]);
+      }
+      return acc;
+    };
+    if (isAssociative()) {
+      DType total = val[head];
+      for (size_t lane = next[head]; lane != kNone; lane = next[lane])
+        total = combine(total, val[lane]);
+      replay(this->applyAtMasked(loc, total, this->order));
+      return;
+    }
+    // Not associative (floating point addition): replay the lanes in order
+    // on the current value and publish the result with a compare-exchange.
+    // The initial load can be relaxed since the compare-exchange checks it.
+    DType old;
+    __atomic_load(loc, &old, __ATOMIC_RELAXED);
+    while (true) {
+      DType desired = replay(old);
+      if (__atomic_compare_exchange(loc, &old, &desired, false, this->order,
+                                    this->order)) {
+        break;
+      }
+    }
+  }
+
+  std::vector<size_t> heads;
+  std::vector<size_t> next;
+};
+
 template <typename DType, RMWOp Op, typename = void>
 class AtomicRMWOp : public AtomicRMWOpBase<DType> {
 public:
@@ -116,11 +244,17 @@ public:
 
 template <typename DType, RMWOp Op>
 class AtomicRMWOp<DType, Op, std::enable_if_t<Op == RMWOp::ADD>>
-    : public AtomicRMWOpBase<DType> {
+    : public CombiningAtomicRMWOp<DType> {
 public:
-  using AtomicRMWOpBase<DType>::AtomicRMWOpBase;
+  using CombiningAtomicRMWOp<DType>::CombiningAtomicRMWOp;
 
 protected:
+  DType combine(DType acc, DType value) const override {
+    // Wrap around like __atomic_fetch_add instead of overflowing
+    using U = std::make_unsigned_t<DType>;
+    return static_cast<DType>(static_cast<U>(acc) + static_cast<U>(value));
+  }
+
   DType applyAtMasked(DType *loc, const DType value, int order) override {
     return __atomic_fetch_add(loc, value, order);
   }
@@ -128,11 +262,15 @@ protected:
 
 template <typename DType, RMWOp Op>
 class AtomicRMWOp<DType, Op, std::enable_if_t<Op == RMWOp::FADD>>
-    : public AtomicRMWOpBase<DType> {
+    : public CombiningAtomicRMWOp<DType> {
 public:
-  using AtomicRMWOpBase<DType>::AtomicRMWOpBase;
+  using CombiningAtomicRMWOp<DType>::CombiningAtomicRMWOp;
 
 protected:
+  DType combine(DType acc, DType value) const override { return acc + value; }
+
+  bool isAssociative() const override { return false; }
+
   DType applyAtMasked(DType *loc, const DType value, int order) override {
     return atomic_fadd(loc, value, order);
   }
@@ -140,11 +278,13 @@ protected:
 
 template <typename DType, RMWOp Op>
 class AtomicRMWOp<DType, Op, std::enable_if_t<Op == RMWOp::AND>>
-    : public AtomicRMWOpBase<DType> {
+    : public CombiningAtomicRMWOp<DType> {
 public:
-  using AtomicRMWOpBase<DType>::AtomicRMWOpBase;
+  using CombiningAtomicRMWOp<DType>::CombiningAtomicRMWOp;
 
 protected:
+  DType combine(DType acc, DType value) const override { return acc & value; }
+
   DType applyAtMasked(DType *loc, const DType value, int order) override {
     return __atomic_fetch_and(loc, value, order);
   }
@@ -152,11 +292,13 @@ protected:
 
 template <typename DType, RMWOp Op>
 class AtomicRMWOp<DType, Op, std::enable_if_t<Op == RMWOp::OR>>
-    : public AtomicRMWOpBase<DType> {
+    : public CombiningAtomicRMWOp<DType> {
 public:
-  using AtomicRMWOpBase<DType>::AtomicRMWOpBase;
+  using CombiningAtomicRMWOp<DType>::CombiningAtomicRMWOp;
 
 protected:
+  DType combine(DType acc, DType value) const override { return acc | value; }
+
   DType applyAtMasked(DType *loc, const DType value, int order) override {
     return __atomic_fetch_or(loc, value, order);
   }
@@ -164,11 +306,13 @@ protected:
 
 template <typename DType, RMWOp Op>
 class AtomicRMWOp<DType, Op, std::enable_if_t<Op == RMWOp::XOR>>
-    : public AtomicRMWOpBase<DType> {
+    : public CombiningAtomicRMWOp<DType> {
 public:
-  using AtomicRMWOpBase<DType>::AtomicRMWOpBase;
+  using CombiningAtomicRMWOp<DType>::CombiningAtomicRMWOp;
 
 protected:
+  DType combine(DType acc, DType value) const override { return acc ^ value; }
+
   DType applyAtMasked(DType *loc, const DType value, int order) override {
     return __atomic_fetch_xor(loc, value, order);
   }
@@ -177,11 +321,15 @@ protected:
 template <typename DType, RMWOp Op>
 class AtomicRMWOp<DType, Op,
                   std::enable_if_t<Op == RMWOp::MAX || Op == RMWOp::UMAX>>
-    : public AtomicRMWOpBase<DType> {
+    : public CombiningAtomicRMWOp<DType> {
 public:
-  using AtomicRMWOpBase<DType>::AtomicRMWOpBase;
+  using CombiningAtomicRMWOp<DType>::CombiningAtomicRMWOp;
 
 protected:
+  DType combine(DType acc, DType value) const override {
+    return std::max(acc, value);
+  }
+
   DType applyAtMasked(DType *loc, const DType value, int order) override {
     return atomic_cmp</*is_min=*/false>(loc, value, order);
   }
@@ -190,11 +338,15 @@ protected:
 template <typename DType, RMWOp Op>
 class AtomicRMWOp<DType, Op,
                   std::enable_if_t<Op == RMWOp::MIN || Op == RMWOp::UMIN>>
-    : public AtomicRMWOpBase<DType> {
+    : public CombiningAtomicRMWOp<DType> {
 public:
-  using AtomicRMWOpBase<DType>::AtomicRMWOpBase;
+  using CombiningAtomicRMWOp<DType>::CombiningAtomicRMWOp;
 
 protected:
+  DType combine(DType acc, DType value) const override {
+    return std::min(acc, value);
+  }
+
   DType applyAtMasked(DType *loc, const DType value, int order) override {
     return atomic_cmp</*is_min=*/true>(loc, value, order);
   }
@@ -259,6 +411,143 @@ private:
   size_t itemsize;
 };
 
+// Load/store helpers.
+// Pointers produced by the interpreter are usually an affine function of the
+// element index (e.g. `ptr + tl.arange(0, BLOCK)`), and masks are often
+// all-true, so those cases are handled without per-element dispatch.
+
+bool isAllTrue(const bool *mask, size_t numel) {
+  for (size_t i = 0; i < numel; ++i) {
+    if (!mask[i])
+      return false;
+  }
+  return true;
+}
+
+// Returns true and sets `stride` (in bytes) if consecutive pointers are
+// separated by a constant distance.
+bool getConstantStride(const uint64_t *ptr, size_t numel, int64_t &stride) {
+  stride = numel > 1 ? static_cast<int64_t>(ptr[1] - ptr[0]) : 0;
+  for (size_t i = 2; i < numel; ++i) {
+    if (static_cast<int64_t>(ptr[i] - ptr[i - 1]) != stride)
+      return false;
+  }
+  return true;
+}
+
+// Elements are moved through memcpy so that unaligned addresses are fine; the
+// fixed size lets the compiler turn each copy into a single move.
+template <typename T>
+void gather(const uint64_t *ptr, const bool *mask, const void *other,
+            void *ret, size_t numel) {
+  auto *other_data = static_cast<const T *>(other);
+  auto *ret_data = static_cast<T *>(ret);
+  for (size_t i = 0; i < numel; ++i) {
+    T val = other_data[i];
+    if (mask[i])
+      std::memcpy(&val, reinterpret_cast<const void *>(ptr[i]), sizeof(T));
+    ret_data[i] = val;
+  }
+}
+
+template <typename T>
+void gatherStrided(uint64_t base, int64_t stride, void *ret, size_t numel) {
+  auto *ret_data = static_cast<T *>(ret);
+  for (size_t i = 0; i < numel; ++i) {
+    std::memcpy(&ret_data[i],
+                reinterpret_cast<const void *>(base + i * stride), sizeof(T));
+  }
+}
+
+template <typename T>
+void scatter(const uint64_t *ptr, const bool *mask, const void *value,
+             size_t numel) {
+  auto *value_data = static_cast<const T *>(value);
+  for (size_t i = 0; i < numel; ++i) {
+    if (mask[i])
+      std::memcpy(reinterpret_cast<void *>(ptr[i]), &value_data[i], sizeof(T));
+  }
+}
+
+template <typename T>
+void scatterStrided(uint64_t base, int64_t stride, const void *value,
+                    size_t numel) {
+  auto *value_data = static_cast<const T *>(value);
+  for (size_t i = 0; i < numel; ++i) {
+    std::memcpy(reinterpret_cast<void *>(base + i * stride), &value_data[i],
+                sizeof(T));
+  }
+}
+
+#define DISPATCH_ITEMSIZE(ITEMSIZE, FN, ...)                                   \
+  switch (ITEMSIZE) {                                                          \
+  case 1:                                                                      \
+    FN<uint8_t>(__VA_ARGS__);                                                  \
+    return;                                                                    \
+  case 2:                                                                      \
+    FN<uint16_t>(__VA_ARGS__);                                                 \
+    return;                                                                    \
+  case 4:                                                                      \
+    FN<uint32_t>(__VA_ARGS__);                                                 \
+    return;                                                                    \
+  case 8:                                                                      \
+    FN<uint64_t>(__VA_ARGS__);                                                 \
+    return;                                                                    \
+  default:                                                                     \
+    break;                                                                     \
+  }
+
+void load(const uint64_t *ptr, const bool *mask, const void *other, void *ret,
+          size_t numel, size_t itemsize) {
+  if (numel == 0)
+    return;
+  int64_t stride;
+  if (isAllTrue(mask, numel) && getConstantStride(ptr, numel, stride)) {
+    if (stride == static_cast<int64_t>(itemsize)) {
+      std::memcpy(ret, reinterpret_cast<const void *>(ptr[0]),
+                  numel * itemsize);
+      return;
+    }
+    DISPATCH_ITEMSIZE(itemsize, gatherStrided, ptr[0], stride, ret, numel);
+  } else {
+    DISPATCH_ITEMSIZE(itemsize, gather, ptr, mask, other, ret, numel);
+  }
+  // Generic fallback for unusual element sizes
+  auto *other_data = static_cast<const char *>(other);
+  auto *ret_data = static_cast<char *>(ret);
+  for (size_t i = 0; i < numel; ++i) {
+    const void *src = mask[i] ? reinterpret_cast<const void *>(ptr[i])
+                              : other_data + i * itemsize;
+    std::memcpy(ret_data + i * itemsize, src, itemsize);
+  }
+}
+
+void store(const uint64_t *ptr, const void *value, const bool *mask,
+           size_t numel, size_t itemsize) {
+  if (numel == 0)
+    return;
+  int64_t stride;
+  if (isAllTrue(mask, numel) && getConstantStride(ptr, numel, stride)) {
+    // A zero stride (every lane storing to the same address) is left to the
+    // strided loop so that the last lane wins, as in the generic path.
+    if (stride == static_cast<int64_t>(itemsize)) {
+      std::memcpy(reinterpret_cast<void *>(ptr[0]), value, numel * itemsize);
+      return;
+    }
+    DISPATCH_ITEMSIZE(itemsize, scatterStrided, ptr[0], stride, value, numel);
+  } else {
+    DISPATCH_ITEMSIZE(itemsize, scatter, ptr, mask, value, numel);
+  }
+  auto *value_data = static_cast<const char *>(value);
+  for (size_t i = 0; i < numel; ++i) {
+    if (mask[i])
+      std::memcpy(reinterpret_cast<void *>(ptr[i]), value_data + i * itemsize,
+                  itemsize);
+  }
+}
+
+#undef DISPATCH_ITEMSIZE
+
 // This is a workaround because explicit template parameter list for lambdas is
 // a C++20 extension:
 // auto try_make_op = [&]<typename T>() {
@@ -302,8 +591,560 @@ makeAtomicRMWOp(pybind11::dtype dtype, const uint64_t *ptr, const void *val,
   return atomic_op;
 }
 
+// A block pointer (tt.make_tensor_ptr) over global memory, with its shape,
+// strides and offsets in elements
+struct BlockPointer {
+  uint64_t base;
+  std::vector<int64_t> shape;
+  std::vector<int64_t> strides;
+  std::vector<int64_t> offsets;
+  std::vector<bool> boundaryCheck;
+
+  BlockPointer(uint64_t base, std::vector<int64_t> shape,
+               std::vector<int64_t> strides, std::vector<int64_t> offsets,
+               const std::vector<int> &boundaryCheckDims, size_t ndim)
+      : base(base), shape(std::move(shape)), strides(std::move(strides)),
+        offsets(std::move(offsets)), boundaryCheck(ndim, false) {
+    if (ndim == 0 || this->shape.size() != ndim ||
+        this->strides.size() != ndim || this->offsets.size() != ndim)
+      throw std::invalid_argument("Mismatched block pointer rank");
+    for (int dim : boundaryCheckDims) {
+      if (dim < 0 || static_cast<size_t>(dim) >= ndim)
+        throw std::invalid_argument("Invalid boundary check dimension");
+      boundaryCheck[dim] = true;
+    }
+  }
+};
+
+template <typename T>
+void copyStrided(char *dst, ptrdiff_t dstStride, const char *src,
+                 ptrdiff_t srcStride, size_t numel) {
+  for (size_t i = 0; i < numel; ++i)
+    std::memcpy(dst + i * dstStride, src + i * srcStride, sizeof(T));
+}
+
+void copyStrided(char *dst, ptrdiff_t dstStride, const char *src,
+                 ptrdiff_t srcStride, size_t numel, size_t itemsize) {
+  if (dstStride == static_cast<ptrdiff_t>(itemsize) && dstStride == srcStride)
+    return (void)std::memcpy(dst, src, numel * itemsize);
+  switch (itemsize) {
+  case 1:
+    return copyStrided<uint8_t>(dst, dstStride, src, srcStride, numel);
+  case 2:
+    return copyStrided<uint16_t>(dst, dstStride, src, srcStride, numel);
+  case 4:
+    return copyStrided<uint32_t>(dst, dstStride, src, srcStride, numel);
+  case 8:
+    return copyStrided<uint64_t>(dst, dstStride, src, srcStride, numel);
+  default:
+    for (size_t i = 0; i < numel; ++i)
+      std::memcpy(dst + i * dstStride, src + i * srcStride, itemsize);
+  }
+}
+
+// Copies between the block of memory a block pointer points to and a dense
+// row-major tensor, one row of the innermost dimension at a time. Loads fill
+// out of bounds elements with `other`, stores skip them.
+template <bool IsLoad>
+void copyBlock(const BlockPointer &ptr, const std::vector<int64_t> &tensorShape,
+               std::conditional_t<IsLoad, char *, const char *> tensor,
+               const char *other, size_t itemsize) {
+  size_t ndim = tensorShape.size();
+  // Range of in bounds indices of every dimension
+  std::vector<int64_t> begin(ndim), end(ndim);
+  for (size_t d = 0; d < ndim; ++d) {
+    begin[d] = 0;
+    end[d] = tensorShape[d];
+    if (ptr.boundaryCheck[d]) {
+      begin[d] = std::clamp<int64_t>(-ptr.offsets[d], 0, tensorShape[d]);
+      end[d] = std::clamp<int64_t>(ptr.shape[d] - ptr.offsets[d], begin[d],
+                                   tensorShape[d]);
+    }
+  }
+  size_t inner = ndim - 1;
+  size_t rowLen = tensorShape[inner];
+  size_t numRows = 1;
+  for (size_t d = 0; d < inner; ++d)
+    numRows *= tensorShape[d];
+  auto fill = [&](auto *row, int64_t from, int64_t to) {
+    if constexpr (IsLoad) {
+      for (int64_t j = from; j < to; ++j)
+        std::memcpy(row + j * itemsize, other, itemsize);
+    }
+  };
+  int64_t elemBytes = static_cast<int64_t>(itemsize);
+  ptrdiff_t memStride = ptr.strides[inner] * elemBytes;
+  std::vector<int64_t> index(inner, 0);
+  for (size_t r = 0; r < numRows; ++r) {
+    auto *row = tensor + r * rowLen * itemsize;
+    bool inBounds = begin[inner] < end[inner];
+    int64_t address = static_cast<int64_t>(ptr.base);
+    for (size_t d = 0; d < inner; ++d) {
+      inBounds &= index[d] >= begin[d] && index[d] < end[d];
+      address += (ptr.offsets[d] + index[d]) * ptr.strides[d] * elemBytes;
+    }
+    if (!inBounds) {
+      fill(row, 0, rowLen);
+    } else {
+      address += (ptr.offsets[inner] + begin[inner]) * memStride;
+      char *mem = reinterpret_cast<char *>(address);
+      auto *tensorRow = row + begin[inner] * itemsize;
+      size_t numel = end[inner] - begin[inner];
+      if constexpr (IsLoad)
+        copyStrided(tensorRow, itemsize, mem, memStride, numel, itemsize);
+      else
+        copyStrided(mem, memStride, tensorRow, itemsize, numel, itemsize);
+      fill(row, 0, begin[inner]);
+      fill(row, end[inner], rowLen);
+    }
+    // Move to the next row
+    for (size_t d = inner; d-- > 0;) {
+      if (++index[d] < tensorShape[d])
+        break;
+      index[d] = 0;
+    }
+  }
+}
+
+enum class FloatFormat {
+  FP8E4B15,
+  FP8E4NV,
+  FP8E4B8,
+  FP8E5,
+  FP8E5B16,
+  FP16,
+  BF16,
+  FP32,
+  FP64
+};
+
+enum class RoundingMode { RTNE, RTZ };
+
+struct FloatFormatInfo {
+  // How the format encodes infinities and NaNs:
+  // IEEE: the all-ones exponent encodes infinities and NaNs.
+  // FN: no infinities, only the all-ones exponent and mantissa is NaN.
+  // FNUZ: no infinities and no negative zero, the negative zero is NaN.
+  enum class Special { IEEE, FN, FNUZ };
+
+  int bits;
+  int mantissaBits;
+  int exponentBias;
+  Special special;
+
+  int exponentBits() const { return bits - 1 - mantissaBits; }
+  uint64_t signBit() const { return 1ull << (bits - 1); }
+  uint64_t mantissaMask() const { return (1ull << mantissaBits) - 1; }
+  uint64_t maxExponent() const { return (1ull << exponentBits()) - 1; }
+
+  uint64_t maxFinite() const {
+    switch (special) {
+    case Special::IEEE:
+      return ((maxExponent() - 1) << mantissaBits) | mantissaMask();
+    case Special::FN:
+      return (maxExponent() << mantissaBits) | (mantissaMask() - 1);
+    case Special::FNUZ:
+      return (maxExponent() << mantissaBits) | mantissaMask();
+    }
+    return 0;
+  }
+
+  uint64_t infinity() const { return maxExponent() << mantissaBits; }
+
+  uint64_t nan(uint64_t sign) const {
+    switch (special) {
+    case Special::IEEE:
+      return sign | infinity() | (1ull << (mantissaBits - 1));
+    case Special::FN:
+      return sign | (maxExponent() << mantissaBits) | mantissaMask();
+    case Special::FNUZ:
+      return signBit();
+    }
+    return 0;
+  }
+};
+
+// Same formats as the `tl.float*` types
+const FloatFormatInfo &getFloatFormatInfo(FloatFormat format) {
+  using Special = FloatFormatInfo::Special;
+  static const std::map<FloatFormat, FloatFormatInfo> infos = {
+      {FloatFormat::FP8E4B15, {8, 3, 15, Special::FN}},
+      {FloatFormat::FP8E4NV, {8, 3, 7, Special::FN}},
+      {FloatFormat::FP8E4B8, {8, 3, 8, Special::FNUZ}},
+      {FloatFormat::FP8E5, {8, 2, 15, Special::IEEE}},
+      {FloatFormat::FP8E5B16, {8, 2, 16, Special::FNUZ}},
+      {FloatFormat::FP16, {16, 10, 15, Special::IEEE}},
+      {FloatFormat::BF16, {16, 7, 127, Special::IEEE}},
+      {FloatFormat::FP32, {32, 23, 127, Special::IEEE}},
+      {FloatFormat::FP64, {64, 52, 1023, Special::IEEE}},
+  };
+  return infos.at(format);
+}
+
+// Every format converts exactly to a double
+double decodeFloat(uint64_t bits, const FloatFormatInfo &info) {
+  if (info.bits == 64) {
+    double ret;
+    std::memcpy(&ret, &bits, sizeof(ret));
+    return ret;
+  }
+  if (info.bits == 32) {
+    float ret;
+    uint32_t bits32 = static_cast<uint32_t>(bits);
+    std::memcpy(&ret, &bits32, sizeof(ret));
+    return ret;
+  }
+  bool negative = bits & info.signBit();
+  uint64_t exponent = (bits >> info.mantissaBits) & info.maxExponent();
+  uint64_t mantissa = bits & info.mantissaMask();
+  bool isNaN = false;
+  switch (info.special) {
+  case FloatFormatInfo::Special::IEEE:
+    if (exponent == info.maxExponent()) {
+      if (mantissa != 0)
+        isNaN = true;
+      else
+        return negative ? -INFINITY : INFINITY;
+    }
+    break;
+  case FloatFormatInfo::Special::FN:
+    isNaN = exponent == info.maxExponent() && mantissa == info.mantissaMask();
+    break;
+  case FloatFormatInfo::Special::FNUZ:
+    isNaN = bits == info.signBit();
+    break;
+  }
+  if (isNaN)
+    return negative ? -NAN : NAN;
+  if (exponent == 0)
+    exponent = 1;
+  else
+    mantissa |= 1ull << info.mantissaBits;
+  double magnitude = std::ldexp(static_cast<double>(mantissa),
+                                static_cast<int>(exponent) -
+                                    info.exponentBias - info.mantissaBits);
+  return negative ? -magnitude : magnitude;
+}
+
+// Rounds a double to the closest value of the format. Like the `satfinite`
+// conversions used by the GPU lowering, fp8 results saturate to the largest
+// finite value instead of overflowing. Other formats overflow to infinity
+// when rounding to nearest and saturate when rounding towards zero.
+uint64_t encodeFloat(double val, const FloatFormatInfo &info,
+                     RoundingMode rounding) {
+  if (info.bits == 64) {
+    uint64_t ret;
+    std::memcpy(&ret, &val, sizeof(ret));
+    return ret;
+  }
+  uint64_t sign = std::signbit(val) ? info.signBit() : 0;
+  if (std::isnan(val))
+    return info.nan(sign);
+  bool saturate = info.bits == 8 || rounding == RoundingMode::RTZ ||
+                  info.special != FloatFormatInfo::Special::IEEE;
+  uint64_t overflow = sign | (saturate ? info.maxFinite() : info.infinity());
+  if (std::isinf(val))
+    return info.special == FloatFormatInfo::Special::IEEE && info.bits != 8
+               ? sign | info.infinity()
+               : overflow;
+  double magnitude = std::fabs(val);
+  if (magnitude == 0)
+    return info.special == FloatFormatInfo::Special::FNUZ ? 0 : sign;
+  int exponent;
+  std::frexp(magnitude, &exponent);
+  // Biased exponent of the result, subnormals have the exponent of the
+  // smallest normal number
+  int biased = std::max(exponent - 1 + info.exponentBias, 1);
+  int lsbExponent = biased - info.exponentBias - info.mantissaBits;
+  // Scaling by a power of two is exact, `scaled` is the result in units of
+  // the last place, including the implicit bit of normal numbers
+  double scaled = std::ldexp(magnitude, -lsbExponent);
+  uint64_t units = static_cast<uint64_t>(scaled);
+  double remainder = scaled - static_cast<double>(units);
+  if (rounding == RoundingMode::RTNE &&
+      (remainder > 0.5 || (remainder == 0.5 && (units & 1))))
+    ++units;
+  // A carry out of the mantissa correctly increments the exponent
+  uint64_t bits =
+      (static_cast<uint64_t>(biased - 1) << info.mantissaBits) + units;
+  if (bits > info.maxFinite())
+    return overflow;
+  if (bits == 0 && info.special == FloatFormatInfo::Special::FNUZ)
+    return 0;
+  return sign | bits;
+}
+
+template <typename SrcT, typename DstT>
+void convertFloatGeneric(const SrcT *src, DstT *dst, size_t numel,
+                         const FloatFormatInfo &srcInfo,
+                         const FloatFormatInfo &dstInfo,
+                         RoundingMode rounding) {
+  for (size_t i = 0; i < numel; ++i)
+    dst[i] = static_cast<DstT>(
+        encodeFloat(decodeFloat(src[i], srcInfo), dstInfo, rounding));
+}
+
+// Formats of at most 16 bits convert through a lookup table with an entry
+// per source value
+template <typename DstT>
+const std::vector<DstT> &getConversionTable(FloatFormat srcFormat,
+                                            FloatFormat dstFormat,
+                                            RoundingMode rounding) {
+  static std::mutex mutex;
+  static std::map<std::tuple<FloatFormat, FloatFormat, RoundingMode>,
+                  std::vector<DstT>>
+      tables;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto &table = tables[{srcFormat, dstFormat, rounding}];
+  if (table.empty()) {
+    const auto &srcInfo = getFloatFormatInfo(srcFormat);
+    const auto &dstInfo = getFloatFormatInfo(dstFormat);
+    table.resize(1ull << srcInfo.bits);
+    for (uint64_t bits = 0; bits < table.size(); ++bits)
+      table[bits] = static_cast<DstT>(
+          encodeFloat(decodeFloat(bits, srcInfo), dstInfo, rounding));
+  }
+  return table;
+}
+
+// fp32 -> bf16 is the most common conversion, use branch-free bit arithmetic
+// that the compiler can vectorize
+void convertFp32ToBf16(const uint32_t *src, uint16_t *dst, size_t numel,
+                       RoundingMode rounding) {
+  for (size_t i = 0; i < numel; ++i) {
+    uint32_t bits = src[i];
+    uint32_t rounded = rounding == RoundingMode::RTNE
+                           ? bits + 0x7fffu + ((bits >> 16) & 1u)
+                           : bits;
+    uint32_t nan = (bits & 0x80000000u) | 0x7fc00000u;
+    bool isNaN = (bits & 0x7fffffffu) > 0x7f800000u;
+    dst[i] = static_cast<uint16_t>((isNaN ? nan : rounded) >> 16);
+  }
+}
+
+template <typename SrcT, typename DstT>
+void convertFloat(const void *src, void *dst, size_t numel,
+                  FloatFormat srcFormat, FloatFormat dstFormat,
+                  RoundingMode rounding) {
+  auto *srcData = static_cast<const SrcT *>(src);
+  auto *dstData = static_cast<DstT *>(dst);
+  if constexpr (sizeof(SrcT) <= 2) {
+    const auto &table =
+        getConversionTable<DstT>(srcFormat, dstFormat, rounding);
+    for (size_t i = 0; i < numel; ++i)
+      dstData[i] = table[srcData[i]];
+  } else if constexpr (sizeof(SrcT) == 4 && sizeof(DstT) == 2) {
+    if (dstFormat == FloatFormat::BF16) {
+      convertFp32ToBf16(srcData, dstData, numel, rounding);
+      return;
+    }
+    convertFloatGeneric(srcData, dstData, numel, getFloatFormatInfo(srcFormat),
+                        getFloatFormatInfo(dstFormat), rounding);
+  } else {
+    convertFloatGeneric(srcData, dstData, numel, getFloatFormatInfo(srcFormat),
+                        getFloatFormatInfo(dstFormat), rounding);
+  }
+}
+
+template <typename SrcT>
+void convertFloat(const void *src, void *dst, size_t numel,
+                  FloatFormat srcFormat, FloatFormat dstFormat,
+                  RoundingMode rounding) {
+  switch (getFloatFormatInfo(dstFormat).bits) {
+  case 8:
+    return convertFloat<SrcT, uint8_t>(src, dst, numel, srcFormat, dstFormat,
+                                       rounding);
+  case 16:
+    return convertFloat<SrcT, uint16_t>(src, dst, numel, srcFormat, dstFormat,
+                                        rounding);
+  case 32:
+    return convertFloat<SrcT, uint32_t>(src, dst, numel, srcFormat, dstFormat,
+                                        rounding);
+  default:
+    return convertFloat<SrcT, uint64_t>(src, dst, numel, srcFormat, dstFormat,
+                                        rounding);
+  }
+}
+
+void convertFloat(const void *src, void *dst, size_t numel,
+                  FloatFormat srcFormat, FloatFormat dstFormat,
+                  RoundingMode rounding) {
+  switch (getFloatFormatInfo(srcFormat).bits) {
+  case 8:
+    return convertFloat<uint8_t>(src, dst, numel, srcFormat, dstFormat,
+                                 rounding);
+  case 16:
+    return convertFloat<uint16_t>(src, dst, numel, srcFormat, dstFormat,
+                                  rounding);
+  case 32:
+    return convertFloat<uint32_t>(src, dst, numel, srcFormat, dstFormat,
+                                  rounding);
+  default:
+    return convertFloat<uint64_t>(src, dst, numel, srcFormat, dstFormat,
+                                  rounding);
+  }
+}
+
+enum class InputPrecision { TF32, TF32x3, IEEE };
+
+// Mantissa bits kept by the accumulator of fp8 MMA instructions
+constexpr int kImpreciseAccMantissaBits = 13;
+
+// Tile of the output kept in cache while iterating over k
+constexpr size_t kDotTileM = 16;
+constexpr size_t kDotTileN = 128;
+
+struct DotConfig {
+  InputPrecision inputPrecision;
+  // Format the accumulator is rounded to after every MMA instruction
+  FloatFormat accFormat;
+  // Size of the k dimension handled by a single MMA instruction
+  size_t instrK;
+  // Number of k elements fp8 MMAs accumulate with reduced precision before
+  // the result is added to the fp32 accumulator, 0 for full precision
+  size_t maxNumImpreciseAcc;
+};
+
+uint32_t floatBits(float val) {
+  uint32_t bits;
+  std::memcpy(&bits, &val, sizeof(bits));
+  return bits;
+}
+
+float bitsFloat(uint32_t bits) {
+  float val;
+  std::memcpy(&val, &bits, sizeof(val));
+  return val;
+}
+
+float truncateMantissa(float val, int mantissaBits) {
+  uint32_t bits = floatBits(val);
+  if ((bits & 0x7fffffffu) > 0x7f800000u)
+    return val;
+  return bitsFloat(bits & ~((1u << (23 - mantissaBits)) - 1));
+}
+
+// cvt.rna.tf32.f32: round to nearest, ties away from zero
+float roundToTF32(float val) {
+  uint32_t bits = floatBits(val);
+  if ((bits & 0x7fffffffu) > 0x7f800000u)
+    return val;
+  return bitsFloat((bits + 0x1000u) & ~0x1fffu);
+}
+
+float roundAcc(float val, FloatFormat accFormat) {
+  if (accFormat == FloatFormat::FP32)
+    return val;
+  const auto &info = getFloatFormatInfo(accFormat);
+  return static_cast<float>(
+      decodeFloat(encodeFloat(val, info, RoundingMode::RTNE), info));
+}
+
+// c[M, N] += a[M, K] @ b[K, N] for row-major matrices, accumulating one MMA
+// instruction worth of k at a time like the GPU lowering does
+void gemm(const float *a, const float *b, float *c, size_t M, size_t N,
+          size_t K, const DotConfig &config) {
+  bool impreciseAcc = config.maxNumImpreciseAcc > 0;
+  // Like the WGMMA lowering, accumulate into a separate partial accumulator
+  // that is periodically added to c in full precision
+  bool partialAcc = impreciseAcc && config.maxNumImpreciseAcc <= K;
+  std::vector<float> partial(kDotTileM * kDotTileN);
+  std::vector<float> chunk(kDotTileM * kDotTileN);
+  for (size_t i0 = 0; i0 < M; i0 += kDotTileM) {
+    size_t tileM = std::min(kDotTileM, M - i0);
+    for (size_t j0 = 0; j0 < N; j0 += kDotTileN) {
+      size_t tileN = std::min(kDotTileN, N - j0);
+      std::fill(partial.begin(), partial.end(), 0.0f);
+      size_t numLowPrecisionAcc = 0;
+      for (size_t k0 = 0; k0 < K; k0 += config.instrK) {
+        size_t kEnd = std::min(K, k0 + config.instrK);
+        std::fill(chunk.begin(), chunk.end(), 0.0f);
+        for (size_t i = 0; i < tileM; ++i) {
+          float *chunkRow = &chunk[i * kDotTileN];
+          for (size_t k = k0; k < kEnd; ++k) {
+            float aik = a[(i0 + i) * K + k];
+            const float *bRow = b + k * N + j0;
+            for (size_t j = 0; j < tileN; ++j)
+              chunkRow[j] += aik * bRow[j];
+          }
+        }
+        numLowPrecisionAcc += kEnd - k0;
+        bool flush =
+            partialAcc && (numLowPrecisionAcc >= config.maxNumImpreciseAcc ||
+                           kEnd == K);
+        for (size_t i = 0; i < tileM; ++i) {
+          for (size_t j = 0; j < tileN; ++j) {
+            float &acc = c[(i0 + i) * N + j0 + j];
+            float val = chunk[i * kDotTileN + j];
+            if (partialAcc) {
+              float &p = partial[i * kDotTileN + j];
+              p = truncateMantissa(p + val, kImpreciseAccMantissaBits);
+              if (flush) {
+                acc += p;
+                p = 0.0f;
+              }
+            } else if (impreciseAcc) {
+              acc = truncateMantissa(acc + val, kImpreciseAccMantissaBits);
+            } else {
+              acc = roundAcc(acc + val, config.accFormat);
+            }
+          }
+        }
+        if (flush)
+          numLowPrecisionAcc = 0;
+      }
+    }
+  }
+}
+
+// c[batch, M, N] += a[batch, M, K] @ b[batch, K, N] with the operands rounded
+// to the input precision
+void dot(const float *a, const float *b, float *c, size_t batch, size_t M,
+         size_t N, size_t K, const DotConfig &config) {
+  auto roundOperand = [](const float *data, size_t numel, auto fn) {
+    std::vector<float> ret(numel);
+    std::transform(data, data + numel, ret.begin(), fn);
+    return ret;
+  };
+  auto toTF32 = [](float val) { return truncateMantissa(val, 10); };
+  for (size_t i = 0; i < batch; ++i) {
+    const float *batchA = a + i * M * K;
+    const float *batchB = b + i * K * N;
+    float *batchC = c + i * M * N;
+    switch (config.inputPrecision) {
+    case InputPrecision::IEEE:
+      gemm(batchA, batchB, batchC, M, N, K, config);
+      break;
+    case InputPrecision::TF32: {
+      // TF32 MMAs ignore the low mantissa bits of their fp32 operands
+      auto tf32A = roundOperand(batchA, M * K, toTF32);
+      auto tf32B = roundOperand(batchB, K * N, toTF32);
+      gemm(tf32A.data(), tf32B.data(), batchC, M, N, K, config);
+      break;
+    }
+    case InputPrecision::TF32x3: {
+      // Same decomposition as the F32DotTC pass:
+      // dot(aSmall, bBig) + dot(aBig, bSmall) + dot(aBig, bBig)
+      auto bigA = roundOperand(batchA, M * K, roundToTF32);
+      auto bigB = roundOperand(batchB, K * N, roundToTF32);
+      std::vector<float> smallA(M * K), smallB(K * N);
+      for (size_t j = 0; j < M * K; ++j)
+        smallA[j] = toTF32(batchA[j] - bigA[j]);
+      for (size_t j = 0; j < K * N; ++j)
+        smallB[j] = toTF32(batchB[j] - bigB[j]);
+      gemm(smallA.data(), bigB.data(), batchC, M, N, K, config);
+      gemm(bigA.data(), smallB.data(), batchC, M, N, K, config);
+      gemm(bigA.data(), bigB.data(), batchC, M, N, K, config);
+      break;
+    }
+    }
+  }
+}
+
 } // namespace
 
+void init_triton_interpreter_reduce(py::module &m);
+
 void init_triton_interpreter(py::module &&m) {
   using ret = py::return_value_policy;
 
@@ -327,49 +1168,184 @@ void init_triton_interpreter(py::module &&m) {
       .value("UMAX", RMWOp::UMAX)
       .export_values();
 
+  py::enum_<FloatFormat>(m, "FLOAT_FORMAT", py::module_local())
+      .value("FP8E4B15", FloatFormat::FP8E4B15)
+      .value("FP8E4NV", FloatFormat::FP8E4NV)
+      .value("FP8E4B8", FloatFormat::FP8E4B8)
+      .value("FP8E5", FloatFormat::FP8E5)
+      .value("FP8E5B16", FloatFormat::FP8E5B16)
+      .value("FP16", FloatFormat::FP16)
+      .value("BF16", FloatFormat::BF16)
+      .value("FP32", FloatFormat::FP32)
+      .value("FP64", FloatFormat::FP64)
+      .export_values();
+
+  py::enum_<RoundingMode>(m, "ROUNDING_MODE", py::module_local())
+      .value("RTNE", RoundingMode::RTNE)
+      .value("RTZ", RoundingMode::RTZ)
+      .export_values();
+
+  py::enum_<InputPrecision>(m, "INPUT_PRECISION", py::module_local())
+      .value("TF32", InputPrecision::TF32)
+      .value("TF32x3", InputPrecision::TF32x3)
+      .value("IEEE", InputPrecision::IEEE)
+      .export_values();
+
   m.def("load",
-        [](py::array_t<uint64_t> ptr, py::array_t<bool> mask, py::array other,
-           py::dtype ret_dtype) -> py::array {
-          int numel = ptr.size();
+        [](contiguous_array<uint64_t> ptr, contiguous_array<bool> mask,
+           py::array other, py::dtype ret_dtype) -> py::array {
+          size_t numel = ptr.size();
           auto shape =
               std::vector<ptrdiff_t>(ptr.shape(), ptr.shape() + ptr.ndim());
-          py::array ret(ret_dtype, py::array::ShapeContainer{numel});
-          py::array_t<uint64_t> reshaped_ptr = ptr.reshape({numel});
-          py::array_t<bool> reshaped_mask = mask.reshape({numel});
-          py::array reshaped_others = other.reshape({numel});
-          for (size_t i = 0; i < ptr.size(); ++i) {
-            if (reshaped_mask.at(i))
-              memcpy(ret.mutable_data(i),
-                     reinterpret_cast<void *>(reshaped_ptr.at(i)),
-                     ret_dtype.itemsize());
-            else
-              memcpy(ret.mutable_data(i), reshaped_others.data(i),
-                     ret_dtype.itemsize());
+          py::array ret(ret_dtype, shape);
+          other = py::array::ensure(other, py::array::c_style);
+          if (mask.size() != numel || other.size() != numel)
+            throw std::invalid_argument("Mismatched load operand sizes");
+          auto *ptr_data = ptr.data();
+          auto *mask_data = mask.data();
+          auto *other_data = other.data();
+          auto *ret_data = ret.mutable_data();
+          auto itemsize = ret_dtype.itemsize();
+          {
+            // Other programs may be interpreted concurrently
+            py::gil_scoped_release allow_threads;
+            load(ptr_data, mask_data, other_data, ret_data, numel, itemsize);
           }
-          return ret.reshape(shape);
+          return ret;
         });
 
-  m.def("store",
-        [](py::array_t<uint64_t> ptr, py::array value, py::array_t<bool> mask) {
-          int numel = ptr.size();
-          py::array_t<uint64_t> reshaped_ptr = ptr.reshape({numel});
-          py::array_t<int8_t> reshaped_mask = mask.reshape({numel});
-          py::array reshaped_value = value.reshape({numel});
-          for (size_t i = 0; i < ptr.size(); ++i) {
-            if (reshaped_mask.at(i)) {
-              memcpy(reinterpret_cast<void *>(reshaped_ptr.mutable_at(i)),
-                     reshaped_value.data(i), value.dtype().itemsize());
-            }
+  m.def("store", [](contiguous_array<uint64_t> ptr, py::array value,
+                    contiguous_array<bool> mask) {
+    size_t numel = ptr.size();
+    value = py::array::ensure(value, py::array::c_style);
+    if (mask.size() != numel || value.size() != numel)
+      throw std::invalid_argument("Mismatched store operand sizes");
+    auto *ptr_data = ptr.data();
+    auto *mask_data = mask.data();
+    auto *value_data = value.data();
+    auto itemsize = value.dtype().itemsize();
+    {
+      py::gil_scoped_release allow_threads;
+      store(ptr_data, value_data, mask_data, numel, itemsize);
+    }
+  });
+
+  // Loads and stores through block pointers copy directly between memory and
+  // the tensor, without materializing a pointer per element
+  m.def("load_block",
+        [](uint64_t base, std::vector<int64_t> shape,
+           std::vector<int64_t> strides, std::vector<int64_t> offsets,
+           std::vector<int64_t> tensor_shape, std::vector<int> boundary_check,
+           py::array other, py::dtype ret_dtype) -> py::array {
+          BlockPointer ptr(base, std::move(shape), std::move(strides),
+                           std::move(offsets), boundary_check,
+                           tensor_shape.size());
+          other = py::array::ensure(other, py::array::c_style);
+          size_t itemsize = ret_dtype.itemsize();
+          if (other.size() != 1 || other.itemsize() != itemsize)
+            throw std::invalid_argument("Mismatched padding value");
+          py::array ret(ret_dtype, tensor_shape);
+          auto *ret_data = static_cast<char *>(ret.mutable_data());
+          auto *other_data = static_cast<const char *>(other.data());
+          {
+            py::gil_scoped_release allow_threads;
+            copyBlock</*IsLoad=*/true>(ptr, tensor_shape, ret_data, other_data,
+                                       itemsize);
+          }
+          return ret;
+        });
+
+  m.def("store_block",
+        [](uint64_t base, std::vector<int64_t> shape,
+           std::vector<int64_t> strides, std::vector<int64_t> offsets,
+           std::vector<int> boundary_check, py::array value) {
+          value = py::array::ensure(value, py::array::c_style);
+          auto tensor_shape =
+              std::vector<int64_t>(value.shape(), value.shape() + value.ndim());
+          BlockPointer ptr(base, std::move(shape), std::move(strides),
+                           std::move(offsets), boundary_check,
+                           tensor_shape.size());
+          auto *value_data = static_cast<const char *>(value.data());
+          size_t itemsize = value.itemsize();
+          {
+            py::gil_scoped_release allow_threads;
+            copyBlock</*IsLoad=*/false>(ptr, tensor_shape, value_data,
+                                        nullptr, itemsize);
+          }
+        });
+
+  // Converts the bits of floats in src_format to the bits of floats in
+  // dst_format, returned as an unsigned integer array of the same shape
+  m.def("convert_float",
+        [](py::array input, FloatFormat src_format, FloatFormat dst_format,
+           RoundingMode rounding) -> py::array {
+          input = py::array::ensure(input, py::array::c_style);
+          int src_bits = getFloatFormatInfo(src_format).bits;
+          int dst_bits = getFloatFormatInfo(dst_format).bits;
+          if (input.itemsize() * 8 != src_bits)
+            throw std::invalid_argument("Mismatched source float format");
+          auto shape = std::vector<ptrdiff_t>(input.shape(),
+                                              input.shape() + input.ndim());
+          py::dtype ret_dtype = dst_bits == 8    ? py::dtype::of<uint8_t>()
+                                : dst_bits == 16 ? py::dtype::of<uint16_t>()
+                                : dst_bits == 32 ? py::dtype::of<uint32_t>()
+                                                 : py::dtype::of<uint64_t>();
+          py::array ret(ret_dtype, shape);
+          auto *src_data = input.data();
+          auto *ret_data = ret.mutable_data();
+          size_t numel = input.size();
+          {
+            py::gil_scoped_release allow_threads;
+            convertFloat(src_data, ret_data, numel, src_format, dst_format,
+                         rounding);
           }
+          return ret;
+        });
+
+  // Computes a @ b + c over the last two dimensions of fp32 arrays, with the
+  // leading dimensions as batch dimensions
+  m.def("dot",
+        [](contiguous_array<float> a, contiguous_array<float> b,
+           contiguous_array<float> c, InputPrecision input_precision,
+           FloatFormat acc_format, size_t instr_k,
+           size_t max_num_imprecise_acc) -> py::array_t<float> {
+          if (a.ndim() < 2 || b.ndim() != a.ndim() || c.ndim() != a.ndim())
+            throw std::invalid_argument("Mismatched dot operand ranks");
+          int ndim = a.ndim();
+          size_t M = a.shape(ndim - 2);
+          size_t K = a.shape(ndim - 1);
+          size_t N = b.shape(ndim - 1);
+          size_t batch = M * K == 0 ? 0 : a.size() / (M * K);
+          if (b.shape(ndim - 2) != K || c.shape(ndim - 2) != M ||
+              c.shape(ndim - 1) != N || b.size() != batch * K * N ||
+              c.size() != batch * M * N)
+            throw std::invalid_argument("Mismatched dot operand shapes");
+          auto shape = std::vector<ptrdiff_t>(c.shape(), c.shape() + ndim);
+          py::array_t<float> ret(shape);
+          std::memcpy(ret.mutable_data(), c.data(), c.nbytes());
+          DotConfig config{input_precision, acc_format,
+                           std::max<size_t>(instr_k, 1), max_num_imprecise_acc};
+          auto *a_data = a.data();
+          auto *b_data = b.data();
+          auto *ret_data = ret.mutable_data();
+          {
+            py::gil_scoped_release allow_threads;
+            dot(a_data, b_data, ret_data, batch, M, N, K, config);
+          }
+          return ret;
         });
 
   m.def("atomic_rmw",
-        [](RMWOp rmw_op, py::array_t<uint64_t> ptr, py::array val,
-           py::array_t<bool> mask, MemSemantic sem) -> py::array {
+        [](RMWOp rmw_op, contiguous_array<uint64_t> ptr, py::array val,
+           contiguous_array<bool> mask, MemSemantic sem) -> py::array {
           int order = mem_semantic_map[sem];
           int numel = ptr.size();
           auto shape =
               std::vector<ptrdiff_t>(ptr.shape(), ptr.shape() + ptr.ndim());
+          // Operands may be broadcast views with zero strides
+          val = py::array::ensure(val, py::array::c_style);
+          if (mask.size() != numel || val.size() != numel)
+            throw std::invalid_argument("Mismatched atomic_rmw operand sizes");
           auto ret_dtype = val.dtype();
           py::array ret(ret_dtype, py::array::ShapeContainer{numel});
           py::array_t<uint64_t> reshaped_ptr = ptr.reshape({numel});
@@ -406,17 +1382,24 @@ void init_triton_interpreter(py::module &&m) {
 
 #undef MAKE_ATOMIC_RMW_OP
 
-          atomic_op->apply();
+          {
+            py::gil_scoped_release allow_threads;
+            atomic_op->apply();
+          }
           return ret.reshape(shape);
         });
 
   m.def("atomic_cas",
-        [](py::array_t<uint64_t> ptr, py::array &cmp, py::array &val,
+        [](contiguous_array<uint64_t> ptr, py::array cmp, py::array val,
            MemSemantic sem) -> py::array {
           int order = mem_semantic_map[sem];
           int numel = ptr.size();
           auto shape =
               std::vector<ptrdiff_t>(ptr.shape(), ptr.shape() + ptr.ndim());
+          cmp = py::array::ensure(cmp, py::array::c_style);
+          val = py::array::ensure(val, py::array::c_style);
+          if (cmp.size() != numel || val.size() != numel)
+            throw std::invalid_argument("Mismatched atomic_cas operand sizes");
           auto ret_dtype = cmp.dtype();
           py::array ret(ret_dtype, py::array::ShapeContainer{numel});
           py::array_t<uint64_t> reshaped_ptr = ptr.reshape({numel});
@@ -426,10 +1409,15 @@ void init_triton_interpreter(py::module &&m) {
           memcpy(static_cast<void *>(ret.mutable_data()),
                  static_cast<const void *>(reshaped_cmp.data()),
                  itemsize * numel);
-          AtomicCASOp(reshaped_ptr.data(), ret.mutable_data(),
-                      static_cast<const void *>(reshaped_val.data()), itemsize,
-                      numel, order)
-              .apply();
+          AtomicCASOp atomic_op(reshaped_ptr.data(), ret.mutable_data(),
+                                static_cast<const void *>(reshaped_val.data()),
+                                itemsize, numel, order);
+          {
+            py::gil_scoped_release allow_threads;
+            atomic_op.apply();
+          }
           return ret.reshape(shape);
         });
+
+  init_triton_interpreter_reduce(m);
 }
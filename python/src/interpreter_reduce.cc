@@ -0,0 +1,334 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace py = pybind11;
+
+namespace {
+
+// Combine functions the interpreter runs natively instead of calling the
+// Python combine_fn element by element.
+enum class CombineOp { ADD, MUL, MAX, MIN, AND, OR, XOR };
+
+template <typename T>
+using contiguous_array =
+    py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+template <typename T> bool isNaN(T val) {
+  if constexpr (std::is_floating_point_v<T>)
+    return std::isnan(val);
+  else
+    return false;
+}
+
+template <typename T, CombineOp Op> struct Combine;
+
+template <typename T> struct Combine<T, CombineOp::ADD> {
+  static T apply(T a, T b) {
+    // Signed integers wrap around like on the GPU instead of overflowing
+    if constexpr (std::is_integral_v<T>) {
+      using U = std::make_unsigned_t<T>;
+      return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+    } else {
+      return a + b;
+    }
+  }
+};
+
+template <typename T> struct Combine<T, CombineOp::MUL> {
+  static T apply(T a, T b) {
+    if constexpr (std::is_integral_v<T>) {
+      using U = std::make_unsigned_t<T>;
+      // Promote to at least unsigned int so that small types don't multiply
+      // as (signed) int
+      using P = std::common_type_t<U, unsigned>;
+      return static_cast<T>(static_cast<P>(static_cast<U>(a)) *
+                            static_cast<P>(static_cast<U>(b)));
+    } else {
+      return a * b;
+    }
+  }
+};
+
+// Max and min propagate NaNs, like the NumPy reference the interpreter used
+// before.
+template <typename T> struct Combine<T, CombineOp::MAX> {
+  static T apply(T a, T b) {
+    if (isNaN(a))
+      return a;
+    if (isNaN(b))
+      return b;
+    return a < b ? b : a;
+  }
+};
+
+template <typename T> struct Combine<T, CombineOp::MIN> {
+  static T apply(T a, T b) {
+    if (isNaN(a))
+      return a;
+    if (isNaN(b))
+      return b;
+    return b < a ? b : a;
+  }
+};
+
+template <typename T> struct Combine<T, CombineOp::AND> {
+  static T apply(T a, T b) { return a & b; }
+};
+
+template <typename T> struct Combine<T, CombineOp::OR> {
+  static T apply(T a, T b) { return a | b; }
+};
+
+template <typename T> struct Combine<T, CombineOp::XOR> {
+  static T apply(T a, T b) { return a ^ b; }
+};
+
+// The reduced axis splits a C-contiguous array into [outer, axisSize, inner].
+// Iterating over `inner` in the innermost loop keeps memory accesses
+// contiguous for every axis.
+struct AxisView {
+  size_t outer = 1;
+  size_t axisSize = 1;
+  size_t inner = 1;
+
+  AxisView(const py::array &array, int axis) {
+    if (axis < 0 || axis >= array.ndim())
+      throw std::invalid_argument("Invalid reduction axis");
+    for (int i = 0; i < array.ndim(); ++i) {
+      if (i < axis)
+        outer *= array.shape(i);
+      else if (i == axis)
+        axisSize = array.shape(i);
+      else
+        inner *= array.shape(i);
+    }
+  }
+};
+
+template <typename T, CombineOp Op>
+void reduceImpl(const T *in, T *out, const AxisView &view) {
+  for (size_t o = 0; o < view.outer; ++o) {
+    const T *src = in + o * view.axisSize * view.inner;
+    T *dst = out + o * view.inner;
+    std::copy(src, src + view.inner, dst);
+    for (size_t k = 1; k < view.axisSize; ++k) {
+      const T *row = src + k * view.inner;
+      for (size_t i = 0; i < view.inner; ++i)
+        dst[i] = Combine<T, Op>::apply(dst[i], row[i]);
+    }
+  }
+}
+
+template <typename T, CombineOp Op>
+void scanImpl(const T *in, T *out, const AxisView &view, bool reverse) {
+  for (size_t o = 0; o < view.outer; ++o) {
+    const T *src = in + o * view.axisSize * view.inner;
+    T *dst = out + o * view.axisSize * view.inner;
+    for (size_t step = 0; step < view.axisSize; ++step) {
+      size_t k = reverse ? view.axisSize - 1 - step : step;
+      const T *row = src + k * view.inner;
+      T *acc = dst + k * view.inner;
+      if (step == 0) {
+        std::copy(row, row + view.inner, acc);
+        continue;
+      }
+      const T *prev = reverse ? acc + view.inner : acc - view.inner;
+      for (size_t i = 0; i < view.inner; ++i)
+        acc[i] = Combine<T, Op>::apply(prev[i], row[i]);
+    }
+  }
+}
+
+// Reduction of (value, index) pairs as done by argmax/argmin: ties are broken
+// in favor of the smallest index.
+template <typename T, CombineOp Op>
+void argReduceImpl(const T *in, const int32_t *indices, T *out,
+                   int32_t *outIndices, const AxisView &view) {
+  static_assert(Op == CombineOp::MAX || Op == CombineOp::MIN);
+  for (size_t o = 0; o < view.outer; ++o) {
+    const T *src = in + o * view.axisSize * view.inner;
+    const int32_t *srcIndices = indices + o * view.axisSize * view.inner;
+    T *dst = out + o * view.inner;
+    int32_t *dstIndices = outIndices + o * view.inner;
+    std::copy(src, src + view.inner, dst);
+    std::copy(srcIndices, srcIndices + view.inner, dstIndices);
+    for (size_t k = 1; k < view.axisSize; ++k) {
+      const T *row = src + k * view.inner;
+      const int32_t *rowIndices = srcIndices + k * view.inner;
+      for (size_t i = 0; i < view.inner; ++i) {
+        T best = Combine<T, Op>::apply(dst[i], row[i]);
+        bool takeRow = false;
+        if (isNaN(best)) {
+          takeRow = !isNaN(dst[i]) ||
+                    (isNaN(row[i]) && rowIndices[i] < dstIndices[i]);
+        } else if (row[i] == dst[i]) {
+          takeRow = rowIndices[i] < dstIndices[i];
+        } else {
+          takeRow = best == row[i];
+        }
+        if (takeRow) {
+          dst[i] = row[i];
+          dstIndices[i] = rowIndices[i];
+        }
+      }
+    }
+  }
+}
+
+std::vector<ptrdiff_t> reducedShape(const py::array &array, int axis) {
+  std::vector<ptrdiff_t> shape;
+  for (int i = 0; i < array.ndim(); ++i) {
+    if (i != axis)
+      shape.push_back(array.shape(i));
+  }
+  return shape;
+}
+
+// Calls FN<T, Op>(...) for the data type and combine op of the input.
+// Bitwise ops are only instantiated for integer types.
+template <typename T, template <typename, CombineOp> class FN,
+          typename... Args>
+bool dispatchOp(CombineOp op, Args &&...args) {
+  switch (op) {
+  case CombineOp::ADD:
+    FN<T, CombineOp::ADD>::call(std::forward<Args>(args)...);
+    return true;
+  case CombineOp::MUL:
+    FN<T, CombineOp::MUL>::call(std::forward<Args>(args)...);
+    return true;
+  case CombineOp::MAX:
+    FN<T, CombineOp::MAX>::call(std::forward<Args>(args)...);
+    return true;
+  case CombineOp::MIN:
+    FN<T, CombineOp::MIN>::call(std::forward<Args>(args)...);
+    return true;
+  default:
+    break;
+  }
+  if constexpr (std::is_integral_v<T>) {
+    switch (op) {
+    case CombineOp::AND:
+      FN<T, CombineOp::AND>::call(std::forward<Args>(args)...);
+      return true;
+    case CombineOp::OR:
+      FN<T, CombineOp::OR>::call(std::forward<Args>(args)...);
+      return true;
+    case CombineOp::XOR:
+      FN<T, CombineOp::XOR>::call(std::forward<Args>(args)...);
+      return true;
+    default:
+      break;
+    }
+  }
+  return false;
+}
+
+template <typename T, CombineOp Op> struct Reduce {
+  static void call(const py::array &in, py::array &out, int axis) {
+    py::gil_scoped_release allow_threads;
+    reduceImpl<T, Op>(static_cast<const T *>(in.data()),
+                      static_cast<T *>(out.mutable_data()), AxisView(in, axis));
+  }
+};
+
+template <typename T, CombineOp Op> struct Scan {
+  static void call(const py::array &in, py::array &out, int axis,
+                   bool reverse) {
+    py::gil_scoped_release allow_threads;
+    scanImpl<T, Op>(static_cast<const T *>(in.data()),
+                    static_cast<T *>(out.mutable_data()), AxisView(in, axis),
+                    reverse);
+  }
+};
+
+template <typename T, CombineOp Op> struct ArgReduce {
+  static void call(const py::array &in, const contiguous_array<int32_t> &idx,
+                   py::array &out, contiguous_array<int32_t> &outIdx,
+                   int axis) {
+    if constexpr (Op == CombineOp::MAX || Op == CombineOp::MIN) {
+      py::gil_scoped_release allow_threads;
+      argReduceImpl<T, Op>(static_cast<const T *>(in.data()), idx.data(),
+                           static_cast<T *>(out.mutable_data()),
+                           outIdx.mutable_data(), AxisView(in, axis));
+    } else {
+      throw std::invalid_argument("Unsupported arg reduction");
+    }
+  }
+};
+
+template <template <typename, CombineOp> class FN, typename... Args>
+void dispatch(const py::dtype &dtype, CombineOp op, Args &&...args) {
+  bool done = false;
+  auto tryType = [&](auto tag) {
+    using T = decltype(tag);
+    if (!done && dtype.is(py::dtype::of<T>()))
+      done = dispatchOp<T, FN>(op, std::forward<Args>(args)...);
+  };
+  tryType(int8_t{});
+  tryType(uint8_t{});
+  tryType(int16_t{});
+  tryType(uint16_t{});
+  tryType(int32_t{});
+  tryType(uint32_t{});
+  tryType(int64_t{});
+  tryType(uint64_t{});
+  tryType(float{});
+  tryType(double{});
+  if (!done)
+    throw std::invalid_argument("Unsupported data type or combine op");
+}
+
+} // namespace
+
+void init_triton_interpreter_reduce(py::module &m) {
+  py::enum_<CombineOp>(m, "COMBINE_OP", py::module_local())
+      .value("ADD", CombineOp::ADD)
+      .value("MUL", CombineOp::MUL)
+      .value("MAX", CombineOp::MAX)
+      .value("MIN", CombineOp::MIN)
+      .value("AND", CombineOp::AND)
+      .value("OR", CombineOp::OR)
+      .value("XOR", CombineOp::XOR)
+      .export_values();
+
+  m.def("reduce", [](CombineOp op, py::array input, int axis) -> py::array {
+    input = py::array::ensure(input, py::array::c_style);
+    if (input.shape(axis) == 0)
+      throw std::invalid_argument("Can't reduce an empty axis");
+    py::array ret(input.dtype(), reducedShape(input, axis));
+    dispatch<Reduce>(input.dtype(), op, input, ret, axis);
+    return ret;
+  });
+
+  m.def("scan",
+        [](CombineOp op, py::array input, int axis, bool reverse) -> py::array {
+          input = py::array::ensure(input, py::array::c_style);
+          auto shape = std::vector<ptrdiff_t>(
+              input.shape(), input.shape() + input.ndim());
+          py::array ret(input.dtype(), shape);
+          dispatch<Scan>(input.dtype(), op, input, ret, axis, reverse);
+          return ret;
+        });
+
+  m.def("arg_reduce",
+        [](CombineOp op, py::array input, contiguous_array<int32_t> indices,
+           int axis) -> py::tuple {
+          input = py::array::ensure(input, py::array::c_style);
+          if (indices.size() != input.size())
+            throw std::invalid_argument("Mismatched value and index sizes");
+          if (input.shape(axis) == 0)
+            throw std::invalid_argument("Can't reduce an empty axis");
+          auto shape = reducedShape(input, axis);
+          py::array ret(input.dtype(), shape);
+          contiguous_array<int32_t> retIndices(shape);
+          dispatch<ArgReduce>(input.dtype(), op, input, indices, ret,
+                              retIndices, axis);
+          return py::make_tuple(ret, retIndices);
+        });
+}
@@ -1477,6 +1477,11 @@ void init_triton_ir(py::module &&m) {
               bool reverse) -> OpState {
              return self.create<ScanOp>(operands, axis, reverse);
            })
+      .def("create_cross_program_scan",
+           [](TritonOpBuilder &self, std::vector<Value> operands,
+              Value &workspace) -> OpState {
+             return self.create<CrossProgramScanOp>(operands, workspace);
+           })
       .def("create_scan_ret",
            [](TritonOpBuilder &self, py::args args) -> OpState {
              llvm::SmallVector<Value> return_values;
@@ -1485,6 +1490,15 @@ void init_triton_ir(py::module &&m) {
              }
              return self.create<ScanReturnOp>(return_values);
            })
+      .def("create_sort",
+           [](TritonOpBuilder &self, std::vector<Value> operands, int axis,
+              std::optional<int> k) -> OpState {
+             return self.create<SortOp>(operands, axis, k);
+           })
+      .def("create_sort_ret",
+           [](TritonOpBuilder &self, Value &result) -> OpState {
+             return self.create<SortReturnOp>(result);
+           })
       .def("create_ptr_to_int",
            [](TritonOpBuilder &self, Value &val, Type &type) -> Value {
              return self.create<PtrToIntOp>(type, val);
@@ -51,6 +51,37 @@ def test_block_copy(dtypes_str, n, padding_option, device):
         assert torch.all(torch.isnan(b[n // 2:n]))
 
 
+@triton.jit
+def block_shift_kernel(a_ptr, b_ptr, N, SHIFT, BLOCK_SIZE: tl.constexpr):
+    pid = tl.program_id(0)
+    a_block_ptr = tl.make_block_ptr(base=a_ptr, shape=(N, ), strides=(1, ), offsets=(pid * BLOCK_SIZE, ),
+                                    block_shape=(BLOCK_SIZE, ), order=(0, ))
+    b_block_ptr = tl.make_block_ptr(base=b_ptr, shape=(N, ), strides=(1, ), offsets=(pid * BLOCK_SIZE, ),
+                                    block_shape=(BLOCK_SIZE, ), order=(0, ))
+    # SHIFT is negative, so the first block starts before the tensors
+    a = tl.load(tl.advance(a_block_ptr, (SHIFT, )), boundary_check=(0, ), padding_option="zero")
+    tl.store(tl.advance(b_block_ptr, (SHIFT, )), a, boundary_check=(0, ))
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("batch_grid", [False, True])
+def test_block_copy_negative_offsets(batch_grid, device, monkeypatch):
+    # Batched grid mode materializes the pointers of block pointers instead of copying natively
+    monkeypatch.setenv("TRITON_INTERPRET_BATCH_GRID", "1" if batch_grid else "0")
+    n, shift = 256, -40
+    # The elements before a and b are guards, which must be neither read nor written
+    a_buf = torch.full((2 * n, ), 7, device=device, dtype=torch.int32)
+    b_buf = torch.full((2 * n, ), -1, device=device, dtype=torch.int32)
+    a, b = a_buf[n:], b_buf[n:]
+    a.copy_(torch.arange(n, device=device, dtype=torch.int32))
+
+    grid = lambda meta: (triton.cdiv(n, meta["BLOCK_SIZE"]), )
+    block_shift_kernel[grid](a, b, n, shift, BLOCK_SIZE=64)
+    assert torch.all(b_buf[:n] == -1)
+    assert torch.all(b[:n + shift] == a[:n + shift])
+    assert torch.all(b[n + shift:] == -1)
+
+
 @triton.jit
 def matmul_no_scf_with_advance_kernel(  #
         a_ptr, b_ptr, c_ptr,  #
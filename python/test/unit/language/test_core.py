@@ -1439,6 +1439,89 @@ def test_atomic_rmw_predicate(num_ctas, device):
     assert x.item() == 63
 
 
+@pytest.mark.interpreter
+@pytest.mark.parametrize("num_workers", [2, 0])
+def test_interpreter_parallel_grid(num_workers, device, monkeypatch):
+    if not is_interpreter():
+        pytest.skip("parallel grid execution is specific to the interpreter")
+    monkeypatch.setenv("TRITON_INTERPRET_NUM_WORKERS", str(num_workers))
+
+    @triton.jit
+    def kernel(X, Y, Z, BLOCK: tl.constexpr):
+        pid = tl.program_id(0) * tl.num_programs(1) + tl.program_id(1)
+        offs = pid * BLOCK + tl.arange(0, BLOCK)
+        x = tl.load(X + offs)
+        tl.store(Y + offs, x * 2)
+        tl.atomic_add(Z, tl.sum(x, axis=0))
+
+    BLOCK = 16
+    grid = (64, 4)
+    x = torch.arange(grid[0] * grid[1] * BLOCK, device=device, dtype=torch.int32)
+    y = torch.empty_like(x)
+    z = torch.zeros((1, ), device=device, dtype=torch.int32)
+    kernel[grid](x, y, z, BLOCK)
+    torch.testing.assert_close(y, x * 2)
+    assert z.item() == x.sum().item()
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("divergent", [False, True])
+def test_interpreter_batched_grid(divergent, device, monkeypatch):
+    if not is_interpreter():
+        pytest.skip("batched grid execution is specific to the interpreter")
+    monkeypatch.setenv("TRITON_INTERPRET_BATCH_GRID", "1")
+
+    @triton.jit
+    def kernel(X, Y, Z, N, BLOCK: tl.constexpr, DIVERGENT: tl.constexpr):
+        pid = tl.program_id(0)
+        offs = pid * BLOCK + tl.arange(0, BLOCK)
+        mask = offs < N
+        x = tl.load(X + offs, mask=mask, other=0.0)
+        y = x - tl.max(x, axis=0)
+        tl.store(Y + offs, tl.cumsum(y, axis=0), mask=mask)
+        if DIVERGENT:
+            # Control flow that depends on the program id falls back to per-program execution
+            if pid % 2 == 0:
+                tl.store(Y + offs, tl.load(Y + offs, mask=mask) * 2, mask=mask)
+        tl.atomic_add(Z + pid % 4, tl.sum(x, axis=0))
+
+    BLOCK = 32
+    N = 1000
+    x = torch.randn(N, device=device, dtype=torch.float32)
+    y = torch.empty_like(x)
+    z = torch.zeros((4, ), device=device, dtype=torch.float32)
+    grid = (triton.cdiv(N, BLOCK), )
+    kernel[grid](x, y, z, N, BLOCK, divergent)
+
+    x_ref = torch.nn.functional.pad(x, (0, grid[0] * BLOCK - N)).reshape(grid[0], BLOCK)
+    y_ref = torch.cumsum(x_ref - x_ref.max(dim=1, keepdim=True).values, dim=1)
+    if divergent:
+        y_ref[0::2] *= 2
+    z_ref = torch.stack([x_ref[i::4].sum() for i in range(4)])
+    torch.testing.assert_close(y, y_ref.reshape(-1)[:N])
+    torch.testing.assert_close(z, z_ref)
+
+
+@pytest.mark.interpreter
+def test_interpreter_batched_grid_error(monkeypatch):
+    if not is_interpreter():
+        pytest.skip("batched grid execution is specific to the interpreter")
+    monkeypatch.setenv("TRITON_INTERPRET_BATCH_GRID", "1")
+
+    @triton.jit
+    def kernel(X, Z):
+        tl.atomic_add(Z, 1)
+        tl.device_assert(tl.load(X + tl.program_id(0)) > 0, "x <= 0")
+
+    # Errors of the kernel itself are reported instead of rerunning the grid program by program.
+    # Host tensors are updated in place, so z also reflects the side effects of the failed launch.
+    x = torch.zeros((8, ), device="cpu", dtype=torch.int32)
+    z = torch.zeros((1, ), device="cpu", dtype=torch.int32)
+    with pytest.raises(triton.runtime.errors.InterpreterError):
+        kernel[(8, )](x, z)
+    assert z.item() == 8
+
+
 @pytest.mark.interpreter
 @pytest.mark.parametrize("shape, axis, num_ctas, dtype_x_str",
                          [(shape, axis, num_ctas, dtype_x_str)
@@ -1577,10 +1660,8 @@ def test_tensor_atomic_cas(sem, num_ctas, device):
 @pytest.mark.parametrize("num_ctas", num_ctas_list)
 def test_cast(dtype_x, dtype_z, bitcast, size, num_ctas, device):
     # CUDA: bfloat16 on cc < 80 will not be tested
-    # Interpreter: Only bfloat16 <-> float32 is supported
-    if not is_interpreter() or \
-        (is_interpreter() and not ((dtype_z == 'bfloat16' and dtype_x == 'float32')
-                                   or (dtype_z == 'float32' and dtype_x == 'bfloat16'))):
+    # Interpreter: bfloat16 is only supported by casts
+    if not is_interpreter():
         check_type_supported(dtype_x, device)
         check_type_supported(dtype_z, device)
 
@@ -2400,6 +2481,57 @@ def test_scan2d(op, dtype_str, shape, axis, reverse, num_warps, device):
         np.testing.assert_equal(z_ref, z_tri)
 
 
+@triton.jit
+def add_combine(a, b):
+    return a + b
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("op", ['cumsum', 'get_first_element', 'linear_recurrence'])
+@pytest.mark.parametrize("num_programs, BLOCK", [(1, 128), (7, 128), (64, 256)])
+def test_cross_program_scan(op, num_programs, BLOCK, device):
+    # The programs along axis 1 of the grid scan separate rows.
+    NUM_ROWS = 2
+
+    @triton.jit
+    def kernel(X, Y, Z, WORKSPACE, BLOCK: tl.constexpr):
+        offs = (tl.program_id(1) * tl.num_programs(0) + tl.program_id(0)) * BLOCK + tl.arange(0, BLOCK)
+        x = tl.load(X + offs)
+        y = tl.load(Y + offs)
+        GENERATE_TEST_HERE
+        tl.store(Z + offs, z)
+
+    if op == 'linear_recurrence':
+        scan = f'_, z = tl.associative_scan((x, y), 0, {op}, workspace=WORKSPACE)'
+    else:
+        scan = f'z = tl.associative_scan(x, 0, {"add_combine" if op == "cumsum" else op}, workspace=WORKSPACE)'
+    kernel = patch_kernel(kernel, {'GENERATE_TEST_HERE': scan})
+
+    rs = RandomState(17)
+    shape = (NUM_ROWS, num_programs * BLOCK)
+    # Sample in -1, 0, 1 so that the integer recurrence does not overflow
+    x = rs.randint(-1, 2, shape, dtype='int32')
+    y = rs.randint(-1, 2, shape, dtype='int32')
+    if op == 'cumsum':
+        z_ref = np.cumsum(x, axis=1).astype('int32')
+    elif op == 'get_first_element':
+        z_ref = np.broadcast_to(x[:, :1], shape)
+    else:
+        z_ref = np.empty_like(x)
+        acc = np.zeros(NUM_ROWS, dtype='int32')
+        for i in range(shape[1]):
+            acc = x[:, i] * acc + y[:, i]
+            z_ref[:, i] = acc
+
+    num_operands = 2 if op == 'linear_recurrence' else 1
+    x_tri = to_triton(x, device=device)
+    y_tri = to_triton(y, device=device)
+    z_tri = to_triton(np.empty_like(x), device=device)
+    workspace = torch.zeros(NUM_ROWS * num_programs * (8 + 16 * num_operands), dtype=torch.uint8, device=device)
+    kernel[(num_programs, NUM_ROWS)](x_tri, y_tri, z_tri, workspace, BLOCK=BLOCK)
+    np.testing.assert_equal(z_ref, to_numpy(z_tri))
+
+
 scan_layouts = [
     BlockedLayout([1, 4], [4, THREADS_PER_WARP // 4], [4, 1], [0, 1], [1, 1], [1, 1], [0, 1]),
     BlockedLayout([1, 4], [8, THREADS_PER_WARP // 8], [4, 1], [0, 1], [1, 1], [1, 1], [0, 1]),
@@ -2414,13 +2546,112 @@ scan_layouts = [
     BlockedLayout([1, 2], [1, THREADS_PER_WARP // 1], [1, 4], [1, 0], [1, 1], [1, 1], [0, 1]),
 ]
 
+# Scans of these layouts are lowered from their linear layout.
+mma_scan_layouts = [
+    MmaLayout(version=(2, 0), warps_per_cta=[4, 1], ctas_per_cga=[1, 1], cta_split_num=[1, 1], cta_order=[0, 1],
+              instr_shape=[16, 8]),
+    MmaLayout(version=(2, 0), warps_per_cta=[2, 2], ctas_per_cga=[1, 1], cta_split_num=[1, 1], cta_order=[0, 1],
+              instr_shape=[16, 8]),
+    MfmaLayout(version=(2, 0), warps_per_cta=[2, 2], instr_shape=[32, 32], is_transposed=False),
+    MfmaLayout(version=(2, 0), warps_per_cta=[4, 1], instr_shape=[32, 32], is_transposed=True),
+]
+
 # ---------------
 # test histogram
 # ---------------
 
 
+@triton.jit
+def max_combine(a, b):
+    return tl.maximum(a, b)
+
+
+@triton.jit
+def sub_combine(a, b):
+    return a - b
+
+
+def test_interpreter_combine_op_detection():
+    if not is_interpreter():
+        pytest.skip("native combine ops are specific to the interpreter")
+    from triton.runtime.interpreter import _get_native_combine_op
+    from triton._C.libtriton.interpreter import COMBINE_OP
+    assert _get_native_combine_op(add_combine) == COMBINE_OP.ADD
+    assert _get_native_combine_op(max_combine) == COMBINE_OP.MAX
+    # Combinators that are not a plain commutative op of their arguments run in Python
+    assert _get_native_combine_op(sub_combine) is None
+    assert _get_native_combine_op(get_first_element) is None
+    assert _get_native_combine_op(linear_recurrence) is None
+
+
 @pytest.mark.interpreter
-@pytest.mark.parametrize("M, N", [[2048, 2], [1024, 8], [1024, 128], [256, 512], [32, 512], [8, 512], [8, 2]])
+@pytest.mark.parametrize("op", ['add_combine', 'max_combine', 'get_first_element'])
+@pytest.mark.parametrize("scan", [False, True])
+@pytest.mark.parametrize("reverse", [False, True])
+@pytest.mark.parametrize("dtype_str", ['int32', 'bfloat16'])
+def test_interpreter_native_combine(op, scan, reverse, dtype_str, device, monkeypatch):
+    if not is_interpreter():
+        pytest.skip("native combine ops are specific to the interpreter")
+    if not scan and reverse:
+        pytest.skip("reductions have no direction")
+    from triton.runtime import interpreter
+
+    # Record which reductions and scans run on the native engine
+    native_calls = []
+
+    def record(name, native):
+
+        def wrapper(self, *args):
+            native_calls.append(name)
+            return native(self, *args)
+
+        return wrapper
+
+    monkeypatch.setattr(interpreter.ReduceOps, "native_reduce", record("reduce", interpreter.ReduceOps.native_reduce))
+    monkeypatch.setattr(interpreter.ScanOps, "native_scan", record("scan", interpreter.ScanOps.native_scan))
+
+    @triton.jit
+    def kernel(X, Z, M: tl.constexpr, N: tl.constexpr, SCAN: tl.constexpr, REVERSE: tl.constexpr):
+        off_m = tl.arange(0, M)
+        off_n = tl.arange(0, N)
+        x = tl.load(X + off_m[:, None] * N + off_n[None, :])
+        if SCAN:
+            z = tl.associative_scan(x, 1, GENERATE_TEST_HERE, reverse=REVERSE)
+            tl.store(Z + off_m[:, None] * N + off_n[None, :], z)
+        else:
+            z = tl.reduce(x, 1, GENERATE_TEST_HERE)
+            tl.store(Z + off_m, z)
+
+    kernel = patch_kernel(kernel, {'GENERATE_TEST_HERE': op})
+    M, N = 4, 16
+    rs = RandomState(17)
+    if dtype_str == 'bfloat16':
+        # Small integers keep every partial sum exact in bf16
+        x = rs.randint(-8, 8, (M, N)).astype(np.float32)
+    else:
+        x = rs.randint(-100, 100, (M, N), dtype=np.int32)
+    x_in = np.flip(x, 1) if reverse else x
+    if op == 'add_combine':
+        z_ref = np.cumsum(x_in, axis=1, dtype=x.dtype) if scan else np.sum(x, axis=1, dtype=x.dtype)
+    elif op == 'max_combine':
+        z_ref = np.maximum.accumulate(x_in, axis=1) if scan else np.max(x, axis=1)
+    else:
+        # The first element along the direction of the scan is propagated
+        z_ref = np.repeat(x_in[:, :1], N, axis=1) if scan else x[:, 0]
+    if reverse:
+        z_ref = np.flip(z_ref, 1)
+    x_tri = to_triton(x, device=device, dst_type=dtype_str)
+    z_tri = to_triton(np.empty_like(z_ref), device=device, dst_type=dtype_str)
+    kernel[(1, )](x_tri, z_tri, M, N, scan, reverse)
+    np.testing.assert_equal(z_ref, to_numpy(z_tri))
+    # bf16 is stored as its bit pattern, so it is combined in Python
+    native = op != 'get_first_element' and dtype_str != 'bfloat16'
+    assert native_calls == ([("scan" if scan else "reduce")] if native else [])
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("M, N", [[2048, 2], [1024, 8], [1024, 128], [256, 512], [32, 512], [8, 512], [8, 2],
+                                  [2048, 1024], [4096, 4096], [8, 2048]])
 def test_histogram(M, N, device):
 
     @triton.jit
@@ -2442,6 +2673,30 @@ def test_histogram(M, N, device):
     assert (z_torch == z).all()
 
 
+@pytest.mark.interpreter
+@pytest.mark.parametrize("N", [8, 32, 128, 512, 2048])
+def test_histogram_out_of_range(N, device):
+
+    @triton.jit
+    def histogram_kernel(x_ptr, z_ptr, M: tl.constexpr, N: tl.constexpr):
+        offset1 = tl.arange(0, M)
+        offset2 = tl.arange(0, N)
+        x = tl.load(x_ptr + offset1)
+        z = tl.histogram(x, N)
+        tl.store(z_ptr + offset2, z)
+
+    # Small histograms are computed with warp ballots and large ones with shared memory atomics, both of which
+    # ignore the values out of the bins.
+    M = 1024
+    torch.manual_seed(17)
+    x = torch.randint(-N, 2 * N, (M, ), device=device, dtype=torch.int32)
+    z = torch.empty(N, dtype=torch.int32, device=device)
+    in_range = x[(x >= 0) & (x < N)]
+    z_ref = torch.bincount(in_range.long(), minlength=N).to(torch.int32)
+    histogram_kernel[(1, )](x, z, M=M, N=N)
+    assert (z_ref == z).all()
+
+
 @pytest.mark.interpreter
 @pytest.mark.parametrize("op", ['sum', 'max', 'min'])
 @pytest.mark.parametrize("BLOCK_N", [32, 64, 128])
@@ -2496,14 +2751,38 @@ def test_optimize_thread_locality(op, BLOCK_N, N, num_pid_n, device):
 
 
 @pytest.mark.parametrize("M, N", [[32, 16], [32, 32], [32, 64], [64, 32]])
-@pytest.mark.parametrize("src_layout", scan_layouts)
+@pytest.mark.parametrize("src_layout", scan_layouts + filter_layouts(mma_scan_layouts))
 @pytest.mark.parametrize("axis", [0, 1])
-def test_scan_layouts(M, N, src_layout, axis, device):
+@pytest.mark.parametrize("reverse", [False, True])
+@pytest.mark.parametrize("op", ["cumsum", "linear_recurrence"])
+def test_scan_layouts(M, N, src_layout, axis, reverse, op, device):
+    if isinstance(src_layout, MfmaLayout) and (M < src_layout.instr_shape[0] or N < src_layout.instr_shape[1]):
+        pytest.skip("Skipping because tensor shape is smaller than M(f)maLayout instr_shape")
+
+    ty = f"tensor<{M}x{N}xi32, #blocked>"
+    if op == "cumsum":
+        scan = f"""
+      %11 = "tt.scan"(%10) <{{axis = {axis} : i32, reverse = {str(reverse).lower()}}}> ({{
+      ^bb0(%arg3: i32, %arg4: i32):
+        %16 = arith.addi %arg3, %arg4 : i32
+        tt.scan.return %16 : i32
+      }}) : ({ty}) -> {ty}"""
+    else:
+        # x_i = a_i * x_{i-1} + b_i is neither commutative nor single-operand
+        scan = f"""
+      %y = tt.load %y_ptrs : tensor<{M}x{N}x!tt.ptr<i32>, #blocked>
+      %a, %11 = "tt.scan"(%10, %y) <{{axis = {axis} : i32, reverse = {str(reverse).lower()}}}> ({{
+      ^bb0(%arg3: i32, %arg4: i32, %arg5: i32, %arg6: i32):
+        %16 = arith.muli %arg3, %arg5 : i32
+        %17 = arith.muli %arg4, %arg5 : i32
+        %18 = arith.addi %17, %arg6 : i32
+        tt.scan.return %16, %18 : i32, i32
+      }}) : ({ty}, {ty}) -> ({ty}, {ty})"""
 
     ir = f"""
     #blocked = {src_layout}
     module attributes {{"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.threads-per-warp" = {THREADS_PER_WARP} : i32}} {{
-    tt.func public @kernel_0d1d(%arg0: !tt.ptr<i32> {{tt.divisibility = 16 : i32}}, %arg1: !tt.ptr<i32> {{tt.divisibility = 16 : i32}}) {{
+    tt.func public @kernel_0d1d(%arg0: !tt.ptr<i32> {{tt.divisibility = 16 : i32}}, %arg1: !tt.ptr<i32> {{tt.divisibility = 16 : i32}}, %arg2: !tt.ptr<i32> {{tt.divisibility = 16 : i32}}) {{
       %cst = arith.constant dense<{N}> : tensor<{M}x1xi32, #blocked>
       %0 = tt.make_range {{end = {M} : i32, start = 0 : i32}} : tensor<{M}xi32, #triton_gpu.slice<{{dim = 1, parent = #blocked}}>>
       %1 = tt.expand_dims %0 {{axis = 1 : i32}} : tensor<{M}xi32, #triton_gpu.slice<{{dim = 1, parent = #blocked}}>> -> tensor<{M}x1xi32, #blocked>
@@ -2513,18 +2792,17 @@ def test_scan_layouts(M, N, src_layout, axis, device):
       %5 = tt.make_range {{end = {N} : i32, start = 0 : i32}} : tensor<{N}xi32, #triton_gpu.slice<{{dim = 0, parent = #blocked}}>>
       %6 = tt.expand_dims %5 {{axis = 0 : i32}} : tensor<{N}xi32, #triton_gpu.slice<{{dim = 0, parent = #blocked}}>> -> tensor<1x{N}xi32, #blocked>
       %7 = tt.broadcast %4 : tensor<{M}x1x!tt.ptr<i32>, #blocked> -> tensor<{M}x{N}x!tt.ptr<i32>, #blocked>
-      %8 = tt.broadcast %6 : tensor<1x{N}xi32, #blocked> -> tensor<{M}x{N}xi32, #blocked>
-      %9 = tt.addptr %7, %8 : tensor<{M}x{N}x!tt.ptr<i32>, #blocked>, tensor<{M}x{N}xi32, #blocked>
+      %8 = tt.broadcast %6 : tensor<1x{N}xi32, #blocked> -> {ty}
+      %9 = tt.addptr %7, %8 : tensor<{M}x{N}x!tt.ptr<i32>, #blocked>, {ty}
       %10 = tt.load %9 : tensor<{M}x{N}x!tt.ptr<i32>, #blocked>
-      %11 = "tt.scan"(%10) <{{axis = {axis} : i32, reverse = false}}> ({{
-      ^bb0(%arg2: i32, %arg3: i32):
-        %16 = arith.addi %arg2, %arg3 : i32
-        tt.scan.return %16 : i32
-      }}) : (tensor<{M}x{N}xi32, #blocked>) -> tensor<{M}x{N}xi32, #blocked>
-      %12 = tt.splat %arg1 : !tt.ptr<i32> -> tensor<{M}x1x!tt.ptr<i32>, #blocked>
+      %y_base = tt.splat %arg1 : !tt.ptr<i32> -> tensor<{M}x1x!tt.ptr<i32>, #blocked>
+      %y_rows = tt.addptr %y_base, %2 : tensor<{M}x1x!tt.ptr<i32>, #blocked>, tensor<{M}x1xi32, #blocked>
+      %y_rows_b = tt.broadcast %y_rows : tensor<{M}x1x!tt.ptr<i32>, #blocked> -> tensor<{M}x{N}x!tt.ptr<i32>, #blocked>
+      %y_ptrs = tt.addptr %y_rows_b, %8 : tensor<{M}x{N}x!tt.ptr<i32>, #blocked>, {ty}{scan}
+      %12 = tt.splat %arg2 : !tt.ptr<i32> -> tensor<{M}x1x!tt.ptr<i32>, #blocked>
       %13 = tt.addptr %12, %2 : tensor<{M}x1x!tt.ptr<i32>, #blocked>, tensor<{M}x1xi32, #blocked>
       %14 = tt.broadcast %13 : tensor<{M}x1x!tt.ptr<i32>, #blocked> -> tensor<{M}x{N}x!tt.ptr<i32>, #blocked>
-      %15 = tt.addptr %14, %8 : tensor<{M}x{N}x!tt.ptr<i32>, #blocked>, tensor<{M}x{N}xi32, #blocked>
+      %15 = tt.addptr %14, %8 : tensor<{M}x{N}x!tt.ptr<i32>, #blocked>, {ty}
       tt.store %15, %11 : tensor<{M}x{N}x!tt.ptr<i32>, #blocked>
       tt.return
     }}
@@ -2536,15 +2814,35 @@ def test_scan_layouts(M, N, src_layout, axis, device):
         f.flush()
         kernel = triton.compile(f.name)
     rs = RandomState(17)
-    x = rs.randint(-100, 100, (M, N)).astype('int32')
+    if op == "cumsum":
+        x = rs.randint(-100, 100, (M, N)).astype('int32')
+    else:
+        # Sample in -1, 0, 1 so that the recurrence does not overflow
+        x = rs.randint(-1, 2, (M, N)).astype('int32')
+    y = rs.randint(-1, 2, (M, N)).astype('int32')
 
     z = np.zeros((M, N)).astype('int32')
     x_tri = torch.tensor(x, device=device)
+    y_tri = torch.tensor(y, device=device)
     z_tri = torch.tensor(z, device=device)
 
-    kernel[(1, 1, 1)](x_tri, z_tri)
+    kernel[(1, 1, 1)](x_tri, y_tri, z_tri)
 
-    z_ref = np.cumsum(x, axis=axis)
+    x_ref = np.flip(x, axis) if reverse else x
+    y_ref = np.flip(y, axis) if reverse else y
+    if op == "cumsum":
+        z_ref = np.cumsum(x_ref, axis=axis)
+    else:
+        z_ref = np.empty_like(x_ref)
+        acc = np.zeros(N if axis == 0 else M, dtype='int32')
+        for i in range(x_ref.shape[axis]):
+            acc = np.take(x_ref, i, axis) * acc + np.take(y_ref, i, axis)
+            if axis == 0:
+                z_ref[i, :] = acc
+            else:
+                z_ref[:, i] = acc
+    if reverse:
+        z_ref = np.flip(z_ref, axis)
 
     np.testing.assert_equal(z_ref, z_tri.cpu().numpy())
 
@@ -5177,6 +5475,113 @@ def test_dot_max_num_imprecise_acc(M, N, K, BLOCK_M, BLOCK_N, BLOCK_K, in_type_s
         assert h.asm["ptx"].count("add.f32") == (BLOCK_M * BLOCK_N) // (32 * num_warps) * (BLOCK_K // low_precision_acc)
 
 
+def truncate_mantissa(x, mantissa_bits):
+    # Clear the low mantissa bits of fp32 values, like TF32 MMAs do with their operands
+    mask = np.uint32((0xffffffff << (23 - mantissa_bits)) & 0xffffffff)
+    return (x.astype(np.float32).view(np.uint32) & mask).view(np.float32)
+
+
+def round_to_tf32(x):
+    # cvt.rna.tf32.f32: round to nearest, ties away from zero
+    return ((x.astype(np.float32).view(np.uint32) + np.uint32(0x1000)) & np.uint32(0xffffe000)).view(np.float32)
+
+
+def dot_ref(a, b, input_precision):
+    if input_precision == "ieee":
+        return (a.astype(np.float64) @ b.astype(np.float64)).astype(np.float32)
+    if input_precision == "tf32":
+        return dot_ref(truncate_mantissa(a, 10), truncate_mantissa(b, 10), "ieee")
+    # tf32x3 splits the operands in a big and a small tf32 part and drops the product of the small parts
+    a_big, b_big = round_to_tf32(a), round_to_tf32(b)
+    a_small, b_small = truncate_mantissa(a - a_big, 10), truncate_mantissa(b - b_big, 10)
+    return dot_ref(a_small, b_big, "ieee") + dot_ref(a_big, b_small, "ieee") + dot_ref(a_big, b_big, "ieee")
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("input_precision", ["tf32", "tf32x3", "ieee"])
+def test_interpreter_dot_input_precision(input_precision, device):
+    if not is_interpreter():
+        pytest.skip("the emulation of the input precision is specific to the interpreter")
+
+    @triton.jit
+    def kernel(X, Y, Z, M: tl.constexpr, N: tl.constexpr, K: tl.constexpr, INPUT_PRECISION: tl.constexpr):
+        off_m = tl.arange(0, M)
+        off_n = tl.arange(0, N)
+        off_k = tl.arange(0, K)
+        x = tl.load(X + off_m[:, None] * K + off_k[None, :])
+        y = tl.load(Y + off_k[:, None] * N + off_n[None, :])
+        z = tl.dot(x, y, input_precision=INPUT_PRECISION)
+        tl.store(Z + off_m[:, None] * N + off_n[None, :], z)
+
+    M, N, K = 16, 16, 32
+    rs = RandomState(17)
+    # 1 + 2**-11 is not a tf32 value, and its square is exact in fp32. The alternating signs along k keep every
+    # partial sum exact, so each input precision gives a distinct and exactly known result.
+    signs = np.where(np.arange(K) % 2 == 0, 1.0, -1.0)
+    signs[-1] = 1.0
+    x = (np.exp2(rs.randint(-2, 3, (M, 1))) * (1 + 2**-11) * np.ones((M, K))).astype(np.float32)
+    y = (np.exp2(rs.randint(-2, 3, (1, N))) * (1 + 2**-11) * signs[:, None]).astype(np.float32)
+    z_ref = dot_ref(x, y, input_precision)
+    if input_precision != "ieee":
+        assert not np.array_equal(z_ref, dot_ref(x, y, "ieee"))
+    z = torch.empty((M, N), dtype=torch.float32, device=device)
+    kernel[(1, )](to_triton(x, device=device), to_triton(y, device=device), z, M, N, K, input_precision)
+    np.testing.assert_equal(z_ref, to_numpy(z))
+
+
+def imprecise_acc_dot_ref(a, b, instr_k, max_num_imprecise_acc):
+    if max_num_imprecise_acc == 0:
+        return dot_ref(a, b, "ieee")
+    # Each MMA instruction adds instr_k products to a partial accumulator that keeps 13 mantissa bits. The partial
+    # accumulator is added to the fp32 result every max_num_imprecise_acc products.
+    K = a.shape[1]
+    acc = np.zeros((a.shape[0], b.shape[1]), dtype=np.float32)
+    partial = np.zeros_like(acc)
+    num_imprecise_acc = 0
+    for k in range(0, K, instr_k):
+        partial = truncate_mantissa(partial + dot_ref(a[:, k:k + instr_k], b[k:k + instr_k], "ieee"), 13)
+        num_imprecise_acc += instr_k
+        if num_imprecise_acc >= max_num_imprecise_acc or k + instr_k == K:
+            acc += partial
+            partial[:] = 0
+            num_imprecise_acc = 0
+    return acc
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("max_num_imprecise_acc", [0, 32, 64])
+def test_interpreter_dot_imprecise_acc(max_num_imprecise_acc, device):
+    if not is_interpreter():
+        pytest.skip("the emulation of imprecise accumulation is specific to the interpreter")
+
+    @triton.jit
+    def kernel(X, Y, Z, M: tl.constexpr, N: tl.constexpr, K: tl.constexpr, MAX_NUM_IMPRECISE_ACC: tl.constexpr):
+        off_m = tl.arange(0, M)
+        off_n = tl.arange(0, N)
+        off_k = tl.arange(0, K)
+        x = tl.load(X + off_m[:, None] * K + off_k[None, :])
+        y = tl.load(Y + off_k[:, None] * N + off_n[None, :])
+        z = tl.dot(x, y, max_num_imprecise_acc=MAX_NUM_IMPRECISE_ACC)
+        tl.store(Z + off_m[:, None] * N + off_n[None, :], z)
+
+    M, N, K = 16, 16, 64
+    rs = RandomState(17)
+    # The first 32 products of each row sum to a value large enough that 13 mantissa bits cannot hold the sum of the
+    # next 32 products, so the result depends on how often the partial accumulator is flushed.
+    x = np.where(np.arange(K) < 32, 2.0**9, 2.0**-5) * np.ones((M, K))
+    y = np.exp2(rs.randint(0, 3, (1, N))) * np.ones((K, N))
+    z_ref = imprecise_acc_dot_ref(x, y, 32, max_num_imprecise_acc)
+    if max_num_imprecise_acc == K:
+        assert not np.array_equal(z_ref, dot_ref(x, y, "ieee"))
+    # float8e5 values are the upper byte of the corresponding fp16 values
+    to_fp8e5 = lambda v: (v.astype(np.float16).view(np.uint16) >> 8).astype(np.uint8).view(np.int8)
+    x_tri = to_triton(to_fp8e5(x), device=device, dst_type="float8e5")
+    y_tri = to_triton(to_fp8e5(y), device=device, dst_type="float8e5")
+    z = torch.empty((M, N), dtype=torch.float32, device=device)
+    kernel[(1, )](x_tri, y_tri, z, M, N, K, max_num_imprecise_acc)
+    np.testing.assert_equal(z_ref, to_numpy(z))
+
+
 # -----------------------
 # test enable_fp_fusion
 # -----------------------
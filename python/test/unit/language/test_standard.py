@@ -48,6 +48,70 @@ def test_sort(M, N, descending, dtype_str, device):
     assert (y == z).all(), (y, z)
 
 
+@pytest.mark.interpreter
+@pytest.mark.parametrize("M, N", [[8, 64], [256, 16]])
+@pytest.mark.parametrize("descending", [False, True])
+def test_sort_indices(M, N, descending, device):
+
+    @triton.jit
+    def sort_kernel(X, Z, I, N: tl.constexpr, M: tl.constexpr, descending: tl.constexpr):
+        offx = tl.arange(0, M)
+        offy = tl.arange(0, N) * M
+        off2d = offx[None, :] + offy[:, None]
+        x = tl.load(X + off2d)
+        z, i = tl.sort(x, dim=0, descending=descending, return_indices=True)
+        tl.store(Z + off2d, z)
+        tl.store(I + off2d, i)
+
+    # Few distinct values, so that equal elements have to be ordered by their indices
+    x = torch.randint(0, 4, (N, M), dtype=torch.int32, device=device)
+    y, j = torch.sort(x, dim=0, descending=descending, stable=True)
+    z = torch.empty_like(x)
+    i = torch.empty_like(x)
+    sort_kernel[(1, )](x, z, i, N, M, descending, num_warps=8)
+    assert (y == z).all(), (y, z)
+    assert (j == i).all(), (j, i)
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("M, N, K", [[8, 64, 4], [64, 16, 8], [256, 16, 16], [512, 8, 32]])
+@pytest.mark.parametrize("dtype_str", ['int32', 'float16', 'float32', 'bfloat16'])
+def test_topk(M, N, K, dtype_str, device):
+
+    @triton.jit
+    def topk_kernel(X, Z, I, N: tl.constexpr, M: tl.constexpr, K: tl.constexpr):
+        offx = tl.arange(0, M)
+        offy = tl.arange(0, N) * M
+        x = tl.load(X + offx[None, :] + offy[:, None])
+        z, i = tl.topk(x, K, return_indices=True)
+        offz = tl.arange(0, K)[None, :] + tl.arange(0, N)[:, None] * K
+        tl.store(Z + offz, z)
+        tl.store(I + offz, i)
+
+    x = numpy_random((N, M), dtype_str=dtype_str)
+    x = torch.from_numpy(x).to(device)
+    y = torch.topk(x, K)[0]
+    z = torch.empty((N, K), dtype=x.dtype, device=device)
+    i = torch.empty((N, K), dtype=torch.int32, device=device)
+    topk_kernel[(1, )](x, z, i, N, M, K, num_warps=8)
+    assert (y == z).all(), (y, z)
+    assert (torch.gather(x, 1, i.long()) == z).all()
+
+
+def test_topk_err(device):
+
+    @triton.jit
+    def kernel(X):
+        x = tl.load(X + tl.arange(0, 16))
+        z = tl.topk(x, 5)
+
+    x = torch.zeros((16, ), dtype=torch.float32, device=device)
+    with pytest.raises(triton.CompilationError) as exc_info:
+        kernel[(1, )](x)
+
+    assert "power of two" in str(exc_info.value.__cause__)
+
+
 # ---------------
 # test flip op
 # ---------------
@@ -16,7 +16,6 @@ from .standard import (
     ravel,
     sigmoid,
     softmax,
-    sort,
     sum,
     swizzle2d,
     xor_sum,
@@ -88,12 +87,14 @@ from .core import (
     range,
     reduce,
     reshape,
+    sort,
     split,
     static_assert,
     static_print,
     static_range,
     store,
     tensor,
+    topk,
     trans,
     uint16,
     uint32,
@@ -233,6 +234,7 @@ __all__ = [
     "sum",
     "swizzle2d",
     "tensor",
+    "topk",
     "trans",
     "triton",
     "uint16",
@@ -1091,7 +1091,7 @@ class tensor:
     def reduce(self, axis, combine_fn, keep_dims=False) -> tensor:
         ...
 
-    def associative_scan(self, axis, combine_fn, reverse=False) -> tensor:
+    def associative_scan(self, axis, combine_fn, reverse=False, workspace=None) -> tensor:
         ...
 
     def histogram(self, num_bins) -> tensor:
@@ -1133,7 +1133,10 @@ class tensor:
     def cumprod(self, axis=0, reverse=False) -> tensor:
         ...
 
-    def sort(self, dim: constexpr = None, descending: constexpr = CONSTEXPR_0) -> tensor:
+    def sort(self, dim: constexpr = None, descending: constexpr = CONSTEXPR_0, return_indices=False) -> tensor:
+        ...
+
+    def topk(self, k, dim=None, return_indices=False) -> tensor:
         ...
 
     def flip(self, dim=None) -> tensor:
@@ -2097,7 +2100,7 @@ def _add_scan_docstr(name: str) -> Callable[[T], T]:
 
 @_tensor_member_fn
 @builtin
-def associative_scan(input, axis, combine_fn, reverse=False, _builder=None, _generator=None):
+def associative_scan(input, axis, combine_fn, reverse=False, workspace=None, _builder=None, _generator=None):
     """Applies the combine_fn to each elements with a carry in :code:`input` tensors along the provided :code:`axis` and update the carry
 
     :param input: the input tensor, or tuple of tensors
@@ -2108,10 +2111,18 @@ def associative_scan(input, axis, combine_fn, reverse=False, _builder=None, _gen
     :type combine_fn: Callable
     :param reverse: whether to apply the associative scan in the reverse direction along axis
     :type reverse: bool
+    :param workspace: if set, scans the 1D :code:`input` of all programs along axis 0 of the grid as one tensor, concatenated in
+        the order of the program ids, in a single pass. Must be an argument of the kernel that points to at least
+        :code:`num_programs * (8 + 16 * len(input))` bytes that are zero before the launch. Each scan of a kernel needs
+        its own workspace. To let each program wait only on programs that started before it, :code:`tl.program_id(0)`
+        is renamed in the order the programs start, and all the scans of a kernel share this order. The renaming
+        applies to the kernel itself but not to the non-inlined functions it calls.
+    :type workspace: Block of pointers
 
     """
     if isinstance(input, tensor):
-        return associative_scan((input, ), axis, combine_fn, reverse, _builder=_builder, _generator=_generator)[0]
+        return associative_scan((input, ), axis, combine_fn, reverse, workspace, _builder=_builder,
+                                _generator=_generator)[0]
 
     def make_combine_region(scan_op):
         in_scalar_tys = [t.type.scalar for t in input]
@@ -2132,13 +2143,14 @@ def associative_scan(input, axis, combine_fn, reverse=False, _builder=None, _gen
     axis = _constexpr_to_value(axis)
     if axis is not None:
         axis = _wrap_axis(axis, len(input[0].shape))
-    return semantic.associative_scan(input, axis, make_combine_region, reverse, _builder)
+    return semantic.associative_scan(input, axis, make_combine_region, reverse, workspace, _builder)
 
 
 @_tensor_member_fn
 @builtin
 def histogram(input, num_bins, _builder=None, _generator=None):
     """computes an histogram based on input tensor with num_bins bins, the bins have a width of 1 and start at 0.
+    Values outside of [0, num_bins) are not counted.
 
     :param input: the input tensor
     :type input: Tensor
@@ -2150,6 +2162,91 @@ def histogram(input, num_bins, _builder=None, _generator=None):
     return semantic.histogram(input, num_bins, _builder)
 
 
+# -----------------------
+# Sorts
+# -----------------------
+
+
+def _sort_with_indices(input, dim, descending, k, return_indices, _builder=None):
+    dim = _constexpr_to_value(dim)
+    descending = _constexpr_to_value(descending)
+    return_indices = _constexpr_to_value(return_indices)
+    dim = len(input.shape) - 1 if dim is None else _wrap_axis(dim, len(input.shape))
+    inputs = (input, )
+    if return_indices:
+        n = input.shape[dim]
+        index = arange(0, n, _builder=_builder)
+        if len(input.shape) > 1:
+            # Broadcast index across the non-sorted axes
+            axes_to_expand = [constexpr(d) for d in builtins.range(len(input.shape))]
+            del axes_to_expand[dim]
+            index = expand_dims(index, axes_to_expand, _builder=_builder)
+            index = broadcast_to(index, input.shape, _builder=_builder)
+        inputs = (input, index)
+
+    def make_comparator_region(sort_op):
+        in_scalar_tys = [t.type.scalar for t in inputs]
+        region = sort_op.get_region(0)
+        with _insertion_guard(_builder):
+            param_types = [ty.to_ir(_builder) for ty in in_scalar_tys * 2]
+            block = _builder.create_block_with_parent(region, param_types)
+            args = [tensor(block.arg(i), ty) for i, ty in enumerate(in_scalar_tys * 2)]
+            lhs, rhs = args[0], args[len(inputs)]
+            if descending:
+                first = semantic.greater_than(lhs, rhs, _builder)
+            else:
+                first = semantic.less_than(lhs, rhs, _builder)
+            if return_indices:
+                # Equal elements are ordered by their indices
+                tie = semantic.and_(semantic.equal(lhs, rhs, _builder),
+                                    semantic.less_than(args[1], args[len(inputs) + 1], _builder), _builder)
+                first = semantic.or_(first, tie, _builder)
+            _builder.create_sort_ret(first.handle)
+
+    ret = semantic.sort(inputs, dim, k, make_comparator_region, _builder)
+    return ret if return_indices else ret[0]
+
+
+@_tensor_member_fn
+@builtin
+def sort(input, dim: constexpr = None, descending: constexpr = CONSTEXPR_0, return_indices=False, _builder=None,
+         _generator=None):
+    """
+    Sorts a tensor along a specified dimension.
+
+    :param input: The input tensor to be sorted.
+    :type input: Tensor
+    :param dim: The dimension along which to sort the tensor. If None, the tensor is sorted along the last dimension.
+    :type dim: int, optional
+    :param descending: If set to True, the tensor is sorted in descending order. If set to False, the tensor is sorted in ascending order.
+    :type descending: bool, optional
+    :param return_indices: If set to True, also return the indices along :code:`dim` of the sorted elements in
+        :code:`input`. Equal elements are then ordered by their indices.
+    :type return_indices: bool, optional
+    """
+    return _sort_with_indices(input, dim, descending, None, return_indices, _builder=_builder)
+
+
+@_tensor_member_fn
+@builtin
+def topk(input, k, dim=None, return_indices=False, _builder=None, _generator=None):
+    """
+    Returns the :code:`k` largest elements of a tensor along a specified dimension, in descending order.
+
+    :param input: The input tensor.
+    :type input: Tensor
+    :param k: The number of elements to return, a power of two that is at most the size of :code:`dim`.
+    :type k: int
+    :param dim: The dimension along which to select the elements. If None, the last dimension is used.
+    :type dim: int, optional
+    :param return_indices: If set to True, also return the indices along :code:`dim` of the selected elements in
+        :code:`input`. Equal elements are then ordered by their indices.
+    :type return_indices: bool, optional
+    """
+    k = _constexpr_to_value(k)
+    return _sort_with_indices(input, dim, True, k, return_indices, _builder=_builder)
+
+
 # -----------------------
 # Compiler Hint Ops
 # -----------------------
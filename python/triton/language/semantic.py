@@ -1466,7 +1466,7 @@ def reduction(inputs: Sequence[tl.tensor], axis: int, region_builder_fn, builder
 
 
 def associative_scan(inputs: Sequence[tl.tensor], axis: int, region_builder_fn, reverse: bool,
-                     builder: ir.builder) -> Tuple[tl.tensor, ...]:
+                     workspace: Optional[tl.tensor], builder: ir.builder) -> Tuple[tl.tensor, ...]:
     shape = inputs[0].type.shape
     rank = len(shape)
 
@@ -1478,13 +1478,48 @@ def associative_scan(inputs: Sequence[tl.tensor], axis: int, region_builder_fn,
     for t in inputs:
         assert t.type.shape == shape, "all scan inputs must have the same shape"
 
-    scan_op = builder.create_scan([t.handle for t in inputs], axis, reverse)
+    if workspace is not None:
+        assert rank == 1, "cross program scan only supports 1D inputs"
+        assert not reverse, "cross program scan does not support reverse"
+        assert workspace.type.is_ptr(), "workspace must be a pointer"
+        for t in inputs:
+            assert t.dtype.primitive_bitwidth <= 64, "cross program scan only supports elements of up to 64 bits"
+        scan_op = builder.create_cross_program_scan([t.handle for t in inputs], workspace.handle)
+    else:
+        scan_op = builder.create_scan([t.handle for t in inputs], axis, reverse)
     region_builder_fn(scan_op)
     scan_op.verify()
 
     return tuple(wrap_tensor(scan_op.get_result(i), inputs[i].type.scalar, shape) for i in range(len(inputs)))
 
 
+# ===----------------------------------------------------------------------===
+#                               Sort
+# ===----------------------------------------------------------------------===
+
+
+def sort(inputs: Sequence[tl.tensor], axis: int, k: Optional[int], region_builder_fn,
+         builder: ir.builder) -> Tuple[tl.tensor, ...]:
+    shape = inputs[0].type.shape
+    rank = len(shape)
+    assert 0 <= axis < rank, f"sort axis {axis} must be < inputs rank ({rank})"
+    for t in inputs:
+        assert t.type.shape == shape, "all sort inputs must have the same shape"
+    n = shape[axis]
+    assert n & (n - 1) == 0, f"sort axis size must be a power of two, got {n}"
+    ret_shape = list(shape)
+    if k is not None:
+        assert 1 <= k <= n, f"k must be between 1 and the sort axis size ({n}), got {k}"
+        assert k & (k - 1) == 0, f"k must be a power of two, got {k}"
+        ret_shape[axis] = k
+
+    sort_op = builder.create_sort([t.handle for t in inputs], axis, k)
+    region_builder_fn(sort_op)
+    sort_op.verify()
+
+    return tuple(wrap_tensor(sort_op.get_result(i), inputs[i].type.scalar, ret_shape) for i in range(len(inputs)))
+
+
 # ===----------------------------------------------------------------------===
 #                               Histogram
 # ===----------------------------------------------------------------------===
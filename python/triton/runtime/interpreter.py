@@ -1,6 +1,10 @@
 import ast
+import os
 import textwrap
 import inspect
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
 from typing import Tuple
 
 import math
@@ -10,23 +14,25 @@ import triton
 import triton.language as tl
 from dataclasses import dataclass
 from .errors import InterpreterError
-from functools import partial
+from functools import partial, wraps
 from .._C.libtriton import interpreter as _interpreter
 from .._C.libtriton import ir as _ir
 
 
 class TensorHandle:
 
-    def __init__(self, data, dtype):
+    def __init__(self, data, dtype, batched=False):
         '''
             data: numpy array
             dtype: triton type, either pointer_type or scalar_type.
             we don't store block_type here because the shape information is already availale in the data field
             attr: a dictionary of attributes
+            batched: whether data has a leading axis over all programs of the grid (see batched grid mode)
         '''
         self.data = data
         self.dtype = dtype
         self.attr = {}
+        self.batched = batched
 
     def __bool__(self):
         return bool(self.data.all())
@@ -38,7 +44,7 @@ class TensorHandle:
         return dtype
 
     def clone(self):
-        return TensorHandle(self.data.copy(), self.dtype)
+        return TensorHandle(self.data.copy(), self.dtype, self.batched)
 
     def set_attr(self, key, value):
         self.attr[key] = value
@@ -54,21 +60,40 @@ class BlockPointerHandle:
         self.tensor_shape = tensor_shape
         self.order = order
 
+    def is_batched(self):
+        return any(handle.batched for handle in [self.base, *self.shape, *self.strides, *self.offsets])
+
+    def scalar_fields(self):
+        # Base address, shape, strides and offsets of a non-batched block pointer as Python ints
+        def _ints(handles):
+            return [int(handle.data.item()) for handle in handles]
+
+        return int(self.base.data.item()), _ints(self.shape), _ints(self.strides), _ints(self.offsets)
+
     def materialize_pointers(self, boundary_check):
         dtype_tt = self.base.get_element_ty()
         n_bytes = dtype_tt.primitive_bitwidth // 8
         tensor_shape = self.tensor_shape
-        ptrs = np.broadcast_to(self.base.data, self.tensor_shape)
-        masks = np.ones(self.tensor_shape, dtype=bool)
-        for dim in range(len(tensor_shape)):
-            bcast_dims = [1] * len(tensor_shape)
+        ndim = len(tensor_shape)
+
+        # Scalars are stored as (1, ) arrays, or (num_programs, 1) arrays in batched grid mode.
+        # Reshape them so that they broadcast against the tensor shape.
+        def _scalar(handle):
+            return handle.data.reshape((-1, ) + (1, ) * ndim) if handle.batched else handle.data.reshape((1, ) * ndim)
+
+        ptrs = _scalar(self.base)
+        masks = np.ones((1, ) * ndim, dtype=bool)
+        for dim in range(ndim):
+            bcast_dims = [1] * ndim
             bcast_dims[dim] = tensor_shape[dim]
-            off = (self.offsets[dim].data + np.arange(tensor_shape[dim])).reshape(bcast_dims)
-            ptrs = ptrs + (n_bytes * off * self.strides[dim].data).astype(np.uint64)
+            off = _scalar(self.offsets[dim]) + np.arange(tensor_shape[dim]).reshape(bcast_dims)
+            ptrs = ptrs + (n_bytes * off * _scalar(self.strides[dim])).astype(np.uint64)
             if dim in boundary_check:
-                masks = np.logical_and(masks, off < self.shape[dim].data)
-        ptrs = TensorHandle(ptrs, self.base.dtype.scalar)
-        return ptrs, masks
+                masks = np.logical_and(masks, (off >= 0) & (off < _scalar(self.shape[dim])))
+        batched = self.is_batched()
+        shape = ((ptrs.shape[0], ) if batched else ()) + tuple(tensor_shape)
+        ptrs = TensorHandle(np.broadcast_to(ptrs, shape), self.base.dtype.scalar, batched)
+        return ptrs, np.broadcast_to(masks, shape)
 
 
 @dataclass(frozen=True)
@@ -127,68 +152,30 @@ def _get_np_dtype(tt_dtype):
     return np_types[tt_dtype]
 
 
+_float_formats = {
+    'fp8e4b15': _interpreter.FLOAT_FORMAT.FP8E4B15,
+    'fp8e4nv': _interpreter.FLOAT_FORMAT.FP8E4NV,
+    'fp8e4b8': _interpreter.FLOAT_FORMAT.FP8E4B8,
+    'fp8e5': _interpreter.FLOAT_FORMAT.FP8E5,
+    'fp8e5b16': _interpreter.FLOAT_FORMAT.FP8E5B16,
+    'fp16': _interpreter.FLOAT_FORMAT.FP16,
+    'bf16': _interpreter.FLOAT_FORMAT.BF16,
+    'fp32': _interpreter.FLOAT_FORMAT.FP32,
+    'fp64': _interpreter.FLOAT_FORMAT.FP64,
+}
+
+
 def _convert_float(input, input_dtype, output_dtype, rounding_mode):
-    input_uint_dtype = getattr(np, f"uint{input_dtype.primitive_bitwidth}")
-    output_unint_dtype = getattr(np, f"uint{output_dtype.primitive_bitwidth}")
-    input_bin = np.frombuffer(input.tobytes(), dtype=input_uint_dtype)
-    sign = (input_bin >> (input_dtype.primitive_bitwidth - 1)) & 0x01
-    input_exponent_width = input_dtype.primitive_bitwidth - input_dtype.fp_mantissa_width - 1
-    output_exponent_width = output_dtype.primitive_bitwidth - output_dtype.fp_mantissa_width - 1
-    significand = input_bin & ((1 << input_dtype.fp_mantissa_width) - 1)
-    bias_input = input_dtype.exponent_bias
-    bias_output = output_dtype.exponent_bias
-    exponent = ((input_bin >> input_dtype.fp_mantissa_width) & ((1 << input_exponent_width) - 1)).astype(np.int32)
-    subnormal_index = exponent == 0
-    if np.any(subnormal_index):
-        # Credit to Phil: phil@openai.com
-        # subnormal repr: ((-1.0)**sign) * (2.0**(1 - exp_bias)) * (2^(m0) + 2^(m1) + ... + 2^(mn))
-        # where m0, m1, ..., mn are the 1-bit of the mantissa
-        # convert it to normal repr: ((-1.0)**sign) * (2.0**(1 + m0 - exp_bias)) * (1 + 2^(m1 - m0) + ... + 2^(mn - m0))
-        bit_pos = np.zeros_like(input_bin, dtype=np.int32)
-        # Find the most significant bit of the mantissa in the significand
-        for i in range(input_dtype.fp_mantissa_width):
-            bit_index = ((significand >> i) & 0x01)
-            # pos should be >= 1
-            bit_pos[bit_index == 1] = input_dtype.fp_mantissa_width - i
-        zero_significand_index = significand == 0
-        exponent[subnormal_index] = 1 - bit_pos[subnormal_index]
-        # 0 significand and subnormal should be treated as 0
-        exponent[zero_significand_index & subnormal_index] = bias_input - bias_output
-        significand[subnormal_index] = (significand[subnormal_index] << bit_pos[subnormal_index]) & (
-            (1 << input_dtype.fp_mantissa_width) - 1)
-    # Prevent overflow and underflow
-    exponent_output = np.maximum(0, np.minimum((exponent - bias_input + bias_output), (1 << output_exponent_width) - 1))
-    exponent_output = exponent_output.astype(output_unint_dtype)
-    sign_output = sign.astype(output_unint_dtype)
-    if input_dtype.primitive_bitwidth > output_dtype.primitive_bitwidth:  # Downcast
-        significand_output = (significand >> (input_dtype.fp_mantissa_width - output_dtype.fp_mantissa_width)) & (
-            (1 << output_dtype.fp_mantissa_width) - 1)
-        if rounding_mode == _ir.ROUNDING_MODE.RTNE:  # Round to nearst even
-            # find the cut-off bit
-            cut_off = significand & (1 << (input_dtype.fp_mantissa_width - output_dtype.fp_mantissa_width - 1))
-            significand_output = significand_output + (cut_off > 0)
-        significand_output = significand_output.astype(output_unint_dtype)
-    else:  # Upcast
-        significand_output = (significand.astype(output_unint_dtype) <<
-                              (output_dtype.fp_mantissa_width - input_dtype.fp_mantissa_width)) & (
-                                  (1 << output_dtype.fp_mantissa_width) - 1)
-    subnormal_index = exponent_output == 0
-    if np.any(subnormal_index):  # underflow
-        # normal repr: ((-1.0)**sign) * (2.0**(exp - exp_bias_input)) * (1 + 2^(m0) + 2^(m1) + ... + 2^(mn))
-        # where m0, m1, ..., mn are the 1-bit of the mantissa
-        # shift = (1 - exp_bias_output) - (exp - exp_bias_input)
-        # convert it to subnormal repr: ((-1.0)**sign) * (2.0**(1 - exp_bias_output)) * (2^(-shift) + 2^(m0 - shift) + 2^(m1 - shift) + ... + 2^(mn - shift))
-        exponent = ((input_bin >> input_dtype.fp_mantissa_width) & ((1 << input_exponent_width) - 1)).astype(np.int32)
-        non_zero_exponent_index = exponent != 0
-        # If the original exponent is not zero, we still need to shift the significand and consider the 1.0 part in mantissa
-        subnormal_index = subnormal_index & non_zero_exponent_index
-        shift = np.zeros_like(input_bin, dtype=np.int32)
-        shift[subnormal_index] = (1 - bias_output) - (exponent[subnormal_index] - bias_input)
-        significand_output[subnormal_index] = (significand_output[subnormal_index] >> shift[subnormal_index]) | (
-            1 << (output_dtype.fp_mantissa_width - shift[subnormal_index]))
-    output = (sign_output << (output_dtype.primitive_bitwidth - 1)) | (
-        exponent_output << output_dtype.fp_mantissa_width) | significand_output
-    return output.reshape(input.shape)
+    # Returns the bits of the converted floats as unsigned integers.
+    # Upcasts are exact, so a missing rounding mode means round to nearest even.
+    rounding = _interpreter.ROUNDING_MODE.RTZ if rounding_mode == _ir.ROUNDING_MODE.RTZ else _interpreter.ROUNDING_MODE.RTNE
+    input_bin = np.ascontiguousarray(input).view(getattr(np, f"uint{input_dtype.primitive_bitwidth}"))
+    return _interpreter.convert_float(input_bin, _float_formats[input_dtype.name], _float_formats[output_dtype.name],
+                                      rounding)
+
+
+def _is_bits_float(dtype):
+    return dtype.is_bf16() or dtype.is_fp8()
 
 
 def _erf(x):
@@ -207,6 +194,45 @@ np_erf_fp64 = np.vectorize(_erf, otypes=[np.float64])
 np_umulhi_u64 = np.vectorize(_umulhi_64, otypes=[np.uint64])
 
 
+class _BatchedGridFallback(Exception):
+    '''
+        Raised when a kernel can't be interpreted for all programs of the grid at once,
+        e.g. because its control flow depends on the program id.
+    '''
+    pass
+
+
+def _uniform_value(data):
+    # A batched scalar can only drive Python control flow if all programs agree on its value
+    first = data.flat[0]
+    if not np.all(data == first):
+        raise _BatchedGridFallback("control flow diverges across programs")
+    return first
+
+
+def _broadcast_batched(*handles):
+    # Operands of batched memory operations may mix batched and non-batched handles
+    datas = [handle.data for handle in handles]
+    if not any(handle.batched for handle in handles):
+        return datas
+    return np.broadcast_arrays(*datas)
+
+
+def _propagate_batched(method):
+    # Every value computed from a batched operand is batched as well
+    @wraps(method)
+    def wrapper(self, *args, **kwargs):
+        ret = method(self, *args, **kwargs)
+        if self.batched_grid is not None and any(
+                isinstance(arg, TensorHandle) and arg.batched for arg in (*args, *kwargs.values())):
+            for handle in (ret if isinstance(ret, tuple) else (ret, )):
+                if isinstance(handle, TensorHandle):
+                    handle.batched = True
+        return ret
+
+    return wrapper
+
+
 class ExtraFunctions:
 
     @staticmethod
@@ -235,11 +261,32 @@ class InterpreterBuilder:
         _ir.ATOMIC_OP.XCHG: _interpreter.RMW_OP.XCHG,
     }
 
+    ir_input_precision_to_interpreter_input_precision = {
+        _ir.INPUT_PRECISION.TF32: _interpreter.INPUT_PRECISION.TF32,
+        _ir.INPUT_PRECISION.TF32x3: _interpreter.INPUT_PRECISION.TF32x3,
+        _ir.INPUT_PRECISION.IEEE: _interpreter.INPUT_PRECISION.IEEE,
+    }
+
     def __init__(self) -> None:
         self.arch = None
         self.options = InterpreterOptions()
         self.codegen_fns = {}
         self.codegen_fns["convert_custom_types"] = ExtraFunctions._convert_custom_types
+        # The program id is per-thread state so that multiple workers can
+        # interpret different programs of the same grid concurrently
+        self._local = threading.local()
+        # Program ids of all programs of the grid when interpreting the whole grid at once
+        self.batched_grid = None
+        # Set when a program of a grid interpreted in parallel fails, so that programs waiting on it stop
+        self.grid_failed = threading.Event()
+
+    @property
+    def grid_idx(self):
+        return getattr(self._local, "grid_idx", None)
+
+    @grid_idx.setter
+    def grid_idx(self, value):
+        self._local.grid_idx = value
 
     def set_grid_idx(self, x, y, z):
         if not x < self.grid_dim[0]:
@@ -253,6 +300,20 @@ class InterpreterBuilder:
     def set_grid_dim(self, nx, ny, nz):
         self.grid_dim = (nx, ny, nz)
 
+    def set_batched_grid(self, enable):
+        if not enable:
+            self.batched_grid = None
+            return
+        # Programs are ordered as in the sequential (x, y, z) loop, so that the effects
+        # of stores and atomics from later programs still win
+        nx, ny, nz = self.grid_dim
+        x, y, z = np.meshgrid(np.arange(nx, dtype=np.int32), np.arange(ny, dtype=np.int32),
+                              np.arange(nz, dtype=np.int32), indexing="ij")
+        self.batched_grid = tuple(idx.reshape(-1, 1) for idx in (x, y, z))
+
+    def _batched_shape(self, handle, shape):
+        return ((handle.data.shape[0], ) if handle.batched else ()) + tuple(shape)
+
     # constants
 
     def get_half_ty(self):
@@ -353,6 +414,8 @@ class InterpreterBuilder:
 
     # programming model
     def create_get_program_id(self, axis):
+        if self.batched_grid is not None:
+            return TensorHandle(self.batched_grid[axis], tl.int32, batched=True)
         if self.grid_idx is None:
             raise ValueError("grid_idx is None")
         return TensorHandle(np.array([self.grid_idx[axis]], dtype=np.int32), tl.int32)
@@ -375,22 +438,27 @@ class InterpreterBuilder:
         dtype_np = _get_np_dtype(dtype_tt)
         if other is None:
             other = TensorHandle(np.zeros_like(ptrs.data, dtype=dtype_np), dtype_tt)
-        ret = _interpreter.load(ptrs.data, mask.data, other.data, dtype_np)
+        ptrs_data, mask_data, other_data = _broadcast_batched(ptrs, mask, other)
+        ret = _interpreter.load(ptrs_data, mask_data, other_data, dtype_np)
         return TensorHandle(ret, dtype_tt)
 
     def create_masked_store(self, ptrs, value, mask, cache_modifier, eviction_policy):
-        return _interpreter.store(ptrs.data, value.data, mask.data)
+        ptrs_data, value_data, mask_data = _broadcast_batched(ptrs, value, mask)
+        return _interpreter.store(ptrs_data, value_data, mask_data)
 
     # casting ops
     def cast_impl(self, src, dst_type):
         src_element_type = src.dtype.scalar
         dst_element_type = dst_type.scalar
-        if (src_element_type == tl.bfloat16 and dst_element_type == tl.float32) or \
-           (src_element_type == tl.float32 and dst_element_type == tl.bfloat16):
-            data = _convert_float(src.data, src_element_type, dst_element_type, None).view(_get_np_dtype(dst_type))
-            return TensorHandle(data, dst_type.scalar)
-        else:
-            return TensorHandle(src.data.astype(_get_np_dtype(dst_type)), dst_type.scalar)
+        data = src.data
+        # NumPy has no bfloat16 and fp8 types, they are stored as bits and converted natively
+        if _is_bits_float(src_element_type) or _is_bits_float(dst_element_type):
+            if not src_element_type.is_floating():
+                data, src_element_type = data.astype(np.float64), tl.float64
+            float_type = dst_element_type if dst_element_type.is_floating() else tl.float64
+            data = _convert_float(data, src_element_type, float_type, _ir.ROUNDING_MODE.RTNE)
+            data = data.view(_get_np_dtype(float_type))
+        return TensorHandle(data.astype(_get_np_dtype(dst_type)), dst_type.scalar)
 
     create_si_to_fp = lambda self, src, dst_type: self.cast_impl(src, dst_type)
     create_ui_to_fp = lambda self, src, dst_type: self.cast_impl(src, dst_type)
@@ -473,11 +541,12 @@ class InterpreterBuilder:
 
     def create_ashr(self, lhs, rhs):
         # Triton's rshift operator depends on the signedness of the left operand
+        # Don't modify the operands in place, they may be shared with other programs
         lhs_dtype = _get_signed_np_dtype(lhs.data.dtype)
         rhs_dtype = _get_signed_np_dtype(rhs.data.dtype)
-        lhs.data = lhs.data.astype(lhs_dtype)
-        rhs.data = rhs.data.astype(rhs_dtype)
-        return self.binary_op(lhs, rhs, np.right_shift)
+        lhs_data = lhs.data.astype(lhs_dtype)
+        rhs_data = rhs.data.astype(rhs_dtype)
+        return TensorHandle(np.right_shift(lhs_data, rhs_data), lhs.dtype.scalar)
 
     def create_umulhi(self, lhs, rhs):
         dtype = lhs.data.dtype
@@ -534,25 +603,51 @@ class InterpreterBuilder:
         return TensorHandle(1 / np.sqrt(arg.data), arg.dtype.scalar)
 
     # tensor operators
-    create_reshape = lambda self, arg, shape, allow_reorder: TensorHandle(arg.data.reshape(shape), arg.dtype.scalar)
+    def create_reshape(self, arg, shape, allow_reorder):
+        return TensorHandle(arg.data.reshape(self._batched_shape(arg, shape)), arg.dtype.scalar)
 
     def create_trans(self, arg, perm):
+        if arg.batched:
+            perm = (0, ) + tuple(p + 1 for p in perm)
         return TensorHandle(np.transpose(arg.data, perm), arg.dtype.scalar)
 
     def create_dot(self, a, b, d, input_precision, max_num_imprecise_acc):
-        a_data = a.data
-        b_data = b.data
-        if (a.dtype.primitive_bitwidth == 8 and a.dtype.is_floating()) or \
-           (b.dtype.primitive_bitwidth == 8 and b.dtype.is_floating()):
-            a_data = _convert_float(a_data, a.dtype, tl.float16, None).view(np.float16)
-            b_data = _convert_float(b_data, b.dtype, tl.float16, None).view(np.float16)
-        return TensorHandle(np.matmul(a_data, b_data, dtype=d.data.dtype) + d.data, d.dtype.scalar)
+        if d.dtype.scalar.is_int():
+            return TensorHandle(np.matmul(a.data, b.data, dtype=d.data.dtype) + d.data, d.dtype.scalar)
+
+        def to_float32(x):
+            if _is_bits_float(x.dtype.scalar):
+                return _convert_float(x.data, x.dtype.scalar, tl.float32, None).view(np.float32)
+            return x.data.astype(np.float32)
+
+        a_data, b_data, c_data = to_float32(a), to_float32(b), d.data.astype(np.float32)
+        batch_shape = np.broadcast_shapes(a_data.shape[:-2], b_data.shape[:-2], c_data.shape[:-2])
+        a_data, b_data, c_data = (np.broadcast_to(x, batch_shape + x.shape[-2:]) for x in (a_data, b_data, c_data))
+        # Input precision only matters for fp32 inputs, and imprecise accumulation for fp8 inputs
+        is_fp32 = a.dtype.scalar.is_fp32() and b.dtype.scalar.is_fp32()
+        precision = self.ir_input_precision_to_interpreter_input_precision[
+            input_precision] if is_fp32 else _interpreter.INPUT_PRECISION.IEEE
+        if not (a.dtype.scalar.is_fp8() and b.dtype.scalar.is_fp8() and d.dtype.scalar.is_fp32()):
+            max_num_imprecise_acc = 0
+        acc_format = _interpreter.FLOAT_FORMAT.FP16 if d.dtype.scalar.is_fp16() else _interpreter.FLOAT_FORMAT.FP32
+        # MMA instructions handle 256 bits of k per row
+        instr_k = 256 // max(a.dtype.scalar.primitive_bitwidth, b.dtype.scalar.primitive_bitwidth)
+        ret = _interpreter.dot(a_data, b_data, c_data, precision, acc_format, instr_k, max_num_imprecise_acc)
+        return TensorHandle(ret.astype(d.data.dtype), d.dtype.scalar)
 
     def create_make_range(self, start, stop):
         return TensorHandle(np.arange(start, stop, dtype=np.int32), tl.int32)
 
     def create_histogram(self, data, bins):
-        return TensorHandle(np.histogram(data.data, bins=bins, range=(0, bins))[0], tl.int32)
+
+        def histogram(x):
+            # Values out of the bins are not counted
+            x = x.ravel().astype(np.int64)
+            return np.bincount(x[(x >= 0) & (x < bins)], minlength=bins).astype(np.int32)
+
+        if data.batched:
+            return TensorHandle(np.stack([histogram(row) for row in data.data]), tl.int32)
+        return TensorHandle(histogram(data.data), tl.int32)
 
     # pointer arithmetic
 
@@ -565,41 +660,61 @@ class InterpreterBuilder:
 
     def create_tensor_pointer_load(self, ptr, boundary_check, padding_option, cache_modifier, eviction_policy,
                                    is_volatile):
-        ptrs, masks = ptr.materialize_pointers(boundary_check)
-        dtype_tt = ptrs.get_element_ty()
+        dtype_tt = ptr.base.get_element_ty()
         dtype_np = _get_np_dtype(dtype_tt)
-        if padding_option is None:
-            other = None
-        elif padding_option == _ir.PADDING_OPTION.PAD_ZERO:
-            other = TensorHandle(np.zeros_like(ptrs.data, dtype=dtype_np), dtype_tt)
+        if padding_option is None or padding_option == _ir.PADDING_OPTION.PAD_ZERO:
+            other = np.zeros(1, dtype=dtype_np)
         elif padding_option == _ir.PADDING_OPTION.PAD_NAN:
-            other = TensorHandle(np.full_like(ptrs.data, float('nan'), dtype=dtype_np), dtype_tt)
+            other = np.full(1, float('nan'), dtype=np.float32)
+            if _is_bits_float(dtype_tt):
+                other = _convert_float(other, tl.float32, dtype_tt, None)
+            else:
+                other = other.astype(dtype_np)
         else:
             raise ValueError(f"unsupported padding option {padding_option}")
+        if not ptr.is_batched():
+            data = _interpreter.load_block(*ptr.scalar_fields(), ptr.tensor_shape, boundary_check, other, dtype_np)
+            return TensorHandle(data, dtype_tt)
+        ptrs, masks = ptr.materialize_pointers(boundary_check)
+        masks = TensorHandle(masks, tl.int1, ptrs.batched)
+        other = TensorHandle(np.broadcast_to(other, ptrs.data.shape), dtype_tt)
         return self.create_masked_load(ptrs, masks, other, cache_modifier, eviction_policy, is_volatile)
 
     def create_tensor_pointer_store(self, ptr, value, boundary_check, cache_modifier, eviction_policy):
+        if not ptr.is_batched() and not value.batched:
+            value_data = np.broadcast_to(value.data, ptr.tensor_shape)
+            return _interpreter.store_block(*ptr.scalar_fields(), boundary_check, value_data)
         ptrs, masks = ptr.materialize_pointers(boundary_check)
+        masks = TensorHandle(masks, tl.int1, ptrs.batched)
         return self.create_masked_store(ptrs, value, masks, cache_modifier, eviction_policy)
 
     def create_expand_dims(self, arg, axis):
+        if arg.batched and axis >= 0:
+            axis += 1
         return TensorHandle(np.expand_dims(arg.data, axis), arg.dtype.scalar)
 
     def create_broadcast(self, arg, shape):
-        return TensorHandle(np.broadcast_to(arg.data, shape), arg.dtype.scalar)
+        return TensorHandle(np.broadcast_to(arg.data, self._batched_shape(arg, shape)), arg.dtype.scalar)
 
     def create_cat(self, lhs, rhs):
-        return TensorHandle(np.concatenate([lhs.data, rhs.data]), lhs.dtype.scalar)
+        # Triton only supports concatenating 1D tensors
+        lhs_data, rhs_data = _broadcast_batched(lhs, rhs)
+        axis = 1 if lhs.batched or rhs.batched else 0
+        return TensorHandle(np.concatenate([lhs_data, rhs_data], axis=axis), lhs.dtype.scalar)
 
     def create_join(self, lhs, rhs):
         # Triton only supports joining two original tensors into a new one along the last axis
-        return TensorHandle(np.stack([lhs.data, rhs.data], axis=-1), lhs.dtype.scalar)
+        lhs_data, rhs_data = _broadcast_batched(lhs, rhs)
+        return TensorHandle(np.stack([lhs_data, rhs_data], axis=-1), lhs.dtype.scalar)
 
     def create_split(self, val):
         # Triton only supports splitting the original tensor into two along the last axis
         return (TensorHandle(val.data[..., 0], val.dtype.scalar), TensorHandle(val.data[..., 1], val.dtype.scalar))
 
     def create_splat(self, arg, shape):
+        if arg.batched:
+            data = arg.data.reshape((arg.data.shape[0], ) + (1, ) * len(shape))
+            return TensorHandle(np.broadcast_to(data, self._batched_shape(arg, shape)), arg.dtype.scalar)
         if isinstance(arg.dtype, tl.block_type):
             return TensorHandle(np.full(shape, arg.data[0], dtype=_get_np_dtype(arg.dtype)), arg.dtype.scalar)
         else:  # scalar
@@ -609,7 +724,8 @@ class InterpreterBuilder:
         if sem not in self.ir_sem_to_interpreter_sem:
             raise ValueError(f"unsupported semantic {sem}")
         sem = self.ir_sem_to_interpreter_sem[sem]
-        return TensorHandle(_interpreter.atomic_cas(ptr.data, cmp.data, val.data, sem), cmp.dtype.scalar)
+        ptr_data, cmp_data, val_data = _broadcast_batched(ptr, cmp, val)
+        return TensorHandle(_interpreter.atomic_cas(ptr_data, cmp_data, val_data, sem), cmp.dtype.scalar)
 
     def create_atomic_rmw(self, rmwOp, ptr, val, mask, sem, scope):
         if rmwOp not in self.ir_rmw_op_to_interpreter_rmw_op:
@@ -618,7 +734,8 @@ class InterpreterBuilder:
             raise ValueError(f"unsupported semantic {sem}")
         rmwOp = self.ir_rmw_op_to_interpreter_rmw_op[rmwOp]
         sem = self.ir_sem_to_interpreter_sem[sem]
-        return TensorHandle(_interpreter.atomic_rmw(rmwOp, ptr.data, val.data, mask.data, sem), val.dtype.scalar)
+        ptr_data, val_data, mask_data = _broadcast_batched(ptr, val, mask)
+        return TensorHandle(_interpreter.atomic_rmw(rmwOp, ptr_data, val_data, mask_data, sem), val.dtype.scalar)
 
     def create_extern_elementwise(self, libName, libPath, symbol, argList, retType, isPure):
         raise NotImplementedError("extern_elementwise not supported in interpreter mode")
@@ -627,6 +744,9 @@ class InterpreterBuilder:
         raise NotImplementedError("inline_asm not supported in interpreter mode")
 
     def create_print(self, prefix, hex, values):
+        if self.batched_grid is not None:
+            # Print in program order
+            raise _BatchedGridFallback("device_print")
         # Interpreter's device_print function has a different format than Triton's device_print
         msg = f"({self.grid_idx[0]}, {self.grid_idx[1]}, {self.grid_idx[2]})"
         if prefix:
@@ -655,11 +775,11 @@ class InterpreterBuilder:
         if len(ptr.offsets) != len(offsets):
             raise ValueError("len(ptr.offsets) != len(offsets)")
         # Create new offsets to avoid modifying the original
-        new_offsets = [offset.clone() for offset in ptr.offsets]
-        ret = BlockPointerHandle(ptr.base, ptr.shape, ptr.strides, new_offsets, ptr.tensor_shape, ptr.order)
-        for i in range(len(offsets)):
-            ret.offsets[i].data += offsets[i].data
-        return ret
+        new_offsets = [
+            TensorHandle(old.data + new.data, old.dtype, old.batched or new.batched)
+            for old, new in zip(ptr.offsets, offsets)
+        ]
+        return BlockPointerHandle(ptr.base, ptr.shape, ptr.strides, new_offsets, ptr.tensor_shape, ptr.order)
 
     def get_all_ones_value(self, type):
         np_type = _get_np_dtype(type)
@@ -669,6 +789,11 @@ class InterpreterBuilder:
             raise TypeError(f"unsupported type {type}")
 
 
+for _name, _member in list(vars(InterpreterBuilder).items()):
+    if _name.startswith("create_") and callable(_member):
+        setattr(InterpreterBuilder, _name, _propagate_batched(_member))
+
+
 def _patch_attr(obj, name, member, builder):
     new_member = lambda *args, member=member, **kwargs: (member(*args, **
                                                                 {k: v
@@ -687,25 +812,100 @@ def _patch_lang_tensor(tensor):
 
     def _get_bool(self):
         data = self.handle.data
+        if self.handle.batched and not self.type.is_block():
+            return bool(_uniform_value(data))
         # in triton, only scalars can be converted to booleans
         # here we need this hack because all scalars are tensors
         return bool(data) if data.size == 1 else True
 
+    def _get_index(self):
+        data = self.handle.data
+        return int(_uniform_value(data) if self.handle.batched else data.item())
+
     def _get_transpose(self):
-        return tl.core.tensor(TensorHandle(np.transpose(self.handle.data), self.handle.dtype), self.dtype.scalar)
+        handle = self.handle
+        # Keep the program axis of batched handles in front
+        axes = (0, ) + tuple(range(handle.data.ndim - 1, 0, -1)) if handle.batched else None
+        ret_type = tl.block_type(self.dtype.scalar, self.shape[::-1]) if self.type.is_block() else self.type
+        return tl.core.tensor(TensorHandle(np.transpose(handle.data, axes), handle.dtype, handle.batched), ret_type)
 
-    tensor.__index__ = lambda self: int(self.handle.data)
+    tensor.__index__ = lambda self: _get_index(self)
     tensor.__bool__ = lambda self: _get_bool(self)
     tensor.__repr__ = lambda self: repr(self.handle.data)
     tensor.__str__ = lambda self: str(self.handle.data)
     tensor.T = property(_get_transpose)
 
 
+_NATIVE_COMBINE_DTYPES = {
+    np.dtype(t)
+    for t in (np.int8, np.uint8, np.int16, np.uint16, np.int32, np.uint32, np.int64, np.uint64, np.float32, np.float64)
+}
+
+_native_combine_ops = {}
+
+
+def _match_combine_op(fn):
+    # Recognize user combinators of the form `return a <op> b` or `return tl.maximum(a, b)`
+    try:
+        tree = ast.parse(textwrap.dedent(inspect.getsource(fn)))
+    except (OSError, TypeError, SyntaxError):
+        return None
+    func = tree.body[0] if tree.body else None
+    if not isinstance(func, ast.FunctionDef) or len(func.args.args) != 2:
+        return None
+    body = [stmt for stmt in func.body if not (isinstance(stmt, ast.Expr) and isinstance(stmt.value, ast.Constant))]
+    if len(body) != 1 or not isinstance(body[0], ast.Return):
+        return None
+    params = {arg.arg for arg in func.args.args}
+
+    def is_params(lhs, rhs):
+        return isinstance(lhs, ast.Name) and isinstance(rhs, ast.Name) and {lhs.id, rhs.id} == params
+
+    expr = body[0].value
+    if isinstance(expr, ast.BinOp) and is_params(expr.left, expr.right):
+        return {
+            ast.Add: _interpreter.COMBINE_OP.ADD,
+            ast.Mult: _interpreter.COMBINE_OP.MUL,
+            ast.BitAnd: _interpreter.COMBINE_OP.AND,
+            ast.BitOr: _interpreter.COMBINE_OP.OR,
+            ast.BitXor: _interpreter.COMBINE_OP.XOR,
+        }.get(type(expr.op))
+    if isinstance(expr, ast.Call) and len(expr.args) == 2 and not expr.keywords and is_params(*expr.args):
+        name = expr.func.attr if isinstance(expr.func, ast.Attribute) else getattr(expr.func, "id", None)
+        return {"maximum": _interpreter.COMBINE_OP.MAX, "minimum": _interpreter.COMBINE_OP.MIN}.get(name)
+    return None
+
+
+def _get_native_combine_op(combine_fn):
+    # Returns the op the native reduce/scan engine runs in place of combine_fn, or None if combine_fn has to be
+    # called from Python. Argmax/argmin combinators map to the op applied to their values.
+    if combine_fn not in _native_combine_ops:
+        standard_ops = {
+            tl.standard._sum_combine: _interpreter.COMBINE_OP.ADD,
+            tl.standard._prod_combine: _interpreter.COMBINE_OP.MUL,
+            tl.standard._elementwise_max: _interpreter.COMBINE_OP.MAX,
+            tl.standard._elementwise_min: _interpreter.COMBINE_OP.MIN,
+            tl.standard._xor_combine: _interpreter.COMBINE_OP.XOR,
+            tl.standard._argmax_combine_tie_break_left: _interpreter.COMBINE_OP.MAX,
+            tl.standard._argmax_combine_tie_break_fast: _interpreter.COMBINE_OP.MAX,
+            tl.standard._argmin_combine_tie_break_left: _interpreter.COMBINE_OP.MIN,
+            tl.standard._argmin_combine_tie_break_fast: _interpreter.COMBINE_OP.MIN,
+        }
+        if combine_fn in standard_ops:
+            op = standard_ops[combine_fn]
+        else:
+            op = _match_combine_op(getattr(combine_fn, "fn", combine_fn))
+        _native_combine_ops[combine_fn] = op
+    return _native_combine_ops[combine_fn]
+
+
 class ReduceScanOpIneterface:
 
     def __init__(self, axis, combine_fn):
         self.axis = axis
         self.combine_fn = combine_fn
+        # In batched grid mode, data has a leading axis over programs
+        self.batched = False
 
     def check_axis(self, shape, axis):
         if axis is not None and axis >= len(shape):
@@ -718,6 +918,11 @@ class ReduceScanOpIneterface:
             self.check_axis(arg.shape, self.axis)
 
     def to_tensor(self, ret, dtype):
+        if self.batched:
+            if ret.shape[1:]:
+                return tl.core.tensor(TensorHandle(ret, dtype.scalar, True), tl.block_type(dtype, ret.shape[1:]))
+            ret = ret.reshape(-1, 1).astype(_get_np_dtype(dtype))
+            return tl.core.tensor(TensorHandle(ret, dtype.scalar, True), dtype)
         if hasattr(ret, "shape") and ret.shape:
             ret_type = tl.block_type(dtype, ret.shape)
         else:
@@ -725,12 +930,72 @@ class ReduceScanOpIneterface:
             ret_type = dtype
         return tl.core.tensor(TensorHandle(ret, dtype.scalar), ret_type)
 
+    def data_axis(self, ndim):
+        # The axis of the handle data that corresponds to self.axis
+        if not self.batched:
+            return self.axis
+        if self.axis is None:
+            return tuple(range(1, ndim + 1))
+        return self.axis + 1
+
     def apply(self, input):
         if not isinstance(input, tuple):
             input = (input, )
         self.check_tensor(input)
+        self.batched = any(arg.handle.batched for arg in input)
+        if self.batched:
+            num_programs = max(arg.handle.data.shape[0] for arg in input if arg.handle.batched)
+            input = tuple(self.to_batched(arg, num_programs) for arg in input)
         return self.apply_impl(input)
 
+    def to_batched(self, arg, num_programs):
+        handle = arg.handle
+        if not handle.batched:
+            handle = TensorHandle(np.broadcast_to(handle.data, (num_programs, ) + handle.data.shape), handle.dtype, True)
+        return tl.core.tensor(handle, arg.type)
+
+    def apply_per_program(self, fn, input):
+        # Apply fn to the inputs of each program separately and stack the results
+        num_programs = input[0].handle.data.shape[0]
+        self.batched = False
+        try:
+            rets = []
+            for i in range(num_programs):
+                ret = fn(tuple(tl.core.tensor(TensorHandle(arg.handle.data[i], arg.dtype.scalar), arg.type)
+                               for arg in input))
+                rets.append(ret if isinstance(ret, (tuple, list)) else (ret, ))
+        finally:
+            self.batched = True
+        ret = [
+            tl.core.tensor(TensorHandle(np.stack([r[j].handle.data for r in rets]), r0.handle.dtype, True), r0.type)
+            for j, r0 in enumerate(rets[0])
+        ]
+        return ret
+
+    def native_op(self, input):
+        # The native engine handles a single input, or a (value, index) pair for argmax/argmin
+        op = _get_native_combine_op(self.combine_fn)
+        if op is None or input[0].handle.data.dtype not in _NATIVE_COMBINE_DTYPES:
+            return None
+        # bf16 and fp8 are stored as their bit patterns, which can't be combined as integers
+        if _is_bits_float(input[0].dtype.scalar):
+            return None
+        if len(input) == 2 and input[1].handle.data.dtype != np.int32:
+            return None
+        if len(input) > 2 or (op in (_interpreter.COMBINE_OP.AND, _interpreter.COMBINE_OP.OR,
+                                     _interpreter.COMBINE_OP.XOR) and input[0].handle.data.dtype.kind == "f"):
+            return None
+        return op
+
+    def native_axis(self, data, ndim):
+        # The native engine works along a single axis, so the reduced axes of each program are flattened into one
+        axis = self.data_axis(ndim)
+        if axis is None:
+            return data.reshape(-1), 0
+        if isinstance(axis, tuple):
+            return data.reshape(data.shape[0], -1), 1
+        return data, axis
+
     def apply_impl(self, input):
         raise NotImplementedError("apply_impl not implemented")
 
@@ -752,6 +1017,9 @@ class ReduceOps(ReduceScanOpIneterface):
         return tuple(ret), axis
 
     def generic_reduce(self, input):
+        if self.batched:
+            ret = self.apply_per_program(self.generic_reduce, input)
+            return ret[0] if len(ret) == 1 else tuple(ret)
         original_axis = self.axis
         input, axis = self.unravel(input, self.axis)
         input_data = []
@@ -799,10 +1067,18 @@ class ReduceOps(ReduceScanOpIneterface):
         input = input[0] if isinstance(input, tuple) else input
         val = None
         idx = None
+        data = input.handle.data
+        axis = self.data_axis(len(input.shape))
         if val_reduce_op:
-            val = self.to_tensor(val_reduce_op(input.handle.data, axis=self.axis, keepdims=self.keep_dims), input.dtype)
+            val = self.to_tensor(val_reduce_op(data, axis=axis, keepdims=self.keep_dims), input.dtype)
         if idx_reduce_op:
-            idx = self.to_tensor(idx_reduce_op(input.handle.data, axis=self.axis, keepdims=self.keep_dims), tl.int32)
+            if isinstance(axis, tuple):
+                # Index reductions only take a single axis, flatten the data of each program instead
+                idx = idx_reduce_op(data.reshape(data.shape[0], -1), axis=1)
+                idx = idx.reshape((-1, ) + (1, ) * len(input.shape)) if self.keep_dims else idx
+            else:
+                idx = idx_reduce_op(data, axis=axis, keepdims=self.keep_dims)
+            idx = self.to_tensor(idx, tl.int32)
         if val is not None and idx is not None:
             return val, idx
         elif val is not None:
@@ -813,10 +1089,41 @@ class ReduceOps(ReduceScanOpIneterface):
             raise ValueError("val_reduce_op and idx_reduce_op are both None")
 
     def sum(self, input):
-        return self.to_tensor(np.sum(input.handle.data, axis=self.axis, keepdims=self.keep_dims), input.dtype)
+        axis = self.data_axis(len(input.shape))
+        return self.to_tensor(np.sum(input.handle.data, axis=axis, keepdims=self.keep_dims), input.dtype)
+
+    def keep_reduced_dims(self, ret, data_shape, ndim):
+        axis = self.data_axis(ndim)
+        if axis is None:
+            axis = tuple(range(len(data_shape)))
+        elif not isinstance(axis, tuple):
+            axis = (axis, )
+        return ret.reshape(tuple(1 if i in axis else dim for i, dim in enumerate(data_shape)))
+
+    def native_reduce(self, input, op):
+        data = input.handle.data
+        ret = _interpreter.reduce(op, *self.native_axis(data, len(input.shape)))
+        if self.keep_dims:
+            ret = self.keep_reduced_dims(ret, data.shape, len(input.shape))
+        return self.to_tensor(ret, input.dtype)
+
+    def native_arg_reduce(self, input, op):
+        values, indices = input
+        ndim = len(values.shape)
+        data = values.handle.data
+        value_data, axis = self.native_axis(data, ndim)
+        index_data, _ = self.native_axis(np.broadcast_to(indices.handle.data, data.shape), ndim)
+        val, idx = _interpreter.arg_reduce(op, value_data, index_data, axis)
+        if self.keep_dims:
+            val = self.keep_reduced_dims(val, data.shape, ndim)
+            idx = self.keep_reduced_dims(idx, data.shape, ndim)
+        return self.to_tensor(val, values.dtype), self.to_tensor(idx, indices.dtype)
 
     def apply_impl(self, input):
-        if self.combine_fn == tl.standard._argmin_combine_tie_break_left:
+        op = self.native_op(input)
+        if op is not None:
+            return self.native_reduce(input[0], op) if len(input) == 1 else self.native_arg_reduce(input, op)
+        elif self.combine_fn == tl.standard._argmin_combine_tie_break_left:
             return self.min_max(input[0], val_reduce_op=np.min, idx_reduce_op=np.argmin)
         elif self.combine_fn == tl.standard._argmax_combine_tie_break_left:
             return self.min_max(input[0], val_reduce_op=np.max, idx_reduce_op=np.argmax)
@@ -838,12 +1145,16 @@ class ScanOps(ReduceScanOpIneterface):
         self.reverse = reverse
 
     def cumsum(self, input):
-        return [self.to_tensor(np.cumsum(input.handle.data, axis=self.axis), dtype=input.dtype)]
+        axis = self.data_axis(len(input.shape))
+        return [self.to_tensor(np.cumsum(input.handle.data, axis=axis), dtype=input.dtype)]
 
     def cumprod(self, input):
-        return [self.to_tensor(np.cumprod(input.handle.data, axis=self.axis), dtype=input.dtype)]
+        axis = self.data_axis(len(input.shape))
+        return [self.to_tensor(np.cumprod(input.handle.data, axis=axis), dtype=input.dtype)]
 
     def generic_scan(self, input):
+        if self.batched:
+            return self.apply_per_program(self.generic_scan, input)
         input_data = []
         output_data = []
         shape = input[0].handle.data.shape
@@ -873,11 +1184,20 @@ class ScanOps(ReduceScanOpIneterface):
             ret.append(self.to_tensor(data, input[i].dtype))
         return ret
 
+    def native_scan(self, input, op):
+        axis = self.data_axis(len(input.shape))
+        return [self.to_tensor(_interpreter.scan(op, input.handle.data, axis, self.reverse), dtype=input.dtype)]
+
     def apply_impl(self, input):
+        op = self.native_op(input) if len(input) == 1 else None
+        if op is not None:
+            ret = self.native_scan(input[0], op)
+            return ret[0]
         new_input = []
         if self.reverse:
             for arg in input:
-                new_input.append(self.to_tensor(np.flip(arg.handle.data, axis=self.axis), arg.dtype))
+                axis = self.data_axis(len(arg.shape))
+                new_input.append(self.to_tensor(np.flip(arg.handle.data, axis=axis), arg.dtype))
         else:
             new_input = input
         if self.combine_fn == tl.standard._sum_combine:
@@ -889,10 +1209,118 @@ class ScanOps(ReduceScanOpIneterface):
             ret = self.generic_scan(new_input)
         if self.reverse:
             for arg in ret:
-                arg.handle.data = np.flip(arg.handle.data, axis=self.axis)
+                arg.handle.data = np.flip(arg.handle.data, axis=self.data_axis(len(arg.shape)))
         return len(ret) == 1 and ret[0] or tuple(ret)
 
 
+class CrossProgramScanOps(ScanOps):
+    # Scans the inputs of the programs along axis 0 of the grid as one tensor. As in the compiled decoupled look-back
+    # scan, each program publishes its aggregate and its inclusive prefix in its record of the workspace: a status
+    # flag padded to 8 bytes, then an 8-byte aggregate slot and an 8-byte prefix slot per input.
+    AGGREGATE_READY = 1
+    PREFIX_READY = 2
+
+    def __init__(self, combine_fn, workspace):
+        super().__init__(0, combine_fn, False)
+        self.workspace = workspace
+
+    def combine(self, lhs, rhs):
+        ret = self.combine_fn.fn(*lhs, *rhs)
+        return ret if isinstance(ret, tuple) else (ret, )
+
+    def publish(self, record, values, is_prefix, status):
+        for i, value in enumerate(values):
+            ptr = np.array([record + 8 + 16 * i + (8 if is_prefix else 0)], dtype=np.uint64)
+            _interpreter.store(ptr, value.handle.data, np.ones(1, dtype=bool))
+        _interpreter.atomic_rmw(_interpreter.RMW_OP.XCHG, np.array([record], dtype=np.uint64),
+                                np.array([status], dtype=np.int32), np.ones(1, dtype=bool),
+                                _interpreter.MEM_SEMANTIC.RELEASE)
+
+    def look_back(self, record, dtypes):
+        # Programs run concurrently in parallel mode, so the predecessors may still be running
+        while True:
+            status = _interpreter.atomic_rmw(_interpreter.RMW_OP.ADD, np.array([record], dtype=np.uint64),
+                                             np.zeros(1, dtype=np.int32), np.ones(1, dtype=bool),
+                                             _interpreter.MEM_SEMANTIC.ACQUIRE)[0]
+            if status != 0:
+                break
+            if interpreter_builder.grid_failed.is_set():
+                # The predecessor may never publish its record
+                raise RuntimeError("cross program scan aborted because another program failed")
+            time.sleep(0)
+        values = []
+        for i, dtype in enumerate(dtypes):
+            ptr = np.array([record + 8 + 16 * i + (8 if status == self.PREFIX_READY else 0)], dtype=np.uint64)
+            np_dtype = _get_np_dtype(dtype)
+            data = _interpreter.load(ptr, np.ones(1, dtype=bool), np.zeros(1, dtype=np_dtype), np_dtype)
+            values.append(self.to_tensor(data[0], dtype))
+        return tuple(values), status == self.PREFIX_READY
+
+    def apply_impl(self, input):
+        if self.batched:
+            # Programs wait on their predecessors, so they have to be interpreted one by one
+            raise _BatchedGridFallback("cross program scan")
+        if len(input[0].shape) != 1:
+            raise ValueError("cross program scan only supports 1D inputs")
+        local = super().apply_impl(input)
+        local = local if isinstance(local, tuple) else (local, )
+        aggregate = tuple(self.to_tensor(arg.handle.data[-1], arg.dtype) for arg in local)
+        x, y, z = interpreter_builder.grid_idx
+        nx, ny, _ = interpreter_builder.grid_dim
+        record_bytes = 8 + 16 * len(input)
+        record = int(self.workspace.handle.data[0]) + (x + nx * (y + ny * z)) * record_bytes
+        if x == 0:
+            self.publish(record, aggregate, True, self.PREFIX_READY)
+            return local[0] if len(local) == 1 else local
+        self.publish(record, aggregate, False, self.AGGREGATE_READY)
+        prefix = None
+        pred = record
+        while True:
+            pred -= record_bytes
+            values, done = self.look_back(pred, [arg.dtype for arg in input])
+            prefix = values if prefix is None else self.combine(values, prefix)
+            if done:
+                break
+        self.publish(record, self.combine(prefix, aggregate), True, self.PREFIX_READY)
+        # Splat the prefix so that the results are blocks even if the combine function returns its first arguments
+        prefix = tuple(
+            self.to_tensor(np.full(arg.handle.data.shape, p.handle.data.item(), dtype=arg.handle.data.dtype), arg.dtype)
+            for p, arg in zip(prefix, local))
+        ret = self.combine(prefix, local)
+        return ret[0] if len(ret) == 1 else ret
+
+
+class SortOps(ReduceScanOpIneterface):
+    # Sorts along axis with the order of the comparator that the compiled kernels use: equal elements keep their order
+    # when the indices are returned, and the descending order is the stable sort of the flipped axis, flipped back.
+
+    def __init__(self, axis, descending, k, return_indices):
+        super().__init__(axis, None)
+        self.descending = descending
+        self.k = k
+        self.return_indices = return_indices
+
+    def apply_impl(self, input):
+        input = input[0]
+        data = input.handle.data
+        axis = self.data_axis(len(input.shape))
+        keys = data
+        if _is_bits_float(input.dtype):
+            keys = _convert_float(data, input.dtype, tl.float32, _ir.ROUNDING_MODE.RTNE).view(np.float32)
+            keys = keys.reshape(data.shape)
+        if self.descending:
+            n = data.shape[axis]
+            order = n - 1 - np.flip(np.argsort(np.flip(keys, axis), axis=axis, kind="stable"), axis)
+        else:
+            order = np.argsort(keys, axis=axis, kind="stable")
+        if self.k is not None:
+            order = np.take(order, np.arange(self.k), axis=axis)
+        ret = self.to_tensor(np.take_along_axis(data, order, axis), input.dtype)
+        if self.return_indices:
+            return ret, self.to_tensor(order.astype(np.int32), tl.int32)
+        return ret
+
+
 def _patch_reduce_scan():
     # Because interpreter doesn't support region_builder_fn, we cannot patch the builder
     # to use the new reduce and scan functions.
@@ -900,7 +1328,9 @@ def _patch_reduce_scan():
     def _new_reduce(input, axis, combine_fn, keep_dims=False, **kwargs):
         return ReduceOps(axis, combine_fn, keep_dims).apply(input)
 
-    def _new_scan(input, axis, combine_fn, reverse=False, **kwargs):
+    def _new_scan(input, axis, combine_fn, reverse=False, workspace=None, **kwargs):
+        if workspace is not None:
+            return CrossProgramScanOps(combine_fn, workspace).apply(input)
         return ScanOps(axis, combine_fn, reverse).apply(input)
 
     tl.reduce = _new_reduce
@@ -909,6 +1339,30 @@ def _patch_reduce_scan():
     tl.core.associative_scan = _new_scan
 
 
+def _patch_sort(tensor):
+    # Sorts build a comparator region, so they are patched like reduce and scan, as well as their tensor members
+    def _sort(input, dim, descending, k, return_indices):
+        dim = tl.core._constexpr_to_value(dim)
+        ndim = len(input.shape)
+        dim = ndim - 1 if dim is None else tl.core._wrap_axis(dim, ndim)
+        k = tl.core._constexpr_to_value(k)
+        return SortOps(dim, bool(tl.core._constexpr_to_value(descending)), k,
+                       bool(tl.core._constexpr_to_value(return_indices))).apply(input)
+
+    def _new_sort(input, dim=None, descending=False, return_indices=False, **kwargs):
+        return _sort(input, dim, descending, None, return_indices)
+
+    def _new_topk(input, k, dim=None, return_indices=False, **kwargs):
+        return _sort(input, dim, True, k, return_indices)
+
+    tl.sort = _new_sort
+    tl.topk = _new_topk
+    tl.core.sort = _new_sort
+    tl.core.topk = _new_topk
+    tensor.sort = _new_sort
+    tensor.topk = _new_topk
+
+
 def _patch_lang_core(lang):
 
     def _new_to_ir(self, builder):
@@ -985,6 +1439,7 @@ def _patch_lang_core(lang):
     lang.max_constancy = partial(_set_attr, name="tt.constancy")
 
     _patch_reduce_scan()
+    _patch_sort(lang.tensor)
 
 
 def _patch_lang(fn):
@@ -1028,6 +1483,20 @@ interpreter_builder = InterpreterBuilder()
 RESERVED_KWS = ["num_warps", "num_stages", "num_ctas", "enable_fp_fusion", "grid", "maxnreg"]
 
 
+def _get_num_workers():
+    # Number of threads used to interpret the programs of a grid.
+    # 1 (the default) runs the grid sequentially in program id order.
+    num_workers = int(os.getenv("TRITON_INTERPRET_NUM_WORKERS", "1"))
+    if num_workers <= 0:
+        num_workers = os.cpu_count() or 1
+    return num_workers
+
+
+def _batch_grid_enabled():
+    # Interpret all programs of a grid at once, with the program id as a leading axis of every tensor.
+    return os.getenv("TRITON_INTERPRET_BATCH_GRID", "0") == "1"
+
+
 class GridExecutor:
 
     def __init__(self, fn, arg_names, grid):
@@ -1066,6 +1535,60 @@ class GridExecutor:
             if hasattr(kwarg_dev, "data_ptr"):
                 kwarg_dev.data.copy_(kwarg_hst.to(kwarg_dev.device).data)
 
+    def _run_programs(self, args, grid, start, end):
+        # Run programs [start, end) of the grid, linearized in (x, y, z) order
+        for pid in range(start, end):
+            x, yz = divmod(pid, grid[1] * grid[2])
+            y, z = divmod(yz, grid[2])
+            interpreter_builder.set_grid_idx(x, y, z)
+            self.fn(**args)
+
+    def _run_programs_parallel(self, args, grid, num_programs, num_workers):
+        # Shard the grid into chunks of consecutive programs. Chunks are smaller than
+        # num_programs / num_workers so that programs with uneven cost are balanced.
+        # Inter-program communication is only possible through atomics, which the
+        # native interpreter helpers perform with hardware atomics.
+        chunk_size = max(1, num_programs // (num_workers * 8))
+        interpreter_builder.grid_failed.clear()
+
+        def run_chunk(start, end):
+            try:
+                self._run_programs(args, grid, start, end)
+            except BaseException:
+                interpreter_builder.grid_failed.set()
+                raise
+
+        with ThreadPoolExecutor(max_workers=num_workers) as executor:
+            futures = [
+                executor.submit(run_chunk, start, min(start + chunk_size, num_programs))
+                for start in range(0, num_programs, chunk_size)
+            ]
+            try:
+                for future in futures:
+                    future.result()
+            except Exception:
+                for future in futures:
+                    future.cancel()
+                raise
+
+    def _run_batched(self, args, args_hst, kwargs_hst):
+        # Returns False if the kernel can't be interpreted in batched mode, e.g. because of control
+        # flow that depends on the program id. Side effects of the failed attempt are rolled back
+        # so that the grid can be interpreted again program by program. Any other error is a
+        # genuine error of the kernel and is propagated.
+        tensors = [arg for arg in (*args_hst, *kwargs_hst.values()) if hasattr(arg, "data_ptr")]
+        snapshots = [tensor.clone() for tensor in tensors]
+        interpreter_builder.set_batched_grid(True)
+        try:
+            self.fn(**args)
+            return True
+        except _BatchedGridFallback:
+            for tensor, snapshot in zip(tensors, snapshots):
+                tensor.copy_(snapshot)
+            return False
+        finally:
+            interpreter_builder.set_batched_grid(False)
+
     def __call__(self, *args_dev, **kwargs):
         # removes reserved keywords from kwargs
         kwargs = {k: v for k, v in kwargs.items() if k not in RESERVED_KWS}
@@ -1085,11 +1608,14 @@ class GridExecutor:
         grid = grid + (1, ) * (3 - len(grid))
         interpreter_builder.set_grid_dim(*grid)
         try:
-            for x in range(grid[0]):
-                for y in range(grid[1]):
-                    for z in range(grid[2]):
-                        interpreter_builder.set_grid_idx(x, y, z)
-                        self.fn(**args)
+            num_programs = grid[0] * grid[1] * grid[2]
+            num_workers = min(_get_num_workers(), num_programs)
+            if num_programs > 1 and _batch_grid_enabled() and self._run_batched(args, args_hst, kwargs_hst):
+                pass  # the whole grid has been interpreted at once
+            elif num_workers <= 1:
+                self._run_programs(args, grid, 0, num_programs)
+            else:
+                self._run_programs_parallel(args, grid, num_programs, num_workers)
         except Exception as e:
             raise InterpreterError(repr(e)) from e
         # copy arguments back to propagate side-effects
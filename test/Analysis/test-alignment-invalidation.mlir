@@ -0,0 +1,24 @@
+// RUN: triton-opt %s -test-print-alignment -canonicalize -test-print-alignment -o %t 2>&1 | FileCheck %s
+
+// The analysis printed first is reused by the pass manager until a pass changes
+// the IR. Canonicalization folds the multiplication into a new constant, which
+// only the recomputed analysis knows about.
+
+// CHECK: @fold
+// CHECK: tt.make_range {{.*}} => contiguity = [128], divisibility = [1073741824], constancy = [1], constant_value = <none>
+// CHECK-NEXT: arith.constant dense<4> : tensor<128xi32> => contiguity = [1], divisibility = [4], constancy = [128], constant_value = 4
+// CHECK-NEXT: arith.muli {{.*}} => contiguity = [1], divisibility = [16], constancy = [128], constant_value = 16
+// CHECK-NEXT: arith.addi {{.*}} => contiguity = [128], {{.*}}, constancy = [1], constant_value = <none>
+
+// CHECK: @fold
+// CHECK-NOT: arith.muli
+// CHECK: arith.constant dense<16> : tensor<128xi32> => contiguity = [1], divisibility = [16], constancy = [128], constant_value = 16
+// CHECK-NOT: arith.muli
+// CHECK: arith.addi {{.*}} => contiguity = [128], {{.*}}, constancy = [1], constant_value = <none>
+tt.func @fold() -> tensor<128xi32> {
+  %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %1 = arith.constant dense<4> : tensor<128xi32>
+  %2 = arith.muli %1, %1 : tensor<128xi32>
+  %3 = arith.addi %0, %2 : tensor<128xi32>
+  tt.return %3 : tensor<128xi32>
+}
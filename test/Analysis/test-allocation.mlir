@@ -192,13 +192,13 @@ tt.func @multi_color(%A : !tt.ptr<f16>) {
   // CHECK-NEXT: offset = 1664, size = 128
   %cst_1 = triton_gpu.local_alloc : () -> !tt.memdesc<16x4xf16, #A_SHARED, #triton_gpu.shared_memory>
   %cst_2 = arith.constant dense<0.000000e+00> : tensor<16x32xf16, #AL>
-  // CHECK-NEXT: scratch offset = 128, size = 1152
+  // CHECK-NEXT: scratch offset = 128, size = 1024
   %0 = triton_gpu.convert_layout %cst_2 : tensor<16x32xf16, #AL> -> tensor<16x32xf16, #BL>
   %1 = triton_gpu.local_load %cst : !tt.memdesc<4x8xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<4x8xf16, #AL>
   // CHECK-NEXT: offset = 0, size = 128
   %cst_3 = triton_gpu.local_alloc : () -> !tt.memdesc<4x16xf16, #A_SHARED, #triton_gpu.shared_memory>
   %2 = triton_gpu.local_load %cst_0 : !tt.memdesc<4x4xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<4x4xf16, #AL>
-  // CHECK-NEXT: scratch offset = 0, size = 1152
+  // CHECK-NEXT: scratch offset = 0, size = 1024
   %3 = triton_gpu.convert_layout %cst_2 : tensor<16x32xf16, #AL> -> tensor<16x32xf16, #BL>
   // CHECK-NEXT: offset = 0, size = 256
   %cst_4 = triton_gpu.local_alloc : () -> !tt.memdesc<4x32xf16, #A_SHARED, #triton_gpu.shared_memory>
@@ -219,7 +219,7 @@ tt.func @multi_color(%A : !tt.ptr<f16>) {
   %cst_10 = triton_gpu.local_alloc : () -> !tt.memdesc<1x16x16xf16, #A_SHARED, #triton_gpu.shared_memory>
   %7 = triton_gpu.local_load %cst_1 : !tt.memdesc<16x4xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<16x4xf16, #AL>
   %8 = triton_gpu.local_load %cst_4 : !tt.memdesc<4x32xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<4x32xf16, #AL>
-  // CHECK-NEXT: scratch offset = 0, size = 1152
+  // CHECK-NEXT: scratch offset = 0, size = 1024
   %9 = triton_gpu.convert_layout %cst_2 : tensor<16x32xf16, #AL> -> tensor<16x32xf16, #BL>
   %cst_11 = arith.constant dense<0.000000e+00> : tensor<4x4xf16, #AL>
   %10 = triton_gpu.local_load %cst_7 : !tt.memdesc<2x32xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<2x32xf16, #AL>
@@ -234,22 +234,22 @@ tt.func @multi_color(%A : !tt.ptr<f16>) {
 tt.func @multi_color_multi_rounds(%arg0: !tt.ptr<f16>) {
   // CHECK: offset = 0, size = 32
   %cst = triton_gpu.local_alloc : () -> !tt.memdesc<4x4xf16, #A_SHARED, #triton_gpu.shared_memory>
-  // CHECK-NEXT: offset = 1280, size = 128
+  // CHECK-NEXT: offset = 1152, size = 128
   %cst_0 = triton_gpu.local_alloc : () -> !tt.memdesc<16x4xf16, #A_SHARED, #triton_gpu.shared_memory>
   // CHECK-NEXT: offset = 2048, size = 8192
   %cst_1 = triton_gpu.local_alloc : () -> !tt.memdesc<1024x4xf16, #A_SHARED, #triton_gpu.shared_memory>
   %cst_2 = arith.constant dense<0.000000e+00> : tensor<16x32xf16, #AL>
-  // CHECK-NEXT: scratch offset = 128, size = 1152
+  // CHECK-NEXT: scratch offset = 128, size = 1024
   %0 = triton_gpu.convert_layout %cst_2 : tensor<16x32xf16, #AL> -> tensor<16x32xf16, #BL>
   %1 = triton_gpu.local_load %cst : !tt.memdesc<4x4xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<4x4xf16, #AL>
-  // CHECK-NEXT: offset = 1152, size = 128
+  // CHECK-NEXT: offset = 1024, size = 128
   %cst_3 = triton_gpu.local_alloc : () -> !tt.memdesc<2x32xf16, #A_SHARED, #triton_gpu.shared_memory>
   %2 = triton_gpu.local_load %cst : !tt.memdesc<4x4xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<4x4xf16, #AL>
   // CHECK-NEXT: offset = 0, size = 512
   %cst_4 = triton_gpu.local_alloc : () -> !tt.memdesc<1x16x16xf16, #A_SHARED, #triton_gpu.shared_memory>
   %3 = triton_gpu.local_load %cst_0 : !tt.memdesc<16x4xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<16x4xf16, #AL>
   %4 = triton_gpu.local_load %cst_1 : !tt.memdesc<1024x4xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<1024x4xf16, #AL>
-  // CHECK-NEXT: scratch offset = 0, size = 1152
+  // CHECK-NEXT: scratch offset = 0, size = 1024
   %5 = triton_gpu.convert_layout %cst_2 : tensor<16x32xf16, #AL> -> tensor<16x32xf16, #BL>
   %6 = triton_gpu.local_load %cst_3 : !tt.memdesc<2x32xf16, #A_SHARED, #triton_gpu.shared_memory> -> tensor<2x32xf16, #AL>
   // CHECK-NEXT: size = 10240
@@ -584,3 +584,26 @@ tt.func @call_graph_2(%A : !tt.ptr<f16>, %cond : i1) {
 }
 
 }
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.shared-allocator" = "best-fit"} {
+
+// Buffers larger than 256 bytes are 1024-byte aligned. The bumping allocator
+// places them in definition order and needs 3072 bytes, best-fit fills the
+// alignment gaps.
+// CHECK-LABEL: best_fit_alignment_gaps
+tt.func @best_fit_alignment_gaps(%A : !tt.ptr<f16>) {
+  // CHECK: offset = 1536, size = 256
+  %a = triton_gpu.local_alloc : () -> !tt.memdesc<8x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+  // CHECK-NEXT: offset = 1024, size = 512
+  %b = triton_gpu.local_alloc : () -> !tt.memdesc<16x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+  // CHECK-NEXT: offset = 0, size = 1024
+  %c = triton_gpu.local_alloc : () -> !tt.memdesc<32x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+  triton_gpu.local_dealloc %a : !tt.memdesc<8x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+  triton_gpu.local_dealloc %c : !tt.memdesc<32x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+  triton_gpu.local_dealloc %b : !tt.memdesc<16x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+  tt.return
+  // CHECK-NEXT: size = 1792
+  // CHECK-NEXT: live size lower bound = 1792
+}
+
+}
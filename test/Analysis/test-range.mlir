@@ -0,0 +1,76 @@
+// RUN: triton-opt %s -test-print-range -split-input-file -o %t 2>&1 | FileCheck %s
+
+// CHECK-LABEL: @program_id
+tt.func @program_id() {
+  // CHECK: range = [0, 2147483646], lower = <none>, upper = <none>
+  %pid = tt.get_program_id x : i32
+  // CHECK-NEXT: range = [128, 128], lower = <none>, upper = <none>
+  %c128 = arith.constant 128 : i32
+  // CHECK-NEXT: range = [-2147483648, 2147483647], lower = <none>, upper = <none>
+  %0 = arith.muli %pid, %c128 : i32
+  // CHECK-NEXT: range = [0, 127], lower = <none>, upper = <none>
+  %1 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  // CHECK-NEXT: range = [0, 2147483646], lower = %{{.*}}, upper = %{{.*}}
+  %2 = tt.splat %pid : i32 -> tensor<128xi32>
+  // CHECK-NEXT: range = [128, 128], lower = <none>, upper = <none>
+  %c128_tensor = arith.constant dense<128> : tensor<128xi32>
+  // CHECK-NEXT: range = [0, 127], lower = <none>, upper = <none>
+  %3 = arith.remsi %2, %c128_tensor : tensor<128xi32>
+  tt.return
+}
+
+// -----
+
+// CHECK-LABEL: @loop
+tt.func @loop(%K: i32 {tt.divisibility = 16 : i32}, %N: i32) {
+  %c0 = arith.constant 0 : i32
+  %c16 = arith.constant 16 : i32
+  %range = tt.make_range {end = 16 : i32, start = 0 : i32} : tensor<16xi32>
+  %Ks = tt.splat %K : i32 -> tensor<16xi32>
+  %Ns = tt.splat %N : i32 -> tensor<16xi32>
+  scf.for %k = %c0 to %K step %c16 : i32 {
+    // The bounds and the step are multiples of 16
+    // CHECK: range = [0, 2147483631], lower = %c0_i32, upper = %arg0 - 16
+    %ks = tt.splat %k : i32 -> tensor<16xi32>
+    // CHECK-NEXT: range = [0, 2147483646], lower = %c0_i32, upper = %arg0 - 1
+    %offs = arith.addi %ks, %range : tensor<16xi32>
+    // CHECK-NEXT: range = [1, 1], lower = <none>, upper = <none>
+    %mask = arith.cmpi slt, %offs, %Ks : tensor<16xi32>
+    // CHECK-NEXT: range = [0, 0], lower = <none>, upper = <none>
+    %not_mask = arith.cmpi sge, %offs, %Ks : tensor<16xi32>
+    // CHECK-NEXT: range = [0, 1], lower = <none>, upper = <none>
+    %mask_n = arith.cmpi slt, %offs, %Ns : tensor<16xi32>
+  }
+  scf.for %n = %c0 to %N step %c16 : i32 {
+    // CHECK: range = [0, 2147483646], lower = %c0_i32, upper = %arg1 - 1
+    %ns = tt.splat %n : i32 -> tensor<16xi32>
+    // The last iterations may overflow
+    // CHECK-NEXT: range = [-2147483648, 2147483647], lower = <none>, upper = <none>
+    %offs = arith.addi %ns, %range : tensor<16xi32>
+    // CHECK-NEXT: range = [0, 1], lower = <none>, upper = <none>
+    %mask = arith.cmpi slt, %offs, %Ns : tensor<16xi32>
+  }
+  tt.return
+}
+
+// -----
+
+// Loop carried values are widened to the range of their type
+// CHECK-LABEL: @iter_args
+tt.func @iter_args() {
+  %c0 = arith.constant 0 : i32
+  %c1 = arith.constant 1 : i32
+  %c16 = arith.constant 16 : i32
+  %res = scf.for %i = %c0 to %c16 step %c1 iter_args(%acc = %c0) -> (i32) : i32 {
+    // CHECK: range = [-2147483648, 2147483647], lower = <none>, upper = <none>
+    %next = arith.addi %acc, %c1 : i32
+    // CHECK-NEXT: range = [0, 1], lower = <none>, upper = <none>
+    %cmp = arith.cmpi slt, %next, %c16 : i32
+    // CHECK-NEXT: range = [1, 16], lower = %c0_i32 + 1, upper = %c16_i32
+    %iv_next = arith.addi %i, %c1 : i32
+    // CHECK-NEXT: range = [1, 1], lower = <none>, upper = <none>
+    %in_bounds = arith.cmpi sle, %iv_next, %c16 : i32
+    scf.yield %next : i32
+  }
+  tt.return
+}
@@ -0,0 +1,19 @@
+// RUN: triton-opt %s --allocate-shared-memory | FileCheck %s --check-prefix=MODULE
+// RUN: triton-opt %s --allocate-shared-memory=allocator=bumping | FileCheck %s --check-prefix=BUMPING
+
+// Without an explicit allocator, the policy selected by the module is used and
+// kept. An explicit allocator overrides it.
+#A_SHARED = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+// MODULE: triton_gpu.shared = 1792 : i32, "triton_gpu.shared-allocator" = "best-fit"
+// BUMPING: triton_gpu.shared = 3072 : i32, "triton_gpu.shared-allocator" = "bumping"
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.shared-allocator" = "best-fit"} {
+  tt.func @alignment_gaps() {
+    %a = triton_gpu.local_alloc : () -> !tt.memdesc<8x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+    %b = triton_gpu.local_alloc : () -> !tt.memdesc<16x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+    %c = triton_gpu.local_alloc : () -> !tt.memdesc<32x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+    triton_gpu.local_dealloc %a : !tt.memdesc<8x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+    triton_gpu.local_dealloc %c : !tt.memdesc<32x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+    triton_gpu.local_dealloc %b : !tt.memdesc<16x16xf16, #A_SHARED, #triton_gpu.shared_memory>
+    tt.return
+  }
+}
@@ -0,0 +1,38 @@
+// RUN: triton-opt %s -split-input-file --allocate-shared-memory | FileCheck %s
+
+// Padding the rows by 4 elements, as done regardless of the layouts before,
+// makes the second row of the stores of a half warp wrap around to the banks
+// of the first one. The rows are left unpadded instead.
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#BL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+// CHECK: triton_gpu.shared = 1024 : i32
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32} {
+  // CHECK-LABEL: unpadded
+  tt.func @unpadded(%arg0: tensor<16x32xf16, #AL>) {
+    // CHECK: triton_gpu.convert_layout
+    // CHECK-SAME: allocation.bank_conflicts = 1 : i32
+    // CHECK-SAME: allocation.cvt_padded_shape = array<i32: 16, 32>
+    %0 = triton_gpu.convert_layout %arg0 : tensor<16x32xf16, #AL> -> tensor<16x32xf16, #BL>
+    tt.return
+  }
+}
+
+// -----
+
+// The column-major stores are scalar, so any padding that is a multiple of the
+// 4-element loads leaves 4-way bank conflicts. Loading scalars too allows
+// padding the rows by a single element, which avoids all conflicts.
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [4, 1], threadsPerWarp = [8, 4], warpsPerCTA = [4, 1], order = [0, 1]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+// CHECK: triton_gpu.shared = 16640 : i32
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32} {
+  // CHECK-LABEL: transpose
+  tt.func @transpose(%arg0: tensor<64x64xf32, #blocked0>) {
+    // CHECK: triton_gpu.convert_layout
+    // CHECK-SAME: allocation.bank_conflicts = 1 : i32
+    // CHECK-SAME: allocation.cvt_padded_shape = array<i32: 64, 65>
+    // CHECK-SAME: allocation.cvt_vec = array<i32: 1, 1>
+    %0 = triton_gpu.convert_layout %arg0 : tensor<64x64xf32, #blocked0> -> tensor<64x64xf32, #blocked1>
+    tt.return
+  }
+}
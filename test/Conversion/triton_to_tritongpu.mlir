@@ -95,3 +95,19 @@ tt.func public @select_op(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg
   tt.return
 }
 }
+
+// -----
+
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+tt.func public @sort_topk(%arg0: tensor<256xf32>) -> tensor<8xf32> {
+  // CHECK-LABEL: sort_topk
+  // CHECK: "tt.sort"
+  // CHECK: (tensor<256xf32, #blocked>) -> tensor<8xf32, #blocked>
+  %0 = "tt.sort"(%arg0) ({
+  ^bb0(%arg1: f32, %arg2: f32):
+    %1 = arith.cmpf ogt, %arg1, %arg2 : f32
+    tt.sort.return %1 : i1
+  }) {axis = 0 : i32, k = 8 : i32} : (tensor<256xf32>) -> tensor<8xf32>
+  tt.return %0 : tensor<8xf32>
+}
+}
@@ -0,0 +1,100 @@
+// RUN: triton-opt %s -split-input-file -triton-fold-masks | FileCheck %s
+
+// The bounds and the step of the loop are multiples of 16, so the last element
+// of every iteration is in bounds.
+// CHECK-LABEL: @divisible_loop
+tt.func @divisible_loop(%ptr: !tt.ptr<f32>, %K: i32 {tt.divisibility = 16 : i32}) -> tensor<16xf32> {
+  %c0 = arith.constant 0 : i32
+  %c16 = arith.constant 16 : i32
+  %cst = arith.constant dense<0.000000e+00> : tensor<16xf32>
+  %range = tt.make_range {end = 16 : i32, start = 0 : i32} : tensor<16xi32>
+  %ptrs = tt.splat %ptr : !tt.ptr<f32> -> tensor<16x!tt.ptr<f32>>
+  %Ks = tt.splat %K : i32 -> tensor<16xi32>
+  // CHECK: scf.for
+  // CHECK-NOT: arith.cmpi
+  // CHECK: tt.load %{{[a-z0-9_]+}} : tensor<16x!tt.ptr<f32>>
+  // CHECK-NOT: scf.for
+  %res = scf.for %k = %c0 to %K step %c16 iter_args(%acc = %cst) -> (tensor<16xf32>) : i32 {
+    %ks = tt.splat %k : i32 -> tensor<16xi32>
+    %offs = arith.addi %ks, %range : tensor<16xi32>
+    %mask = arith.cmpi slt, %offs, %Ks : tensor<16xi32>
+    %p = tt.addptr %ptrs, %offs : tensor<16x!tt.ptr<f32>>, tensor<16xi32>
+    %x = tt.load %p, %mask, %cst : tensor<16x!tt.ptr<f32>>
+    %sum = arith.addf %acc, %x : tensor<16xf32>
+    scf.yield %sum : tensor<16xf32>
+  }
+  tt.return %res : tensor<16xf32>
+}
+
+// -----
+
+// CHECK-LABEL: @constant_bound
+tt.func @constant_bound(%ptr: !tt.ptr<f32>, %x: tensor<128xf32>) {
+  %range = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %c128 = arith.constant dense<128> : tensor<128xi32>
+  %mask = arith.cmpi slt, %range, %c128 : tensor<128xi32>
+  %ptrs = tt.splat %ptr : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+  %p = tt.addptr %ptrs, %range : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+  // CHECK-NOT: arith.cmpi
+  // CHECK: tt.store %{{[a-z0-9_]+}}, %{{[a-z0-9_]+}} : tensor<128x!tt.ptr<f32>>
+  tt.store %p, %x, %mask : tensor<128x!tt.ptr<f32>>
+  tt.return
+}
+
+// -----
+
+// The last iteration of the loop may be partial, it is peeled off and keeps
+// its mask.
+// CHECK-LABEL: @split_loop
+tt.func @split_loop(%ptr: !tt.ptr<f32>, %N: i32) -> tensor<16xf32> {
+  %c0 = arith.constant 0 : i32
+  %c16 = arith.constant 16 : i32
+  %cst = arith.constant dense<0.000000e+00> : tensor<16xf32>
+  %range = tt.make_range {end = 16 : i32, start = 0 : i32} : tensor<16xi32>
+  %ptrs = tt.splat %ptr : !tt.ptr<f32> -> tensor<16x!tt.ptr<f32>>
+  %Ns = tt.splat %N : i32 -> tensor<16xi32>
+  // CHECK: arith.remsi
+  // CHECK-NEXT: %[[SPLIT:.*]] = arith.subi
+  // CHECK: %[[MAIN:.*]] = scf.for %{{.*}} = %c0_i32 to %[[SPLIT]] step %c16_i32 iter_args
+  // CHECK-NOT: arith.cmpi
+  // CHECK: tt.load %{{[a-z0-9_]+}} : tensor<16x!tt.ptr<f32>>
+  // CHECK: scf.for %{{.*}} = %[[SPLIT]] to %arg1 step %c16_i32 iter_args(%{{.*}} = %[[MAIN]])
+  // CHECK: arith.cmpi slt
+  // CHECK: tt.load %{{.*}}, %{{.*}}, %{{.*}} : tensor<16x!tt.ptr<f32>>
+  // CHECK-NOT: tt.loop_tail
+  // CHECK: tt.return
+  %res = scf.for %n = %c0 to %N step %c16 iter_args(%acc = %cst) -> (tensor<16xf32>) : i32 {
+    %ns = tt.splat %n : i32 -> tensor<16xi32>
+    %offs = arith.addi %ns, %range : tensor<16xi32>
+    %mask = arith.cmpi slt, %offs, %Ns : tensor<16xi32>
+    %p = tt.addptr %ptrs, %offs : tensor<16x!tt.ptr<f32>>, tensor<16xi32>
+    %x = tt.load %p, %mask, %cst : tensor<16x!tt.ptr<f32>>
+    %sum = arith.addf %acc, %x : tensor<16xf32>
+    scf.yield %sum : tensor<16xf32>
+  }
+  tt.return %res : tensor<16xf32>
+}
+
+// -----
+
+// Offsets that may span more than one step are not split.
+// CHECK-LABEL: @wide_offsets
+tt.func @wide_offsets(%ptr: !tt.ptr<f32>, %N: i32) {
+  %c0 = arith.constant 0 : i32
+  %c16 = arith.constant 16 : i32
+  %cst = arith.constant dense<0.000000e+00> : tensor<32xf32>
+  %range = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+  %ptrs = tt.splat %ptr : !tt.ptr<f32> -> tensor<32x!tt.ptr<f32>>
+  %Ns = tt.splat %N : i32 -> tensor<32xi32>
+  // CHECK: scf.for
+  // CHECK: arith.cmpi slt
+  // CHECK-NOT: scf.for
+  scf.for %n = %c0 to %N step %c16 : i32 {
+    %ns = tt.splat %n : i32 -> tensor<32xi32>
+    %offs = arith.addi %ns, %range : tensor<32xi32>
+    %mask = arith.cmpi slt, %offs, %Ns : tensor<32xi32>
+    %p = tt.addptr %ptrs, %offs : tensor<32x!tt.ptr<f32>>, tensor<32xi32>
+    tt.store %p, %cst, %mask : tensor<32x!tt.ptr<f32>>
+  }
+  tt.return
+}
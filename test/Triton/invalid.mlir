@@ -114,6 +114,54 @@ tt.func public @fn(%v1: tensor<4x128xf32>, %v2: tensor<4x128xi64>) {
 
 // -----
 
+tt.func public @fn(%v: tensor<4x128xf32>, %ws: !tt.ptr<i8>) {
+    // expected-error @+1 {{only supports 1D tensors}}
+    %a = "tt.cross_program_scan" (%v, %ws) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %add = arith.addf %arg0, %arg1 : f32
+      tt.scan.return %add : f32
+    }) : (tensor<4x128xf32>, !tt.ptr<i8>) -> tensor<4x128xf32>
+    tt.return
+}
+
+// -----
+
+tt.func public @fn(%v: tensor<4x128xf32>) {
+    // expected-error @+1 {{k must be between 1 and the axis size 128}}
+    %a = "tt.sort" (%v) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %lt = arith.cmpf olt, %arg0, %arg1 : f32
+      tt.sort.return %lt : i1
+    }) {axis = 1 : i32, k = 256 : i32} : (tensor<4x128xf32>) -> tensor<4x256xf32>
+    tt.return
+}
+
+// -----
+
+tt.func public @fn(%v: tensor<4x128xf32>) {
+    // expected-error @+1 {{k must be a power of two but got 5}}
+    %a = "tt.sort" (%v) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %lt = arith.cmpf olt, %arg0, %arg1 : f32
+      tt.sort.return %lt : i1
+    }) {axis = 1 : i32, k = 5 : i32} : (tensor<4x128xf32>) -> tensor<4x5xf32>
+    tt.return
+}
+
+// -----
+
+tt.func public @fn(%v: tensor<4x128xf32>, %w: tensor<4x128xi32>) {
+    // expected-error @+1 {{nested block must take 4 arguments}}
+    %a, %b = "tt.sort" (%v, %w) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %lt = arith.cmpf olt, %arg0, %arg1 : f32
+      tt.sort.return %lt : i1
+    }) {axis = 1 : i32} : (tensor<4x128xf32>, tensor<4x128xi32>) -> (tensor<4x128xf32>, tensor<4x128xi32>)
+    tt.return
+}
+
+// -----
+
 tt.func public @fn(%v1: tensor<4x128xf32>, %v2: tensor<4x128xi64>) {
     // expected-error @+1 {{operand types and result types}}
     %a, %b = "tt.reduce" (%v1, %v2) ({
@@ -0,0 +1,31 @@
+// RUN: triton-opt %s -split-input-file -triton-lower-cross-program-scan -verify-diagnostics
+
+tt.func @shared_workspace(%x: tensor<256xi32>, %ws: !tt.ptr<i32>) -> tensor<256xi32> {
+  // expected-note @below {{the other scan}}
+  %0 = "tt.cross_program_scan"(%x, %ws) ({
+  ^bb0(%a: i32, %b: i32):
+    %sum = arith.addi %a, %b : i32
+    tt.scan.return %sum : i32
+  }) : (tensor<256xi32>, !tt.ptr<i32>) -> tensor<256xi32>
+  // expected-error @below {{shares its workspace with another scan}}
+  %1 = "tt.cross_program_scan"(%0, %ws) ({
+  ^bb0(%a: i32, %b: i32):
+    %max = arith.maxsi %a, %b : i32
+    tt.scan.return %max : i32
+  }) : (tensor<256xi32>, !tt.ptr<i32>) -> tensor<256xi32>
+  tt.return %1 : tensor<256xi32>
+}
+
+// -----
+
+tt.func @workspace_not_an_argument(%x: tensor<256xi32>, %ws: !tt.ptr<i32>) -> tensor<256xi32> {
+  %c1 = arith.constant 1 : i32
+  %ws1 = tt.addptr %ws, %c1 : !tt.ptr<i32>, i32
+  // expected-error @below {{requires the workspace to be an argument of the kernel}}
+  %0 = "tt.cross_program_scan"(%x, %ws1) ({
+  ^bb0(%a: i32, %b: i32):
+    %sum = arith.addi %a, %b : i32
+    tt.scan.return %sum : i32
+  }) : (tensor<256xi32>, !tt.ptr<i32>) -> tensor<256xi32>
+  tt.return %0 : tensor<256xi32>
+}
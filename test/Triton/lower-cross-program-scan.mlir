@@ -0,0 +1,69 @@
+// RUN: triton-opt %s -triton-lower-cross-program-scan | FileCheck %s
+
+// CHECK-LABEL: @cumsum
+tt.func @cumsum(%x: tensor<256xi32>, %ws: !tt.ptr<i32>) -> tensor<256xi32> {
+  // The tile id is taken from the counter of the chain at the entry.
+  // CHECK: tt.bitcast %{{.*}} : !tt.ptr<i32> -> !tt.ptr<i8>
+  // CHECK: %[[C4:.*]] = arith.constant 4 : i32
+  // CHECK: %[[COUNTER_I8:.*]] = tt.addptr %{{.*}}, %[[C4]]
+  // CHECK: %[[COUNTER:.*]] = tt.bitcast %[[COUNTER_I8]] : !tt.ptr<i8> -> !tt.ptr<i32>
+  // CHECK: %[[PID:.*]] = tt.atomic_rmw add, relaxed, gpu, %[[COUNTER]]
+  // The local scan and its last element, the aggregate.
+  // CHECK: %[[LOCAL:.*]] = "tt.scan"
+  // CHECK: {axis = 0 : i32, reverse = false}
+  // CHECK: %[[LAST:.*]]:2 = "tt.reduce"
+  // CHECK: arith.cmpi sgt
+  // CHECK: tt.reduce.return
+  // The record of the program is 8 + 16 bytes.
+  // CHECK: %[[WS:.*]] = tt.bitcast %{{.*}} : !tt.ptr<i32> -> !tt.ptr<i8>
+  // CHECK: %[[C24:.*]] = arith.constant 24 : i32
+  // CHECK: %[[OFFSET:.*]] = arith.muli %{{.*}}, %[[C24]]
+  // CHECK: %[[RECORD:.*]] = tt.addptr %[[WS]], %[[OFFSET]]
+  // CHECK: %[[FIRST:.*]] = arith.cmpi eq, %[[PID]]
+  // CHECK: tt.store %{{.*}}, %[[LAST]]#1 : !tt.ptr<i32>
+  // CHECK: tt.atomic_rmw exch, release, gpu
+  // CHECK: %[[PREFIX:.*]] = scf.if
+  // The look-back, which spins on the flag of each predecessor.
+  // CHECK: scf.while
+  // CHECK: scf.while
+  // CHECK: tt.atomic_rmw add, acquire, gpu
+  // CHECK: tt.load %{{.*}} {isVolatile = true} : !tt.ptr<i32>
+  // CHECK: arith.addi
+  // CHECK: scf.yield
+  // CHECK: arith.addi
+  // CHECK: tt.store
+  // CHECK: tt.atomic_rmw exch, release, gpu
+  // CHECK: } else {
+  // CHECK: %[[SPLAT:.*]] = tt.splat %[[PREFIX]] : i32 -> tensor<256xi32>
+  // CHECK: %[[JOIN:.*]] = tt.join %[[SPLAT]], %[[LOCAL]]
+  // CHECK: %[[PAIRS:.*]] = "tt.scan"(%[[JOIN]])
+  // CHECK: axis = 1 : i32
+  // CHECK: %{{.*}}, %[[RHS:.*]] = tt.split %[[PAIRS]]
+  // CHECK: %[[RES:.*]] = arith.select %[[FIRST]], %[[LOCAL]], %[[RHS]]
+  // CHECK: tt.return %[[RES]]
+  // CHECK-NOT: tt.cross_program_scan
+  %0 = "tt.cross_program_scan"(%x, %ws) ({
+  ^bb0(%a: i32, %b: i32):
+    %sum = arith.addi %a, %b : i32
+    tt.scan.return %sum : i32
+  }) : (tensor<256xi32>, !tt.ptr<i32>) -> tensor<256xi32>
+  tt.return %0 : tensor<256xi32>
+}
+
+// CHECK-LABEL: @tile_ids
+tt.func @tile_ids(%x: tensor<256xi32>, %ws: !tt.ptr<i32>, %out: !tt.ptr<i32>) -> tensor<256xi32> {
+  // The program id along axis 0 is replaced with the tile id.
+  // CHECK: %[[PID:.*]] = tt.atomic_rmw add, relaxed, gpu
+  // CHECK-NOT: tt.get_program_id x
+  // CHECK: %[[PTR:.*]] = tt.addptr %{{.*}}, %[[PID]] : !tt.ptr<i32>, i32
+  // CHECK: tt.store %[[PTR]], %[[PID]] : !tt.ptr<i32>
+  %pid = tt.get_program_id x : i32
+  %ptr = tt.addptr %out, %pid : !tt.ptr<i32>, i32
+  tt.store %ptr, %pid : !tt.ptr<i32>
+  %0 = "tt.cross_program_scan"(%x, %ws) ({
+  ^bb0(%a: i32, %b: i32):
+    %sum = arith.addi %a, %b : i32
+    tt.scan.return %sum : i32
+  }) : (tensor<256xi32>, !tt.ptr<i32>) -> tensor<256xi32>
+  tt.return %0 : tensor<256xi32>
+}
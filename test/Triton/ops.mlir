@@ -152,6 +152,32 @@ tt.func @reduce_ops_infer(%ptr: !tt.ptr<f32>, %v : tensor<1x2x4xf32>) {
   tt.return
 }
 
+// CHECK-LABEL: sort_ops_infer
+tt.func @sort_ops_infer(%v : tensor<2x8xf32>, %idx : tensor<2x8xi32>) -> (tensor<2x8xf32>, tensor<2x4xf32>, tensor<2x4xi32>) {
+  // CHECK: tt.sort
+  // CHECK-SAME: axis = 1
+  // CHECK: tt.sort.return
+  // CHECK-NEXT: (tensor<2x8xf32>) -> tensor<2x8xf32>
+  %a = "tt.sort" (%v) ({
+  ^bb0(%arg0: f32, %arg1: f32):
+    %lt = arith.cmpf olt, %arg0, %arg1 : f32
+    tt.sort.return %lt : i1
+  }) {axis = 1 : i32}  : (tensor<2x8xf32>) -> tensor<2x8xf32>
+
+  // The payload follows the keys and only the first k elements are returned.
+  // CHECK: tt.sort
+  // CHECK-SAME: axis = 1
+  // CHECK-SAME: k = 4
+  // CHECK: tt.sort.return
+  // CHECK-NEXT: (tensor<2x8xf32>, tensor<2x8xi32>) -> (tensor<2x4xf32>, tensor<2x4xi32>)
+  %b:2 = "tt.sort" (%v, %idx) ({
+  ^bb0(%arg0: f32, %arg1: i32, %arg2: f32, %arg3: i32):
+    %gt = arith.cmpf ogt, %arg0, %arg2 : f32
+    tt.sort.return %gt : i1
+  }) {axis = 1 : i32, k = 4 : i32}  : (tensor<2x8xf32>, tensor<2x8xi32>) -> (tensor<2x4xf32>, tensor<2x4xi32>)
+  tt.return %a, %b#0, %b#1 : tensor<2x8xf32>, tensor<2x4xf32>, tensor<2x4xi32>
+}
+
 // CHECK-LABEL: @dot_ops_infer
 tt.func @dot_ops_infer(%ptr: !tt.ptr<f32>, %v : f32) {
   // Test if reduce ops infer types correctly
@@ -79,6 +79,60 @@ tt.func @remat_fast_load(%arg: !tt.ptr<i32> {tt.divisibility = 16 : i32}) {
   tt.return
 }
 
+// The exponentials are also stored in their own layout, rematerializing them
+// in the layout of the convert would compute them twice, which costs more than
+// the convert.
+// CHECK-LABEL: dont_remat_expensive_ops
+tt.func @dont_remat_expensive_ops(%arg0: tensor<1024x!tt.ptr<f32>, #layout0>) -> tensor<1024xf32, #layout1> {
+  // CHECK-COUNT-6: math.exp
+  // CHECK-NOT: math.exp
+  // CHECK: triton_gpu.convert_layout
+  // CHECK-NOT: math.exp
+  // CHECK: tt.return
+  %0 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #layout0>
+  %1 = arith.sitofp %0 : tensor<1024xi32, #layout0> to tensor<1024xf32, #layout0>
+  %2 = math.exp %1 : tensor<1024xf32, #layout0>
+  %3 = math.exp %2 : tensor<1024xf32, #layout0>
+  %4 = math.exp %3 : tensor<1024xf32, #layout0>
+  %5 = math.exp %4 : tensor<1024xf32, #layout0>
+  %6 = math.exp %5 : tensor<1024xf32, #layout0>
+  %7 = math.exp %6 : tensor<1024xf32, #layout0>
+  tt.store %arg0, %7 : tensor<1024x!tt.ptr<f32>, #layout0>
+  %8 = triton_gpu.convert_layout %7 : tensor<1024xf32, #layout0> -> tensor<1024xf32, #layout1>
+  tt.return %8 : tensor<1024xf32, #layout1>
+}
+
+// The sum can take the layout of either operand.  Taking the one of %arg2
+// would convert both %arg1 and the stored sum, so the convert of %arg2 is
+// kept instead.
+// CHECK-LABEL: resolve_conflict_keeps_convert
+tt.func @resolve_conflict_keeps_convert(%arg0: tensor<1024x!tt.ptr<f32>, #layout0>, %arg1: tensor<1024xf32, #layout0>, %arg2: tensor<1024xf32, #layout1>) {
+  // CHECK-NOT: triton_gpu.convert_layout %arg1
+  // CHECK: %[[CVT:.+]] = triton_gpu.convert_layout %arg2
+  // CHECK: %[[SUM:.+]] = arith.addf %arg1, %[[CVT]]
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.store %arg0, %[[SUM]]
+  %0 = triton_gpu.convert_layout %arg2 : tensor<1024xf32, #layout1> -> tensor<1024xf32, #layout0>
+  %1 = arith.addf %arg1, %0 : tensor<1024xf32, #layout0>
+  tt.store %arg0, %1 : tensor<1024x!tt.ptr<f32>, #layout0>
+  tt.return
+}
+
+// Same as above, but the sum is stored in the layout of %arg2, so converting
+// %arg1 is the cheapest and both converts are replaced by it.
+// CHECK-LABEL: resolve_conflict_removes_converts
+tt.func @resolve_conflict_removes_converts(%arg0: tensor<1024x!tt.ptr<f32>, #layout1>, %arg1: tensor<1024xf32, #layout0>, %arg2: tensor<1024xf32, #layout1>) {
+  // CHECK: %[[CVT:.+]] = triton_gpu.convert_layout %arg1
+  // CHECK: %[[SUM:.+]] = arith.addf %[[CVT]], %arg2
+  // CHECK-NOT: triton_gpu.convert_layout
+  // CHECK: tt.store %arg0, %[[SUM]]
+  %0 = triton_gpu.convert_layout %arg2 : tensor<1024xf32, #layout1> -> tensor<1024xf32, #layout0>
+  %1 = arith.addf %arg1, %0 : tensor<1024xf32, #layout0>
+  %2 = triton_gpu.convert_layout %1 : tensor<1024xf32, #layout0> -> tensor<1024xf32, #layout1>
+  tt.store %arg0, %2 : tensor<1024x!tt.ptr<f32>, #layout1>
+  tt.return
+}
+
 // Hoist the convert on top of ext to make it cheaper.
 // CHECK-LABEL: hoist_above_ext
 tt.func @hoist_above_ext(%arg0: tensor<1024xf16, #layout0>, %arg1: f32) -> tensor<1024xf32, #layout1> {
@@ -2151,12 +2205,12 @@ tt.func @scan_propagation(%arg: tensor<1024xi32, #slice1dim1>) -> tensor<1024xi3
   ^bb0(%arg3: i32, %arg4: i32):
       %add = arith.addi %arg3, %arg4 : i32
       tt.scan.return %add : i32
-  }) {axis = 1 : i32, reverse = false} : (tensor<1024xi32, #blocked2>) -> tensor<1024xi32, #blocked2>
+  }) {axis = 0 : i32, reverse = false} : (tensor<1024xi32, #blocked2>) -> tensor<1024xi32, #blocked2>
   %3 = triton_gpu.convert_layout %2 : tensor<1024xi32, #blocked2> -> tensor<1024xi32, #slice1dim1>
-  // don't allow non blocked layout to be propagated to scan
-  // CHECK: triton_gpu.convert_layout
+  // the scan is lowered from the linear layout of the slice layout
+  // CHECK-NOT: triton_gpu.convert_layout
   // CHECK: tt.scan
-  // CHECK: triton_gpu.convert_layout
+  // CHECK-NOT: triton_gpu.convert_layout
   // CHECK: tt.return
   tt.return %3: tensor<1024xi32, #slice1dim1>
 }
@@ -1595,3 +1595,120 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     tt.return %0#0 : tensor<128x256xf32, #mma>
   }
 }
+
+// -----
+
+// A reduction over a long row streams its loads through shared memory even
+// though the loop has no dot.
+// CHECK-LABEL: @row_sum_kernel
+// CHECK:   %[[BUFFER:.*]] = triton_gpu.local_alloc  : () -> !tt.memdesc<2x1024xf32
+// CHECK-COUNT-2:   triton_gpu.async_copy_global_to_local
+// CHECK:   scf.for
+// CHECK:     triton_gpu.async_wait
+// CHECK:     triton_gpu.local_load
+// CHECK:     "tt.reduce"
+// CHECK:     triton_gpu.async_copy_global_to_local
+// CHECK:     scf.yield
+// CHECK:   triton_gpu.local_dealloc %[[BUFFER]]
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.target" = "cuda:80", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func public @row_sum_kernel(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg2: i32 {tt.divisibility = 16 : i32}) attributes {noinline = false} {
+    %c0_i32 = arith.constant 0 : i32
+    %c1024_i32 = arith.constant 1024 : i32
+    %cst = arith.constant 0.000000e+00 : f32
+    %0 = tt.get_program_id x : i32
+    %1 = arith.muli %0, %arg2 : i32
+    %2 = tt.addptr %arg0, %1 : !tt.ptr<f32>, i32
+    %3 = tt.splat %2 : !tt.ptr<f32> -> tensor<1024x!tt.ptr<f32>, #blocked>
+    %4 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #blocked>
+    %5 = scf.for %arg3 = %c0_i32 to %arg2 step %c1024_i32 iter_args(%arg4 = %cst) -> (f32)  : i32 {
+      %6 = tt.splat %arg3 : i32 -> tensor<1024xi32, #blocked>
+      %7 = arith.addi %6, %4 : tensor<1024xi32, #blocked>
+      %8 = tt.addptr %3, %7 : tensor<1024x!tt.ptr<f32>, #blocked>, tensor<1024xi32, #blocked>
+      %9 = tt.load %8 : tensor<1024x!tt.ptr<f32>, #blocked>
+      %10 = "tt.reduce"(%9) <{axis = 0 : i32}> ({
+      ^bb0(%arg5: f32, %arg6: f32):
+        %11 = arith.addf %arg5, %arg6 : f32
+        tt.reduce.return %11 : f32
+      }) : (tensor<1024xf32, #blocked>) -> f32
+      %12 = arith.addf %arg4, %10 : f32
+      scf.yield %12 : f32
+    }
+    %13 = tt.addptr %arg1, %0 : !tt.ptr<f32>, i32
+    tt.store %13, %5 : !tt.ptr<f32>
+    tt.return
+  }
+}
+
+// -----
+
+// A loop storing to global memory may update the memory that the loads of
+// later iterations read, here a recurrence over a row updated in place, so its
+// loads are not issued ahead.
+// CHECK-LABEL: @row_recurrence_kernel
+// CHECK-NOT:   triton_gpu.local_alloc
+// CHECK:   scf.for
+// CHECK-NOT:   triton_gpu.async_copy_global_to_local
+// CHECK:     tt.load
+// CHECK:     tt.store
+// CHECK:   tt.return
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.target" = "cuda:80", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func public @row_recurrence_kernel(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: i32 {tt.divisibility = 16 : i32}) attributes {noinline = false} {
+    %c1024_i32 = arith.constant 1024 : i32
+    %0 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<1024x!tt.ptr<f32>, #blocked>
+    %1 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #blocked>
+    scf.for %arg2 = %c1024_i32 to %arg1 step %c1024_i32  : i32 {
+      %2 = tt.splat %arg2 : i32 -> tensor<1024xi32, #blocked>
+      %3 = arith.addi %2, %1 : tensor<1024xi32, #blocked>
+      %4 = tt.addptr %0, %3 : tensor<1024x!tt.ptr<f32>, #blocked>, tensor<1024xi32, #blocked>
+      %5 = tt.load %4 : tensor<1024x!tt.ptr<f32>, #blocked>
+      // x[i:i + 1024] += x[i - 1024:i], which reads the stores of the previous iteration.
+      %6 = tt.splat %c1024_i32 : i32 -> tensor<1024xi32, #blocked>
+      %7 = arith.subi %3, %6 : tensor<1024xi32, #blocked>
+      %8 = tt.addptr %0, %7 : tensor<1024x!tt.ptr<f32>, #blocked>, tensor<1024xi32, #blocked>
+      %9 = tt.load %8 : tensor<1024x!tt.ptr<f32>, #blocked>
+      %10 = arith.addf %5, %9 : tensor<1024xf32, #blocked>
+      tt.store %4, %10 : tensor<1024x!tt.ptr<f32>, #blocked>
+    }
+    tt.return
+  }
+}
+
+// -----
+
+// Calls may write global memory, here through a noinline function storing the
+// row, so loops with calls are not pipelined either.
+// CHECK-LABEL: @row_recurrence_call_kernel
+// CHECK-NOT:   triton_gpu.local_alloc
+// CHECK:   scf.for
+// CHECK-NOT:   triton_gpu.async_copy_global_to_local
+// CHECK:     tt.load
+// CHECK:     tt.call @store_row
+// CHECK:   tt.return
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.target" = "cuda:80", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func private @store_row(%arg0: tensor<1024x!tt.ptr<f32>, #blocked>, %arg1: tensor<1024xf32, #blocked>) attributes {noinline = true} {
+    tt.store %arg0, %arg1 : tensor<1024x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+  tt.func public @row_recurrence_call_kernel(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: i32 {tt.divisibility = 16 : i32}) attributes {noinline = false} {
+    %c1024_i32 = arith.constant 1024 : i32
+    %0 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<1024x!tt.ptr<f32>, #blocked>
+    %1 = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32, #blocked>
+    scf.for %arg2 = %c1024_i32 to %arg1 step %c1024_i32  : i32 {
+      %2 = tt.splat %arg2 : i32 -> tensor<1024xi32, #blocked>
+      %3 = arith.addi %2, %1 : tensor<1024xi32, #blocked>
+      %4 = tt.addptr %0, %3 : tensor<1024x!tt.ptr<f32>, #blocked>, tensor<1024xi32, #blocked>
+      %5 = tt.load %4 : tensor<1024x!tt.ptr<f32>, #blocked>
+      // x[i:i + 1024] += x[i - 1024:i], which reads the stores of the previous iteration.
+      %6 = tt.splat %c1024_i32 : i32 -> tensor<1024xi32, #blocked>
+      %7 = arith.subi %3, %6 : tensor<1024xi32, #blocked>
+      %8 = tt.addptr %0, %7 : tensor<1024x!tt.ptr<f32>, #blocked>, tensor<1024xi32, #blocked>
+      %9 = tt.load %8 : tensor<1024x!tt.ptr<f32>, #blocked>
+      %10 = arith.addf %5, %9 : tensor<1024xf32, #blocked>
+      tt.call @store_row(%4, %10) : (tensor<1024x!tt.ptr<f32>, #blocked>, tensor<1024xf32, #blocked>) -> ()
+    }
+    tt.return
+  }
+}
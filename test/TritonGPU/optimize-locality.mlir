@@ -623,3 +623,44 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
     tt.return
   }
 }
+
+// -----
+
+// CHECK-LABEL: combine_reductions
+// CHECK: %[[SQUARE:.*]] = arith.mulf %arg0, %arg0
+// CHECK: %[[SUMS:.*]]:2 = "tt.reduce"(%arg0, %[[SQUARE]]) <{axis = 1 : i32}>
+// CHECK-NEXT: ^bb0(%[[ACC0:.*]]: f32, %[[ACC1:.*]]: f32, %[[CUR0:.*]]: f32, %[[CUR1:.*]]: f32):
+// CHECK-NEXT: %[[SUM0:.*]] = arith.addf %[[ACC0]], %[[CUR0]]
+// CHECK-NEXT: %[[SUM1:.*]] = arith.addf %[[ACC1]], %[[CUR1]]
+// CHECK-NEXT: tt.reduce.return %[[SUM0]], %[[SUM1]]
+// CHECK: tt.expand_dims %[[SUMS]]#0
+// CHECK: %[[MAX:.*]] = "tt.reduce"
+// CHECK: arith.maximumf
+// CHECK: tt.return %[[SUMS]]#1, %[[MAX]]
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [1, 4], order = [1, 0]}>
+#slice = #triton_gpu.slice<{dim = 1, parent = #blocked}>
+module attributes {"triton_gpu.target" = "cuda:80", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func public @combine_reductions(%arg0: tensor<4x512xf32, #blocked>) -> (tensor<4xf32, #slice>, tensor<4xf32, #slice>) {
+    %0 = "tt.reduce"(%arg0) <{axis = 1 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %8 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %8 : f32
+    }) : (tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice>
+    %1 = arith.mulf %arg0, %arg0 : tensor<4x512xf32, #blocked>
+    %2 = "tt.reduce"(%1) <{axis = 1 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %8 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %8 : f32
+    }) : (tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice>
+    // The last reduction depends on the first one and can't be merged.
+    %3 = tt.expand_dims %0 {axis = 1 : i32} : tensor<4xf32, #slice> -> tensor<4x1xf32, #blocked>
+    %4 = tt.broadcast %3 : tensor<4x1xf32, #blocked> -> tensor<4x512xf32, #blocked>
+    %5 = arith.subf %arg0, %4 : tensor<4x512xf32, #blocked>
+    %6 = "tt.reduce"(%5) <{axis = 1 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %8 = arith.maximumf %arg1, %arg2 : f32
+      tt.reduce.return %8 : f32
+    }) : (tensor<4x512xf32, #blocked>) -> tensor<4xf32, #slice>
+    tt.return %2, %6 : tensor<4xf32, #slice>, tensor<4xf32, #slice>
+  }
+}
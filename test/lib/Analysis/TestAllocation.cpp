@@ -46,6 +46,8 @@ struct TestAllocationPass
         }
       });
       os << "size = " << allocation->getSharedMemorySize() << "\n";
+      os << "live size lower bound = " << allocation->getLiveSizeLowerBound()
+         << "\n";
     });
   }
 };
@@ -20,7 +20,9 @@ struct TestAxisInfoPass
   void runOnOperation() override {
     Operation *operation = getOperation();
     ModuleOp moduleOp = cast<ModuleOp>(operation);
-    ModuleAxisInfoAnalysis moduleAxisInfoAnalysis(moduleOp);
+    ModuleAxisInfoAnalysis &moduleAxisInfoAnalysis =
+        ModuleAxisInfoAnalysis::get(getAnalysisManager());
+    markAllAnalysesPreserved();
     moduleOp.walk([&](FuncOp funcOp) {
       auto &os = llvm::errs();
       auto opName = SymbolTable::getSymbolName(funcOp).getValue().str();
@@ -0,0 +1,54 @@
+#include "mlir/Pass/Pass.h"
+#include "triton/Analysis/AxisInfo.h"
+#include "triton/Analysis/RangeInfo.h"
+
+using namespace mlir;
+using namespace mlir::triton;
+
+namespace {
+
+struct TestRangeInfoPass
+    : public PassWrapper<TestRangeInfoPass, OperationPass<ModuleOp>> {
+
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestRangeInfoPass);
+
+  StringRef getArgument() const final { return "test-print-range"; }
+  StringRef getDescription() const final {
+    return "print the result of the value range analysis pass";
+  }
+
+  void runOnOperation() override {
+    Operation *operation = getOperation();
+    ModuleOp moduleOp = cast<ModuleOp>(operation);
+    ModuleAxisInfoAnalysis &moduleAxisInfoAnalysis =
+        ModuleAxisInfoAnalysis::get(getAnalysisManager());
+    markAllAnalysesPreserved();
+    ModuleRangeInfoAnalysis moduleRangeInfoAnalysis(moduleOp,
+                                                    moduleAxisInfoAnalysis);
+    moduleOp.walk([&](FuncOp funcOp) {
+      auto &os = llvm::errs();
+      auto opName = SymbolTable::getSymbolName(funcOp).getValue().str();
+      os << "@" << opName << "\n";
+      funcOp.walk([&](Operation *op) {
+        if (op->getNumResults() < 1)
+          return;
+        for (Value result : op->getResults()) {
+          result.print(os);
+          os << " => ";
+          auto *rangeInfo = moduleRangeInfoAnalysis.getRangeInfo(result);
+          if (rangeInfo)
+            rangeInfo->print(os);
+          os << "\n";
+        }
+      });
+    });
+  }
+};
+
+} // namespace
+
+namespace mlir {
+namespace test {
+void registerTestRangeInfoPass() { PassRegistration<TestRangeInfoPass>(); }
+} // namespace test
+} // namespace mlir
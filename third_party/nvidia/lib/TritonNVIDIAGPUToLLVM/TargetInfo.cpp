@@ -213,24 +213,18 @@ LLVM::LLVMFuncOp getAssertfailDeclaration(RewriterBase &rewriter) {
 
 namespace mlir::triton::NVIDIA {
 
-// Check if the reduction can use a redux op and return the kind.
-static std::optional<NVVM::ReduxKind> matchReduxKind(triton::ReduceOp op,
-                                                     int computeCapability) {
-  if (computeCapability < 80)
-    return std::nullopt;
-  if (op.getNumOperands() != 1 || op.getNumResults() != 1)
-    return std::nullopt;
-  Block *block = &(*op.getCombineOp().begin());
-  Operation *yield = block->getTerminator();
-  Operation *reduceOp = yield->getOperand(0).getDefiningOp();
+// Check if the combination `result` of the accumulator `acc` and the value
+// `cur` can use a redux op and return the kind.
+static std::optional<NVVM::ReduxKind> matchReduxKind(Value result, Value acc,
+                                                     Value cur) {
+  Operation *reduceOp = result.getDefiningOp();
   if (!reduceOp || reduceOp->getNumOperands() != 2 ||
       reduceOp->getNumResults() != 1)
     return std::nullopt;
   auto intType = dyn_cast<IntegerType>(reduceOp->getResultTypes()[0]);
   if (!intType || intType.getWidth() > 32)
     return std::nullopt;
-  if (reduceOp->getOperand(0) != block->getArgument(0) ||
-      reduceOp->getOperand(1) != block->getArgument(1))
+  if (reduceOp->getOperand(0) != acc || reduceOp->getOperand(1) != cur)
     return std::nullopt;
   if (isa<arith::AddIOp>(reduceOp))
     return NVVM::ReduxKind::ADD;
@@ -251,6 +245,27 @@ static std::optional<NVVM::ReduxKind> matchReduxKind(triton::ReduceOp op,
   return std::nullopt;
 }
 
+// Check if each operand of the reduction can use a redux op of its own and
+// return their kinds. Reductions of several operands, e.g. merged independent
+// reductions, qualify when each operand is combined on its own.
+static std::optional<SmallVector<NVVM::ReduxKind>>
+matchReduxKinds(triton::ReduceOp op, int computeCapability) {
+  if (computeCapability < 80)
+    return std::nullopt;
+  unsigned numOperands = op.getNumOperands();
+  Block *block = &(*op.getCombineOp().begin());
+  Operation *yield = block->getTerminator();
+  SmallVector<NVVM::ReduxKind> kinds;
+  for (unsigned i = 0; i < numOperands; ++i) {
+    auto kind = matchReduxKind(yield->getOperand(i), block->getArgument(i),
+                               block->getArgument(numOperands + i));
+    if (!kind)
+      return std::nullopt;
+    kinds.push_back(*kind);
+  }
+  return kinds;
+}
+
 bool TargetInfo::supportMaximumMinimum() const {
   return computeCapability >= 80;
 }
@@ -454,12 +469,11 @@ bool TargetInfo::warpReduce(RewriterBase &rewriter, Location loc,
                             SmallVector<Value> &acc, triton::ReduceOp op,
                             unsigned numLaneToReduce,
                             unsigned interleave) const {
-  if (auto kind = matchReduxKind(op, computeCapability)) {
+  if (auto kinds = matchReduxKinds(op, computeCapability)) {
     // Based on benchmarking on A100 redux op gives a speed up only when doing
     // a single reduction (not partitioned) and when the mask is static.
     // Therefore we currently only enable it to reduce across all the lanes.
     if (numLaneToReduce == 32) {
-      assert(acc.size() == 1);
       Value mask = i32_val(0xFFFFFFFF);
       // Even though we currently don't use redux for partitioned reduction
       // the code below supports it in case we want to tweak the heuristic.
@@ -474,14 +488,15 @@ bool TargetInfo::warpReduce(RewriterBase &rewriter, Location loc,
       }
       for (unsigned i = 0; i < acc.size(); ++i) {
         unsigned bitwidth = cast<IntegerType>(acc[i].getType()).getWidth();
+        NVVM::ReduxKind kind = (*kinds)[i];
         if (bitwidth < 32) {
-          if (*kind == NVVM::ReduxKind::MIN || *kind == NVVM::ReduxKind::MAX)
+          if (kind == NVVM::ReduxKind::MIN || kind == NVVM::ReduxKind::MAX)
             acc[i] = sext(i32_ty, acc[i]);
           else
             acc[i] = zext(i32_ty, acc[i]);
         }
-        acc[i] = rewriter.create<NVVM::ReduxOp>(loc, acc[i].getType(), acc[0],
-                                                *kind, mask);
+        acc[i] = rewriter.create<NVVM::ReduxOp>(loc, acc[i].getType(), acc[i],
+                                                kind, mask);
         if (bitwidth < 32)
           acc[i] = trunc(int_ty(bitwidth), acc[i]);
       }
@@ -0,0 +1,68 @@
+#include "triton/Analysis/Membar.h"
+
+#include "llvm/Support/Signals.h"
+#include <gtest/gtest.h>
+#include <random>
+
+namespace mlir {
+namespace {
+
+using IntervalSetT = BlockInfo::IntervalSetT;
+
+bool intersectsSlow(const IntervalSetT &lhs, const IntervalSetT &rhs) {
+  for (auto &l : lhs)
+    for (auto &r : rhs)
+      if (l.intersects(r))
+        return true;
+  return false;
+}
+
+TEST(Membar, IntervalSetIntersects) {
+  IntervalSetT set;
+  set.insert(Interval<size_t>(0, 4));
+  set.insert(Interval<size_t>(4, 8));
+  set.insert(Interval<size_t>(16, 16));
+  EXPECT_TRUE(set.intersects(Interval<size_t>(3, 5)));
+  EXPECT_TRUE(set.intersects(Interval<size_t>(7, 12)));
+  EXPECT_FALSE(set.intersects(Interval<size_t>(8, 12)));
+  // Empty intervals only intersect intervals strictly around them
+  EXPECT_TRUE(set.intersects(Interval<size_t>(2, 2)));
+  EXPECT_FALSE(set.intersects(Interval<size_t>(4, 4)));
+  EXPECT_TRUE(set.intersects(Interval<size_t>(12, 20)));
+  EXPECT_FALSE(set.intersects(Interval<size_t>(16, 20)));
+  set.clear();
+  EXPECT_TRUE(set.empty());
+  EXPECT_FALSE(set.intersects(Interval<size_t>(0, 4)));
+}
+
+TEST(Membar, IntervalSetMatchesPairwiseCheck) {
+  std::mt19937 gen(0);
+  auto randomSet = [&](size_t maxSize, size_t range) {
+    IntervalSetT set;
+    size_t size = gen() % (maxSize + 1);
+    for (size_t i = 0; i < size; ++i) {
+      size_t start = gen() % range;
+      size_t length = gen() % 4 == 0 ? 0 : gen() % (range / 4 + 1);
+      set.insert(Interval<size_t>(start, start + length));
+    }
+    return set;
+  };
+  for (int i = 0; i < 10000; ++i) {
+    size_t range = 4 + gen() % 64;
+    IntervalSetT lhs = randomSet(8, range);
+    IntervalSetT rhs = randomSet(3, range);
+    EXPECT_EQ(lhs.intersects(rhs), intersectsSlow(lhs, rhs));
+    lhs.insert(rhs.begin(), rhs.end());
+    IntervalSetT other = randomSet(3, range);
+    EXPECT_EQ(lhs.intersects(other), intersectsSlow(lhs, other));
+  }
+}
+
+} // namespace
+} // namespace mlir
+
+int main(int argc, char *argv[]) {
+  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,163 @@
+#include "triton/Analysis/Utility.h"
+
+#include "mlir/IR/MLIRContext.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
+#include "llvm/Support/Signals.h"
+#include <gtest/gtest.h>
+
+namespace mlir {
+namespace {
+
+using namespace triton::gpu;
+
+class WarpShuffleTest : public ::testing::Test {
+public:
+  void SetUp() {
+    ctx.getOrLoadDialect<triton::TritonDialect>();
+    ctx.getOrLoadDialect<TritonGPUDialect>();
+  }
+
+  CTALayoutAttr cta(int rank) {
+    SmallVector<unsigned> ones(rank, 1);
+    SmallVector<unsigned> order;
+    for (int i = rank - 1; i >= 0; i--)
+      order.push_back(i);
+    return CTALayoutAttr::get(&ctx, ones, ones, order);
+  }
+
+  BlockedEncodingAttr blocked(ArrayRef<unsigned> spt, ArrayRef<unsigned> tpw,
+                              ArrayRef<unsigned> wpb, ArrayRef<unsigned> ord) {
+    return BlockedEncodingAttr::get(&ctx, spt, tpw, wpb, ord, cta(spt.size()));
+  }
+
+  NvidiaMmaEncodingAttr mmaV2(ArrayRef<unsigned> wpb) {
+    return NvidiaMmaEncodingAttr::get(&ctx, /*versionMajor=*/2,
+                                      /*versionMinor=*/0, wpb, cta(2),
+                                      /*instrShape=*/{16, 8});
+  }
+
+  SliceEncodingAttr slice(Attribute parent, int dim) {
+    return SliceEncodingAttr::get(&ctx, dim, parent);
+  }
+
+  RankedTensorType tensor(ArrayRef<int64_t> shape, Attribute enc) {
+    return RankedTensorType::get(shape, IntegerType::get(&ctx, 32), enc);
+  }
+
+  // Runs the shuffle schedule of the conversion from srcTy to dstTy the way
+  // transferWithinLane lowers it, and checks that every (lane, register) of
+  // dst ends up with the element the linear layouts assign to it.
+  void checkSchedule(RankedTensorType srcTy, RankedTensorType dstTy) {
+    std::optional<WarpShuffleSchedule> schedule =
+        getWarpShuffleSchedule(srcTy, dstTy);
+    ASSERT_TRUE(schedule.has_value());
+
+    StringAttr kRegister = S("register");
+    StringAttr kLane = S("lane");
+    StringAttr kWarp = S("warp");
+    StringAttr kBlock = S("block");
+    LinearLayout srcLayout =
+        *toLinearLayout(srcTy.getShape(), srcTy.getEncoding());
+    LinearLayout dstLayout =
+        *toLinearLayout(dstTy.getShape(), dstTy.getEncoding());
+    LinearLayout comp = dstLayout.invertAndCompose(srcLayout);
+    int numSrcRegisters = srcLayout.getInDimSize(kRegister);
+    ASSERT_EQ(schedule->numRegisters, dstLayout.getInDimSize(kRegister));
+    ASSERT_EQ(schedule->numLanes, dstLayout.getInDimSize(kLane));
+
+    auto applyBases = [](ArrayRef<int32_t> bases, int32_t x) {
+      int32_t ret = 0;
+      for (auto [i, basis] : llvm::enumerate(bases)) {
+        if (x & (1 << i))
+          ret ^= basis;
+      }
+      return ret;
+    };
+    auto element = [&](const LinearLayout &layout, int32_t reg, int32_t lane) {
+      return layout.apply(
+          {{kRegister, reg}, {kLane, lane}, {kWarp, 0}, {kBlock, 0}});
+    };
+
+    for (int lane = 0; lane < schedule->numLanes; lane++) {
+      for (int r = 0; r < schedule->numRegisters; r++) {
+        int32_t srcLane = applyBases(schedule->roundToSrcLane, r) ^
+                          applyBases(schedule->laneToSrcLane, lane);
+        ASSERT_LT(srcLane, schedule->numLanes);
+        int32_t srcReg = applyBases(schedule->roundToSrcRegister, r) ^
+                         applyBases(schedule->laneToSrcRegister, srcLane);
+        ASSERT_LT(srcReg, numSrcRegisters);
+        int32_t dstReg = r ^ applyBases(schedule->laneToDstRegister, lane);
+        ASSERT_LT(dstReg, schedule->numRegisters);
+
+        // src may hold an element in several places, so compare the elements
+        // rather than the (lane, register) pairs.
+        auto expected = comp.apply(
+            {{kRegister, dstReg}, {kLane, lane}, {kWarp, 0}, {kBlock, 0}});
+        auto get = [&](StringAttr dim) {
+          return llvm::find_if(expected, [&](auto &p) {
+                   return p.first == dim;
+                 })->second;
+        };
+        EXPECT_EQ(element(srcLayout, srcReg, srcLane),
+                  element(srcLayout, get(kRegister), get(kLane)))
+            << "lane " << lane << ", round " << r << ", dst register "
+            << dstReg;
+      }
+    }
+  }
+
+  StringAttr S(StringRef str) { return StringAttr::get(&ctx, str); }
+
+protected:
+  MLIRContext ctx;
+};
+
+TEST_F(WarpShuffleTest, BlockedToBlocked) {
+  auto src = blocked({1, 4}, {8, 4}, {1, 1}, {1, 0});
+  checkSchedule(tensor({16, 16}, src),
+                tensor({16, 16}, blocked({1, 4}, {16, 2}, {1, 1}, {1, 0})));
+  checkSchedule(tensor({16, 16}, src),
+                tensor({16, 16}, blocked({1, 4}, {4, 8}, {1, 1}, {1, 0})));
+}
+
+TEST_F(WarpShuffleTest, BlockedToBlocked1D) {
+  checkSchedule(tensor({32}, blocked({1}, {32}, {1}, {0})),
+                tensor({32}, blocked({4}, {32}, {1}, {0})));
+  checkSchedule(tensor({128}, blocked({4}, {32}, {1}, {0})),
+                tensor({128}, blocked({1}, {32}, {1}, {0})));
+}
+
+TEST_F(WarpShuffleTest, Slice) {
+  auto src = blocked({1}, {32}, {1}, {0});
+  auto parent = blocked({1, 4}, {4, 8}, {1, 1}, {1, 0});
+  checkSchedule(tensor({32}, src), tensor({32}, slice(parent, 0)));
+  checkSchedule(tensor({32}, src), tensor({32}, slice(parent, 1)));
+}
+
+TEST_F(WarpShuffleTest, MmaAccumulatorToBlocked) {
+  auto mma = mmaV2({1, 1});
+  auto dst = blocked({1, 4}, {16, 2}, {1, 1}, {1, 0});
+  checkSchedule(tensor({16, 8}, mma), tensor({16, 8}, dst));
+  checkSchedule(tensor({16, 8}, dst), tensor({16, 8}, mma));
+}
+
+TEST_F(WarpShuffleTest, RejectsCrossWarp) {
+  // Each warp of src holds columns of the tensor and each warp of dst holds
+  // rows, so the data has to go through shared memory.
+  auto src = blocked({1, 1}, {32, 1}, {1, 4}, {0, 1});
+  auto dst = blocked({1, 1}, {1, 32}, {4, 1}, {1, 0});
+  EXPECT_FALSE(
+      getWarpShuffleSchedule(tensor({32, 32}, src), tensor({32, 32}, dst))
+          .has_value());
+}
+
+} // namespace
+} // namespace mlir
+
+int main(int argc, char *argv[]) {
+  llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,137 @@
+#include "nvidia/include/Dialect/NVGPU/IR/Dialect.h"
+#include "nvidia/lib/TritonNVIDIAGPUToLLVM/TargetInfo.h"
+#include "triton/Conversion/TritonGPUToLLVM/Utility.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Attributes.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include <benchmark/benchmark.h>
+
+namespace mlir::triton::gpu {
+namespace {
+
+enum class Encoding {
+  Blocked,
+  Slice,
+  MmaV2,
+  MmaV3,
+  Mfma,
+  Wmma,
+};
+
+MLIRContext *getContext() {
+  static MLIRContext *context = [] {
+    MLIRContext *context = new MLIRContext(MLIRContext::Threading::DISABLED);
+    context->getOrLoadDialect<TritonGPUDialect>();
+    context->getOrLoadDialect<mlir::LLVM::LLVMDialect>();
+    context->getOrLoadDialect<mlir::gpu::GPUDialect>();
+    context->getOrLoadDialect<mlir::triton::nvgpu::NVGPUDialect>();
+    return context;
+  }();
+  return context;
+}
+
+// Returns the type of a f16 tensor of the given size with a layout of the
+// given kind, as used for 2D tensors with 4 warps.
+RankedTensorType getType(Encoding kind, int64_t size) {
+  MLIRContext *ctx = getContext();
+  SmallVector<unsigned> ones = {1, 1};
+  SmallVector<unsigned> order = {1, 0};
+  SmallVector<unsigned> warps = {2, 2};
+  SmallVector<unsigned> sizePerThread = {1, 8};
+  SmallVector<unsigned> threadsPerWarp = {4, 8};
+  SmallVector<unsigned> warpsPerCTA = {4, 1};
+  auto cta = CTALayoutAttr::get(ctx, ones, ones, order);
+  auto blocked = BlockedEncodingAttr::get(ctx, sizePerThread, threadsPerWarp,
+                                          warpsPerCTA, order, cta);
+  Attribute layout;
+  switch (kind) {
+  case Encoding::Blocked:
+    layout = blocked;
+    break;
+  case Encoding::Slice:
+    layout = SliceEncodingAttr::get(ctx, 0, blocked);
+    break;
+  case Encoding::MmaV2:
+    layout = NvidiaMmaEncodingAttr::get(ctx, 2, 0, warps, cta,
+                                        SmallVector<unsigned>{16, 8});
+    break;
+  case Encoding::MmaV3:
+    layout = NvidiaMmaEncodingAttr::get(ctx, 3, 0, warpsPerCTA, cta,
+                                        SmallVector<unsigned>{16, 64, 16});
+    break;
+  case Encoding::Mfma:
+    layout = AMDMfmaEncodingAttr::get(ctx, 2, 0, warps, 32, 32,
+                                      /*isTransposed=*/false, cta);
+    break;
+  case Encoding::Wmma:
+    layout = AMDWmmaEncodingAttr::get(ctx, warps, cta);
+    break;
+  }
+  SmallVector<int64_t> shape = {size, size};
+  if (kind == Encoding::Slice)
+    shape.pop_back();
+  return RankedTensorType::get(shape, Float16Type::get(ctx), layout);
+}
+
+void sizeArgs(benchmark::internal::Benchmark *bench) {
+  bench->ArgName("size")->RangeMultiplier(2)->Range(64, 256);
+}
+
+void BM_EmitOffsetForLayout(benchmark::State &state, Encoding kind,
+                            bool allowLL) {
+  RankedTensorType type = getType(kind, state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        emitOffsetForLayout(type.getEncoding(), type, allowLL));
+}
+
+// Emits the indices into an empty function, which is cleared after each
+// iteration.
+void BM_EmitIndices(benchmark::State &state, Encoding kind, bool allowLL) {
+  MLIRContext *ctx = getContext();
+  RankedTensorType type = getType(kind, state.range(0));
+  NVIDIA::TargetInfo targetInfo(90);
+  Location loc = UnknownLoc::get(ctx);
+  OwningOpRef<ModuleOp> module = ModuleOp::create(loc);
+  IRRewriter rewriter(ctx);
+  rewriter.setInsertionPointToStart(module->getBody());
+  auto funcOp = rewriter.create<triton::FuncOp>(
+      loc, "bench_func", rewriter.getFunctionType({}, {}));
+  Block *block = funcOp.addEntryBlock();
+  for (auto _ : state) {
+    rewriter.setInsertionPointToStart(block);
+    benchmark::DoNotOptimize(emitIndices(loc, rewriter, targetInfo,
+                                         type.getEncoding(), type,
+                                         /*withCTAOffset=*/false, allowLL));
+    state.PauseTiming();
+    block->clear();
+    state.ResumeTiming();
+  }
+}
+
+// The linear layout path of both functions, and the legacy path that it
+// replaces.
+#define BENCHMARK_ENCODING(func, name)                                         \
+  BENCHMARK_CAPTURE(func, name##_LL, Encoding::name, true)->Apply(sizeArgs);   \
+  BENCHMARK_CAPTURE(func, name##_Legacy, Encoding::name, false)                \
+      ->Apply(sizeArgs)
+
+BENCHMARK_ENCODING(BM_EmitOffsetForLayout, Blocked);
+BENCHMARK_ENCODING(BM_EmitOffsetForLayout, Slice);
+BENCHMARK_ENCODING(BM_EmitOffsetForLayout, MmaV2);
+BENCHMARK_ENCODING(BM_EmitOffsetForLayout, MmaV3);
+BENCHMARK_ENCODING(BM_EmitOffsetForLayout, Mfma);
+BENCHMARK_ENCODING(BM_EmitOffsetForLayout, Wmma);
+
+// The base indices of the legacy path depend on the target, only the layouts
+// of the NVIDIA target are measured.
+BENCHMARK_ENCODING(BM_EmitIndices, Blocked);
+BENCHMARK_ENCODING(BM_EmitIndices, Slice);
+BENCHMARK_ENCODING(BM_EmitIndices, MmaV2);
+BENCHMARK_ENCODING(BM_EmitIndices, MmaV3);
+
+} // anonymous namespace
+} // namespace mlir::triton::gpu
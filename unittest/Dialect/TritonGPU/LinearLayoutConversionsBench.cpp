@@ -0,0 +1,137 @@
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
+
+#include "mlir/IR/MLIRContext.h"
+#include "triton/Dialect/TritonGPU/IR/Attributes.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include <benchmark/benchmark.h>
+
+namespace mlir::triton::gpu {
+namespace {
+
+enum class Encoding {
+  Blocked,
+  Slice,
+  MmaV2,
+  MmaV3,
+  Mfma,
+  Wmma,
+  Shared,
+  SharedLeadingOffset,
+};
+
+std::unique_ptr<MLIRContext> createContext() {
+  auto ctx = std::make_unique<MLIRContext>(MLIRContext::Threading::DISABLED);
+  ctx->getOrLoadDialect<TritonGPUDialect>();
+  return ctx;
+}
+
+// Returns a layout of the given kind, as used for 2D tensors with 4 warps.
+Attribute getEncoding(MLIRContext *ctx, Encoding kind) {
+  SmallVector<unsigned> ones = {1, 1};
+  SmallVector<unsigned> order = {1, 0};
+  SmallVector<unsigned> warps = {2, 2};
+  auto cta = CTALayoutAttr::get(ctx, ones, ones, order);
+  SmallVector<unsigned> sizePerThread = {1, 8};
+  SmallVector<unsigned> threadsPerWarp = {4, 8};
+  SmallVector<unsigned> warpsPerCTA = {4, 1};
+  auto blocked = BlockedEncodingAttr::get(ctx, sizePerThread, threadsPerWarp,
+                                          warpsPerCTA, order, cta);
+  switch (kind) {
+  case Encoding::Blocked:
+    return blocked;
+  case Encoding::Slice:
+    // Sliced layouts are 1D, see getShape().
+    return SliceEncodingAttr::get(ctx, 0, blocked);
+  case Encoding::MmaV2:
+    return NvidiaMmaEncodingAttr::get(ctx, 2, 0, warps, cta,
+                                      SmallVector<unsigned>{16, 8});
+  case Encoding::MmaV3:
+    return NvidiaMmaEncodingAttr::get(ctx, 3, 0, warpsPerCTA, cta,
+                                      SmallVector<unsigned>{16, 64, 16});
+  case Encoding::Mfma:
+    return AMDMfmaEncodingAttr::get(ctx, 2, 0, warps, 32, 32,
+                                    /*isTransposed=*/false, cta);
+  case Encoding::Wmma:
+    return AMDWmmaEncodingAttr::get(ctx, warps, cta);
+  case Encoding::Shared:
+    return SharedEncodingAttr::get(ctx, 8, 1, 8, order, cta,
+                                   /*hasLeadingOffset=*/false);
+  case Encoding::SharedLeadingOffset:
+    return SharedEncodingAttr::get(ctx, 8, 1, 8, order, cta,
+                                   /*hasLeadingOffset=*/true);
+  }
+  llvm_unreachable("unknown encoding");
+}
+
+SmallVector<int64_t> getShape(Encoding kind, int64_t size) {
+  if (kind == Encoding::Slice)
+    return {size};
+  return {size, size};
+}
+
+void sizeArgs(benchmark::internal::Benchmark *bench) {
+  bench->ArgName("size")->RangeMultiplier(2)->Range(64, 256);
+}
+
+// Converts a layout that has already been converted once, which is what most
+// queries of a compilation are.
+void BM_ToLinearLayout(benchmark::State &state, Encoding kind) {
+  auto ctx = createContext();
+  Attribute layout = getEncoding(ctx.get(), kind);
+  SmallVector<int64_t> shape = getShape(kind, state.range(0));
+  for (auto _ : state)
+    benchmark::DoNotOptimize(toLinearLayout(shape, layout, 16));
+}
+
+// Converts a layout for the first time in a context.
+void BM_ToLinearLayoutUncached(benchmark::State &state, Encoding kind) {
+  SmallVector<int64_t> shape = getShape(kind, state.range(0));
+  std::unique_ptr<MLIRContext> ctx;
+  for (auto _ : state) {
+    state.PauseTiming();
+    ctx = createContext();
+    Attribute layout = getEncoding(ctx.get(), kind);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(toLinearLayout(shape, layout, 16));
+  }
+}
+
+#define BENCHMARK_ENCODING(func, name)                                         \
+  BENCHMARK_CAPTURE(func, name, Encoding::name)->Apply(sizeArgs)
+
+#define BENCHMARK_ALL_ENCODINGS(func)                                          \
+  BENCHMARK_ENCODING(func, Blocked);                                           \
+  BENCHMARK_ENCODING(func, Slice);                                             \
+  BENCHMARK_ENCODING(func, MmaV2);                                             \
+  BENCHMARK_ENCODING(func, MmaV3);                                             \
+  BENCHMARK_ENCODING(func, Mfma);                                              \
+  BENCHMARK_ENCODING(func, Wmma);                                              \
+  BENCHMARK_ENCODING(func, Shared);                                            \
+  BENCHMARK_ENCODING(func, SharedLeadingOffset)
+
+BENCHMARK_ALL_ENCODINGS(BM_ToLinearLayout);
+BENCHMARK_ALL_ENCODINGS(BM_ToLinearLayoutUncached);
+
+// The register to register mapping of a convert_layout to an MMA layout.
+void BM_ToLinearLayoutConversion(benchmark::State &state, bool cached) {
+  SmallVector<int64_t> shape(2, state.range(0));
+  auto ctx = createContext();
+  Attribute src = getEncoding(ctx.get(), Encoding::Blocked);
+  Attribute dst = getEncoding(ctx.get(), Encoding::MmaV2);
+  for (auto _ : state) {
+    if (!cached) {
+      state.PauseTiming();
+      ctx = createContext();
+      src = getEncoding(ctx.get(), Encoding::Blocked);
+      dst = getEncoding(ctx.get(), Encoding::MmaV2);
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(toLinearLayoutConversion(shape, src, dst));
+  }
+}
+BENCHMARK_CAPTURE(BM_ToLinearLayoutConversion, Cached, true)->Apply(sizeArgs);
+BENCHMARK_CAPTURE(BM_ToLinearLayoutConversion, Uncached, false)
+    ->Apply(sizeArgs);
+
+} // anonymous namespace
+} // namespace mlir::triton::gpu
@@ -993,6 +993,21 @@ TEST_F(LinearLayoutConversionsTest, Shared1DSwizzle) {
                 LinearLayout::identity1D(1, S("block"), S("dim0")));
 }
 
+TEST_F(LinearLayoutConversionsTest, CachedConversion) {
+  auto src = blocked({1, 4}, {4, 8}, {4, 1}, {1, 1}, {1, 1}, {1, 0}, {1, 0});
+  auto dst = blocked({4, 1}, {8, 4}, {1, 4}, {1, 1}, {1, 1}, {0, 1}, {1, 0});
+  std::optional<LinearLayout> srcLayout = toLinearLayout({32, 32}, src);
+  std::optional<LinearLayout> dstLayout = toLinearLayout({32, 32}, dst);
+  ASSERT_TRUE(srcLayout && dstLayout);
+  // Repeated queries return the cached layouts.
+  EXPECT_EQ(toLinearLayout({32, 32}, src), srcLayout);
+  EXPECT_NE(toLinearLayout({64, 32}, src), srcLayout);
+  EXPECT_EQ(toLinearLayoutConversion({32, 32}, src, dst),
+            srcLayout->invertAndCompose(*dstLayout));
+  EXPECT_EQ(toLinearLayoutConversion({32, 32}, src, dst),
+            srcLayout->invertAndCompose(*dstLayout));
+}
+
 } // anonymous namespace
 } // namespace mlir::triton::gpu
 
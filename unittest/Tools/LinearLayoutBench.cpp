@@ -0,0 +1,139 @@
+#include "triton/Tools/LinearLayout.h"
+
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Support/LLVM.h"
+#include "llvm/Support/MathExtras.h"
+#include <benchmark/benchmark.h>
+
+namespace mlir::triton {
+namespace {
+
+// The benchmarks take the tensor shape as arguments {rows, cols}.
+constexpr int64_t kMinDim = 64;
+constexpr int64_t kMaxDim = 256;
+
+class LinearLayoutBench {
+public:
+  StringAttr S(StringRef str) { return StringAttr::get(&ctx, str); }
+
+  // A 2D blocked layout with an order of [1, 0] and 4 warps, where the
+  // registers repeat to cover the (power of 2) shape.
+  LinearLayout blocked(ArrayRef<int32_t> spt, ArrayRef<int32_t> tpw,
+                       ArrayRef<int32_t> wpb, int32_t rows, int32_t cols) {
+    StringAttr dim0 = S("dim0");
+    StringAttr dim1 = S("dim1");
+    LinearLayout layout =
+        LinearLayout::identity1D(spt[1], S("register"), dim1) *
+        LinearLayout::identity1D(spt[0], S("register"), dim0) *
+        LinearLayout::identity1D(tpw[1], S("lane"), dim1) *
+        LinearLayout::identity1D(tpw[0], S("lane"), dim0) *
+        LinearLayout::identity1D(wpb[1], S("warp"), dim1) *
+        LinearLayout::identity1D(wpb[0], S("warp"), dim0);
+    int32_t tileCols = spt[1] * tpw[1] * wpb[1];
+    int32_t tileRows = spt[0] * tpw[0] * wpb[0];
+    layout *= LinearLayout::identity1D(std::max(cols / tileCols, 1),
+                                       S("register"), dim1) *
+              LinearLayout::identity1D(std::max(rows / tileRows, 1),
+                                       S("register"), dim0);
+    return layout;
+  }
+
+  // Maps (dim1, dim0) to the offset of an element in a row-major buffer whose
+  // 8-element vectors are XOR-swizzled by the row index, as done for the
+  // shared memory of dot operands.
+  LinearLayout swizzledOffsets(int32_t rows, int32_t cols) {
+    const int32_t vec = 8;
+    int32_t maxPhase = std::min(cols / vec, 8);
+    LinearLayout::BasesT bases;
+    auto &colBases = bases[S("dim1")];
+    for (int32_t col = 1; col < cols; col *= 2)
+      colBases.push_back({col});
+    auto &rowBases = bases[S("dim0")];
+    for (int32_t row = 1; row < rows; row *= 2)
+      rowBases.push_back({row * cols ^ ((row % maxPhase) * vec)});
+    return LinearLayout(std::move(bases), {{S("offset"), rows * cols}},
+                        /*requireSurjective=*/true);
+  }
+
+private:
+  MLIRContext ctx;
+};
+
+void shapeArgs(benchmark::internal::Benchmark *bench) {
+  bench->ArgNames({"rows", "cols"});
+  for (int64_t rows = kMinDim; rows <= kMaxDim; rows *= 2)
+    bench->Args({rows, rows});
+  bench->Args({kMinDim, kMaxDim});
+  bench->Args({kMaxDim, kMinDim});
+}
+
+void BM_Multiply(benchmark::State &state) {
+  LinearLayoutBench b;
+  int32_t rows = state.range(0);
+  int32_t cols = state.range(1);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(b.blocked({1, 8}, {4, 8}, {4, 1}, rows, cols));
+}
+BENCHMARK(BM_Multiply)->Apply(shapeArgs);
+
+void BM_Apply(benchmark::State &state) {
+  LinearLayoutBench b;
+  LinearLayout layout =
+      b.blocked({1, 8}, {4, 8}, {4, 1}, state.range(0), state.range(1));
+  int32_t numRegs = layout.getInDimSize(b.S("register"));
+  SmallVector<std::pair<StringAttr, int32_t>> ins = {
+      {b.S("register"), 0}, {b.S("lane"), 0}, {b.S("warp"), 0}};
+  for (auto _ : state) {
+    for (int32_t reg = 0; reg < numRegs; reg++) {
+      ins[0].second = reg;
+      benchmark::DoNotOptimize(layout.apply(ins));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * numRegs);
+}
+BENCHMARK(BM_Apply)->Apply(shapeArgs);
+
+// Registers to shared memory offsets, as when storing to shared memory.
+void BM_Compose(benchmark::State &state) {
+  LinearLayoutBench b;
+  int32_t rows = state.range(0);
+  int32_t cols = state.range(1);
+  LinearLayout layout = b.blocked({1, 8}, {4, 8}, {4, 1}, rows, cols);
+  LinearLayout offsets = b.swizzledOffsets(rows, cols);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(layout.compose(offsets));
+}
+BENCHMARK(BM_Compose)->Apply(shapeArgs);
+
+// The register to register mapping of a layout conversion.
+void BM_InvertAndCompose(benchmark::State &state) {
+  LinearLayoutBench b;
+  int32_t rows = state.range(0);
+  int32_t cols = state.range(1);
+  LinearLayout src = b.blocked({1, 8}, {4, 8}, {4, 1}, rows, cols);
+  LinearLayout dst = b.blocked({4, 1}, {8, 4}, {1, 4}, rows, cols);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(dst.invertAndCompose(src));
+}
+BENCHMARK(BM_InvertAndCompose)->Apply(shapeArgs);
+
+// Recovering the layout of a register tile, as when vectorizing accesses.
+void BM_DivideRight(benchmark::State &state) {
+  LinearLayoutBench b;
+  int32_t rows = state.range(0);
+  int32_t cols = state.range(1);
+  LinearLayout tile = b.blocked({1, 8}, {4, 8}, {4, 1}, 16, 64);
+  LinearLayout layout = b.blocked({1, 8}, {4, 8}, {4, 1}, rows, cols);
+  LinearLayout divisor =
+      LinearLayout::identity1D(std::max(cols / 64, 1), b.S("register"),
+                               b.S("dim1")) *
+      LinearLayout::identity1D(std::max(rows / 16, 1), b.S("register"),
+                               b.S("dim0"));
+  assert(layout == tile * divisor);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(layout.divideRight(divisor));
+}
+BENCHMARK(BM_DivideRight)->Apply(shapeArgs);
+
+} // anonymous namespace
+} // namespace mlir::triton
@@ -204,6 +204,26 @@ TEST_F(LinearLayoutTest, Apply) {
               ElementsAre(Pair(S("out1"), 1), Pair(S("out2"), 2)));
 }
 
+TEST_F(LinearLayoutTest, ApplyWideOutput) {
+  LinearLayout layout =
+      LinearLayout::identity1D(1 << 24, S("in1"), S("out1")) *
+      LinearLayout::identity1D(1 << 24, S("in2"), S("out2"));
+  EXPECT_THAT(layout.apply({{S("in1"), 5 << 20}, {S("in2"), (1 << 23) | 3}}),
+              ElementsAre(Pair(S("out1"), 5 << 20),
+                          Pair(S("out2"), (1 << 23) | 3)));
+}
+
+TEST_F(LinearLayoutTest, Columns) {
+  LinearLayout layout(
+      {
+          {S("in1"), {{1, 0}, {0, 2}}},
+          {S("in2"), {{1, 1}}},
+      },
+      {{S("out1"), 2}, {S("out2"), 4}}, /*requireSurjective=*/false);
+  EXPECT_THAT(layout.getColumns(), ElementsAre(0b001, 0b100, 0b011));
+  EXPECT_THAT(LinearLayout::empty().getColumns(), IsEmpty());
+}
+
 // This is really more of a benchmark than a test.  We're checking that it
 // doesn't take so long to run that a human notices and says "hmm".  :)
 TEST_F(LinearLayoutTest, ConstructLargeLayout) {
@@ -530,6 +550,43 @@ TEST_F(LinearLayoutTest, InvertAndCompose_BroadcastedDims2) {
   EXPECT_EQ(c.compose(b), a.transposeOuts(llvm::to_vector(b.getOutDimNames())));
 }
 
+TEST_F(LinearLayoutTest, InvertAndCompose_Large) {
+  // The combined matrix has 50 + 30 columns, more than fit in a 64-bit word.
+  std::vector<std::vector<int32_t>> reversed;
+  for (int i = 19; i >= 0; i--) {
+    reversed.push_back({1 << i});
+  }
+  LinearLayout a = LinearLayout::identity1D(1 << 20, S("in1"), S("out")) *
+                   LinearLayout::zeros1D(1 << 30, S("in2"), S("out"));
+  LinearLayout b = LinearLayout({{S("in3"), reversed}}, {S("out")}) *
+                   LinearLayout::zeros1D(1 << 10, S("in4"), S("out"));
+  LinearLayout c = a.invertAndCompose(b);
+  EXPECT_THAT(c.apply({{S("in1"), 1}, {S("in2"), 0}}),
+              ElementsAre(Pair(S("in3"), 1 << 19), Pair(S("in4"), 0)));
+  EXPECT_THAT(c.apply({{S("in1"), 0}, {S("in2"), 1 << 3}}),
+              ElementsAre(Pair(S("in3"), 0), Pair(S("in4"), 1 << 3)));
+  EXPECT_EQ(c.compose(b), a);
+}
+
+TEST_F(LinearLayoutTest, InvertAndCompose_ManyRows) {
+  // The in-dims of `b` have 20 + 15 bits, so the combined matrix has 35 rows,
+  // more than the bits of an int32 basis.
+  std::vector<std::vector<int32_t>> reversed;
+  for (int i = 19; i >= 0; i--) {
+    reversed.push_back({1 << i});
+  }
+  LinearLayout a = LinearLayout::identity1D(1 << 20, S("in1"), S("out")) *
+                   LinearLayout::zeros1D(1 << 15, S("in2"), S("out"));
+  LinearLayout b = LinearLayout({{S("in3"), reversed}}, {S("out")}) *
+                   LinearLayout::zeros1D(1 << 15, S("in4"), S("out"));
+  LinearLayout c = a.invertAndCompose(b);
+  EXPECT_THAT(c.apply({{S("in1"), 1}, {S("in2"), 0}}),
+              ElementsAre(Pair(S("in3"), 1 << 19), Pair(S("in4"), 0)));
+  EXPECT_THAT(c.apply({{S("in1"), 0}, {S("in2"), 1 << 14}}),
+              ElementsAre(Pair(S("in3"), 0), Pair(S("in4"), 1 << 14)));
+  EXPECT_EQ(c.compose(b), a);
+}
+
 TEST_F(LinearLayoutTest, NumConsecutiveInOut) {
   EXPECT_EQ(
       1,
@@ -0,0 +1,100 @@
+"""
+Measures the compile time of the membar analysis on large synthetic inputs.
+
+The generated functions are in the style of test/Analysis/test-membar.mlir:
+many shared memory buffers are written, then all of them are read, so the
+analysis tracks many intervals at once without inserting barriers in between.
+The loop variant does the same in the body of an scf.for, which also exercises
+the fixed point iteration over the loop's blocks.
+
+Usage:
+    python utils/bench_membar.py --triton-opt build/bin/triton-opt
+"""
+
+import argparse
+import os
+import subprocess
+import tempfile
+import time
+
+HEADER = """\
+#AL = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+#A_SHARED = #triton_gpu.shared<{vec = 2, perPhase = 2, maxPhase = 4, order = [1, 0]}>
+
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32} {
+"""
+
+TENSOR = "tensor<16x16xf16, #AL>"
+MEMDESC = "!tt.memdesc<16x16xf16, #A_SHARED, #triton_gpu.shared_memory>"
+
+
+def gen_body(num_buffers, indent):
+    lines = []
+    for i in range(num_buffers):
+        lines.append(f"%buf{i} = triton_gpu.local_alloc %init : ({TENSOR}) -> {MEMDESC}")
+    lines.append(f"%acc0 = arith.constant dense<0.000000e+00> : {TENSOR}")
+    for i in range(num_buffers):
+        lines.append(f"%val{i} = triton_gpu.local_load %buf{i} : {MEMDESC} -> {TENSOR}")
+        lines.append(f"%acc{i + 1} = arith.addf %acc{i}, %val{i} : {TENSOR}")
+    return [indent + line for line in lines], f"%acc{num_buffers}"
+
+
+def gen_module(num_buffers, loop):
+    lines = [HEADER]
+    lines.append("tt.func @membar_bench(%lb : index, %ub : index, %step : index, %out : !tt.ptr<f16>) {")
+    lines.append(f"  %init = arith.constant dense<1.000000e+00> : {TENSOR}")
+    lines.append("  %ptr = tt.splat %out : !tt.ptr<f16> -> tensor<16x16x!tt.ptr<f16>, #AL>")
+    if loop:
+        lines.append(f"  %res = scf.for %iv = %lb to %ub step %step iter_args(%prev = %init) -> ({TENSOR}) {{")
+        body, acc = gen_body(num_buffers, "    ")
+        lines += body
+        lines.append(f"    %next = arith.addf %prev, {acc} : {TENSOR}")
+        lines.append(f"    scf.yield %next : {TENSOR}")
+        lines.append("  }")
+        acc = "%res"
+    else:
+        body, acc = gen_body(num_buffers, "  ")
+        lines += body
+    lines.append(f"  tt.store %ptr, {acc} : tensor<16x16x!tt.ptr<f16>, #AL>")
+    lines.append("  tt.return")
+    lines.append("}")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def run(triton_opt, path, repeats):
+    cmd = [
+        triton_opt, path, "--mlir-disable-threading", "--convert-scf-to-cf", "--allocate-shared-memory",
+        "-test-print-membar", "-o", os.devnull
+    ]
+    best = float("inf")
+    for _ in range(repeats):
+        start = time.perf_counter()
+        subprocess.run(cmd, check=True)
+        best = min(best, time.perf_counter() - start)
+    return best
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--triton-opt", default="triton-opt", help="path to the triton-opt binary")
+    parser.add_argument("--num-buffers", type=int, nargs="+", default=[128, 512, 2048],
+                        help="numbers of shared memory buffers to generate")
+    parser.add_argument("--repeats", type=int, default=3, help="runs per input, the fastest is reported")
+    parser.add_argument("--dump", help="directory to keep the generated inputs in")
+    args = parser.parse_args()
+
+    out_dir = args.dump or tempfile.mkdtemp()
+    os.makedirs(out_dir, exist_ok=True)
+    print(f"{'buffers':>8} {'variant':>8} {'time (s)':>10}")
+    for num_buffers in args.num_buffers:
+        for loop in [False, True]:
+            variant = "loop" if loop else "straight"
+            path = os.path.join(out_dir, f"membar-{variant}-{num_buffers}.mlir")
+            with open(path, "w") as f:
+                f.write(gen_module(num_buffers, loop))
+            print(f"{num_buffers:>8} {variant:>8} {run(args.triton_opt, path, args.repeats):>10.3f}")
+
+
+if __name__ == "__main__":
+    main()